@@ -85,6 +85,7 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
     pkg->AddField("divB", m);
 
+    pkg->FillDerivedMesh = B_CD::FillDerivedMesh;
     pkg->FillDerivedBlock = B_CD::FillDerived;
     pkg->PostStepDiagnosticsMesh = B_CD::PostStepDiagnostics;
 
@@ -98,6 +99,32 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     return pkg;
 }
 
+void UtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    Flag(md, "B field UtoP Mesh");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    const auto& B_U = md->PackVariables(std::vector<std::string>{"cons.B"});
+    const auto& B_P = md->PackVariables(std::vector<std::string>{"prims.B"});
+    const auto& psi_U = md->PackVariables(std::vector<std::string>{"cons.psi_cd"});
+    const auto& psi_P = md->PackVariables(std::vector<std::string>{"prims.psi_cd"});
+
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    IndexRange ib = bounds.GetBoundsI(domain);
+    IndexRange jb = bounds.GetBoundsJ(domain);
+    IndexRange kb = bounds.GetBoundsK(domain);
+    IndexRange block = IndexRange{0, B_U.GetDim(5) - 1};
+    pmb0->par_for("UtoP_B", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            const auto& G = B_U.GetCoords(b);
+            Real gdet = G.gdet(Loci::center, j, i);
+            VLOOP B_P(b, v, k, j, i) = B_U(b, v, k, j, i) / gdet;
+            psi_P(b, 0, k, j, i) = psi_U(b, 0, k, j, i) / gdet;
+        }
+    );
+    Flag(md, "End B field UtoP");
+}
+
 void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
 {
     Flag(rc, "B field UtoP");
@@ -153,35 +180,10 @@ TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt)
     pmb0->par_for("AddSource_B_CD", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_MESH_3D {
             const auto& G = B_U.GetCoords(b);
-            // Add a source term to B based on psi
-            GReal alpha_c = 1. / sqrt(-G.gcon(Loci::center, j, i, 0, 0));
-            GReal gdet_c = G.gdet(Loci::center, j, i);
-
-            double divB = ((B_U(b).flux(X1DIR, V1, k, j, i+1) - B_U(b).flux(X1DIR, V1, k, j, i)) / G.dx1v(i) +
-                           (B_U(b).flux(X2DIR, V2, k, j+1, i) - B_U(b).flux(X2DIR, V2, k, j, i)) / G.dx2v(j));
-            if (ndim > 2) divB += (B_U(b).flux(X3DIR, V3, k+1, j, i) - B_U(b).flux(X3DIR, V3, k, j, i)) / G.dx3v(k);
-            // TODO this needs to include the time derivative right?
-
-            VLOOP {
-                // First term: gradient of psi
-                B_DU(b, v, k, j, i) += alpha_c * G.gcon(Loci::center, j, i, v+1, 1) *
-                                       (psi_U(b).flux(X1DIR, 0, k, j, i+1) - psi_U(b).flux(X1DIR, 0, k, j, i)) / G.dx1v(i) +
-                                       alpha_c * G.gcon(Loci::center, j, i, v+1, 2) *
-                                       (psi_U(b).flux(X2DIR, 0, k, j+1, i) - psi_U(b).flux(X2DIR, 0, k, j, i)) / G.dx2v(j);
-                if (ndim > 2)
-                    B_DU(b, v, k, j, i) += alpha_c * G.gcon(Loci::center, j, i, v+1, 3) *
-                                        (psi_U(b).flux(X3DIR, 0, k+1, j, i) - psi_U(b).flux(X3DIR, 0, k, j, i)) / G.dx3v(k);
-
-                // Second term: beta^i divB
-                B_DU(b, v, k, j, i) += G.gcon(Loci::center, j, i, 0, v+1) * alpha_c * alpha_c * divB;
-            }
-            // Update psi using the analytic solution for the source term
-            GReal dalpha1 = ( (1. / sqrt(-G.gcon(Loci::face1, j, i+1, 0, 0))) / G.gdet(Loci::face1, j, i+1)
-                            - (1. / sqrt(-G.gcon(Loci::face1, j, i, 0, 0))) / G.gdet(Loci::face1, j, i)) / G.dx1v(i);
-            GReal dalpha2 = ( (1. / sqrt(-G.gcon(Loci::face2, j+1, i, 0, 0))) / G.gdet(Loci::face2, j+1, i)
-                            - (1. / sqrt(-G.gcon(Loci::face2, j, i, 0, 0))) / G.gdet(Loci::face2, j, i)) / G.dx2v(i);
-            // There is not dalpha3, the coordinate system is symmetric along x3
-            psi_DU(b, 0, k, j, i) += B_U(b, V1, k, j, i) * dalpha1 + B_U(b, V2, k, j, i) * dalpha2 - alpha_c * lambda * psi_U(b, 0, k, j, i);
+            Real dB[NVEC], dpsi;
+            B_CD::calc_source(G, B_U(b), 0, psi_U(b), 0, lambda, ndim, k, j, i, dB, dpsi);
+            VLOOP B_DU(b, v, k, j, i) += dB[v];
+            psi_DU(b, 0, k, j, i) += dpsi;
         }
     );
 
@@ -63,6 +63,8 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
  * input: Conserved B = sqrt(-gdet) * B^i
  * output: Primitive B = B^i
  */
+void UtoP(MeshData<Real> *md, IndexDomain domain=IndexDomain::entire, bool coarse=false);
+inline void FillDerivedMesh(MeshData<Real> *md) { UtoP(md); }
 void UtoP(MeshBlockData<Real> *rc, IndexDomain domain=IndexDomain::entire, bool coarse=false);
 inline void FillDerived(MeshBlockData<Real> *rc) { UtoP(rc); }
 
@@ -71,6 +73,46 @@ inline void FillDerived(MeshBlockData<Real> *rc) { UtoP(rc); }
  */
 TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 
+/**
+ * Calculate the constraint-damping source terms in a single zone, for B (dB) and psi (dpsi).
+ * B_U and psi_U are packs (with fluxes) of a single block, containing B at index iB and psi at ipsi
+ */
+template<typename Global>
+KOKKOS_INLINE_FUNCTION void calc_source(const GRCoordinates& G, const Global& B_U, const int& iB,
+                                        const Global& psi_U, const int& ipsi, const Real& lambda, const int& ndim,
+                                        const int& k, const int& j, const int& i, Real dB[NVEC], Real& dpsi)
+{
+    // Add a source term to B based on psi
+    GReal alpha_c = 1. / sqrt(-G.gcon(Loci::center, j, i, 0, 0));
+    GReal gdet_c = G.gdet(Loci::center, j, i);
+
+    double divB = ((B_U.flux(X1DIR, iB + V1, k, j, i+1) - B_U.flux(X1DIR, iB + V1, k, j, i)) / G.dx1v(i) +
+                   (B_U.flux(X2DIR, iB + V2, k, j+1, i) - B_U.flux(X2DIR, iB + V2, k, j, i)) / G.dx2v(j));
+    if (ndim > 2) divB += (B_U.flux(X3DIR, iB + V3, k+1, j, i) - B_U.flux(X3DIR, iB + V3, k, j, i)) / G.dx3v(k);
+    // TODO this needs to include the time derivative right?
+
+    VLOOP {
+        // First term: gradient of psi
+        dB[v] = alpha_c * G.gcon(Loci::center, j, i, v+1, 1) *
+                (psi_U.flux(X1DIR, ipsi, k, j, i+1) - psi_U.flux(X1DIR, ipsi, k, j, i)) / G.dx1v(i) +
+                alpha_c * G.gcon(Loci::center, j, i, v+1, 2) *
+                (psi_U.flux(X2DIR, ipsi, k, j+1, i) - psi_U.flux(X2DIR, ipsi, k, j, i)) / G.dx2v(j);
+        if (ndim > 2)
+            dB[v] += alpha_c * G.gcon(Loci::center, j, i, v+1, 3) *
+                    (psi_U.flux(X3DIR, ipsi, k+1, j, i) - psi_U.flux(X3DIR, ipsi, k, j, i)) / G.dx3v(k);
+
+        // Second term: beta^i divB
+        dB[v] += G.gcon(Loci::center, j, i, 0, v+1) * alpha_c * alpha_c * divB;
+    }
+    // Update psi using the analytic solution for the source term
+    GReal dalpha1 = ( (1. / sqrt(-G.gcon(Loci::face1, j, i+1, 0, 0))) / G.gdet(Loci::face1, j, i+1)
+                    - (1. / sqrt(-G.gcon(Loci::face1, j, i, 0, 0))) / G.gdet(Loci::face1, j, i)) / G.dx1v(i);
+    GReal dalpha2 = ( (1. / sqrt(-G.gcon(Loci::face2, j+1, i, 0, 0))) / G.gdet(Loci::face2, j+1, i)
+                    - (1. / sqrt(-G.gcon(Loci::face2, j, i, 0, 0))) / G.gdet(Loci::face2, j, i)) / G.dx2v(i);
+    // There is not dalpha3, the coordinate system is symmetric along x3
+    dpsi = B_U(iB + V1, k, j, i) * dalpha1 + B_U(iB + V2, k, j, i) * dalpha2 - alpha_c * lambda * psi_U(ipsi, k, j, i);
+}
+
 /**
  * Take a maximum over the divB array, which is updated every step
  * 
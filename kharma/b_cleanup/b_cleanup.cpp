@@ -98,6 +98,13 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     // Scalar potential, solution to div^2 p = div B
     // Thus when we subtract the gradient, div (B - div p) == 0!
     pkg->AddField("p", m);
+    // The potential is synced separately by the solver, so needn't go in the boundary sync of each stage
+    std::string sync_p = pin->GetOrAddString("b_cleanup", "sync_p", "none");
+    if (sync_p != "all" && sync_p != "last" && sync_p != "none") {
+        throw std::invalid_argument("b_cleanup/sync_p must be one of all, last, none!");
+    }
+    params.Add("sync_optional", std::vector<std::string>{"p"});
+    params.Add("sync_optional_stages", sync_p);
 
     // Scalar laplacian div^2 p. No need to sync this, we write/read it only on physical zones
     m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
@@ -113,7 +113,7 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
 
     // Ensure that prims get filled
     if (!implicit_b) {
-        //pkg->FillDerivedMesh = B_FluxCT::FillDerivedMesh;
+        pkg->FillDerivedMesh = B_FluxCT::FillDerivedMesh;
         pkg->FillDerivedBlock = B_FluxCT::FillDerivedBlock;
     }
 
@@ -200,7 +200,7 @@ void PtoU(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     );
 }
 
-TaskStatus FluxCT(MeshData<Real> *md)
+TaskStatus FluxCT(MeshData<Real> *md, int halo)
 {
     Flag(md, "Flux CT");
     // Pointers
@@ -214,9 +214,13 @@ TaskStatus FluxCT(MeshData<Real> *md)
     const auto& B_F = md->PackVariablesAndFluxes(std::vector<std::string>{"cons.B"});
 
     // Get sizes
-    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
-    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
-    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    // Any extra halo of updated ghost zones counts as interior here
+    const IndexRange ib_i = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb_i = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb_i = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange ib = IndexRange{ib_i.s - halo, ib_i.e + halo};
+    const IndexRange jb = IndexRange{jb_i.s - halo, jb_i.e + halo};
+    const IndexRange kb = (ndim > 2) ? IndexRange{kb_i.s - halo, kb_i.e + halo} : kb_i;
     const IndexRange block = IndexRange{0, B_F.GetDim(5)-1};
     // One zone halo on the *right only*, except for k in 2D
     const IndexRange il = IndexRange{ib.s, ib.e + 1};
@@ -282,7 +286,7 @@ TaskStatus FluxCT(MeshData<Real> *md)
     return TaskStatus::complete;
 }
 
-TaskStatus FixPolarFlux(MeshData<Real> *md)
+TaskStatus FixPolarFlux(MeshData<Real> *md, int halo)
 {
     Flag(md, "Fixing polar B fluxes");
     auto pmesh = md->GetMeshPointer();
@@ -293,6 +297,9 @@ TaskStatus FixPolarFlux(MeshData<Real> *md)
     int js = pmb0->cellbounds.js(domain), je = pmb0->cellbounds.je(domain);
     int ks = pmb0->cellbounds.ks(domain), ke = pmb0->cellbounds.ke(domain);
     const int ndim = pmesh->ndim;
+    // Cover any extra halo of updated ghost zones along the pole
+    is -= halo; ie += halo;
+    if (ndim > 2) { ks -= halo; ke += halo; }
 
     int je_e = (ndim > 1) ? je + 1 : je;
     int ke_e = (ndim > 2) ? ke + 1 : ke;
@@ -330,13 +337,13 @@ TaskStatus FixPolarFlux(MeshData<Real> *md)
     return TaskStatus::complete;
 }
 
-TaskStatus TransportB(MeshData<Real> *md)
+TaskStatus TransportB(MeshData<Real> *md, int halo)
 {
     auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
     if (pmb0->packages.Get("B_FluxCT")->Param<bool>("fix_polar_flux")) {
-        FixPolarFlux(md);
+        FixPolarFlux(md, halo);
     }
-    FluxCT(md);
+    FluxCT(md, halo);
     return TaskStatus::complete;
 }
 
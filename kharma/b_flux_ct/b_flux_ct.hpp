@@ -77,19 +77,20 @@ void PtoU(MeshBlockData<Real> *md, IndexDomain domain=IndexDomain::entire, bool
 
 /**
  * Modify the B field fluxes to take a constrained-transport step as in Toth (2000)
+ * If halo > 0, also covers that many rows of ghost zones, see perf/deep_halo
  */
-TaskStatus FluxCT(MeshData<Real> *md);
+TaskStatus FluxCT(MeshData<Real> *md, int halo);
 
 /**
  * Modify the B field fluxes just beyond the polar boundary so as to ensure no flux through it,
  * after applying FluxCT
  */
-TaskStatus FixPolarFlux(MeshData<Real> *md);
+TaskStatus FixPolarFlux(MeshData<Real> *md, int halo);
 
 /**
  * Task combining the above two (polar fix and FluxCT) for simplicity
  */
-TaskStatus TransportB(MeshData<Real> *md);
+TaskStatus TransportB(MeshData<Real> *md, int halo);
 
 /**
  * Calculate maximum corner-centered divergence of magnetic field,
@@ -36,6 +36,8 @@
 
 #include "boundaries.hpp"
 
+#include <algorithm>
+
 #include "kharma.hpp"
 #include "flux.hpp"
 #include "flux_functions.hpp"
@@ -271,7 +273,7 @@ void KBoundaries::OuterX2(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse)
  * Zero flux of mass through inner and outer boundaries, and everything through the pole
  * TODO Both may be unnecessary...
  */
-TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
+TaskStatus KBoundaries::FixFlux(MeshData<Real> *md, int halo)
 {
     Flag("Fixing fluxes");
     auto pmesh = md->GetMeshPointer();
@@ -286,6 +288,10 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
     const int js = pmb0->cellbounds.js(domain), je = pmb0->cellbounds.je(domain);
     const int ks = pmb0->cellbounds.ks(domain), ke = pmb0->cellbounds.ke(domain);
     const int ndim = pmesh->ndim;
+    // Faces along each boundary are fixed over any extra halo of updated ghost zones, too
+    const int is_h = is - halo, ie_h = ie + halo;
+    const int js_h = (ndim > 1) ? js - halo : js, je_h = (ndim > 1) ? je + halo : je;
+    const int ks_h = (ndim > 2) ? ks - halo : ks, ke_h = (ndim > 2) ? ke + halo : ke;
 
     // Fluxes are defined at faces, so there is one more valid flux than
     // valid cell in the face direction.  That is, e.g. F1 is valid on
@@ -303,7 +309,7 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
 
         if (check_inflow_inner) {
             if (pmb->boundary_flag[BoundaryFace::inner_x1] == BoundaryFlag::user) {
-                pmb->par_for("fix_flux_in_l", ks, ke, js, je, is, is,
+                pmb->par_for("fix_flux_in_l", ks_h, ke_h, js_h, je_h, is, is,
                     KOKKOS_LAMBDA_3D {
                         F.flux(X1DIR, m_rho, k, j, i) = min(F.flux(X1DIR, m_rho, k, j, i), 0.);
                     }
@@ -312,7 +318,7 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
         }
         if (check_inflow_outer) {
             if (pmb->boundary_flag[BoundaryFace::outer_x1] == BoundaryFlag::user) {
-                pmb->par_for("fix_flux_in_r", ks, ke, js, je, ie_l, ie_l,
+                pmb->par_for("fix_flux_in_r", ks_h, ke_h, js_h, je_h, ie_l, ie_l,
                     KOKKOS_LAMBDA_3D {
                         F.flux(X1DIR, m_rho, k, j, i) = max(F.flux(X1DIR, m_rho, k, j, i), 0.);
                     }
@@ -324,7 +330,7 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
         if (fix_flux_pole) {
             if (pmb->boundary_flag[BoundaryFace::inner_x2] == BoundaryFlag::user) {
                 // This loop covers every flux we need
-                pmb->par_for("fix_flux_pole_l", 0, F.GetDim(4) - 1, ks, ke, js, js, is, ie,
+                pmb->par_for("fix_flux_pole_l", 0, F.GetDim(4) - 1, ks_h, ke_h, js, js, is_h, ie_h,
                     KOKKOS_LAMBDA_VARS {
                         F.flux(X2DIR, p, k, j, i) = 0.;
                     }
@@ -332,7 +338,7 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
             }
 
             if (pmb->boundary_flag[BoundaryFace::outer_x2] == BoundaryFlag::user) {
-                pmb->par_for("fix_flux_pole_r", 0, F.GetDim(4) - 1, ks, ke, je_l, je_l, is, ie,
+                pmb->par_for("fix_flux_pole_r", 0, F.GetDim(4) - 1, ks_h, ke_h, je_l, je_l, is_h, ie_h,
                     KOKKOS_LAMBDA_VARS {
                         F.flux(X2DIR, p, k, j, i) = 0.;
                     }
@@ -345,6 +351,125 @@ TaskStatus KBoundaries::FixFlux(MeshData<Real> *md)
     return TaskStatus::complete;
 }
 
+TaskStatus KBoundaries::ClearBoundaries(MeshData<Real> *md)
+{
+    Flag(md, "Clearing boundaries");
+    for (int b = 0; b < md->NumBlocks(); ++b) {
+        md->GetBlockData(b)->ClearBoundary(BoundaryCommSubset::all);
+    }
+    Flag(md, "Cleared");
+    return TaskStatus::complete;
+}
+
+std::string KBoundaries::SyncContainer(Mesh *pmesh, const std::string& stage_name, bool last_stage)
+{
+    // Refinement prolongates every FillGhost field after the sync, so we'd better have sent them all
+    if (pmesh->multilevel) return stage_name;
+
+    std::vector<std::string> skip;
+    for (auto &package : pmesh->packages.AllPackages()) {
+        auto& params = package.second->AllParams();
+        if (!params.hasKey("sync_optional")) continue;
+        const std::string stages = params.Get<std::string>("sync_optional_stages");
+        if (stages == "none" || (stages == "last" && !last_stage)) {
+            for (auto &field : params.Get<std::vector<std::string>>("sync_optional")) skip.push_back(field);
+        }
+    }
+    if (skip.empty()) return stage_name;
+
+    // The same stage container can be synced with different subsets on the last stage & others,
+    // e.g. with in-place low-storage integrators
+    const std::string sync_name = stage_name + (last_stage ? "_sync_last" : "_sync");
+    for (auto &pmb : pmesh->block_list) {
+        auto& rc = pmb->meshblock_data.Get(stage_name);
+        std::vector<std::string> fields;
+        for (auto &v : rc->GetCellVariableVector()) {
+            if (v->IsSet(Metadata::FillGhost) && std::find(skip.begin(), skip.end(), v->label()) == skip.end())
+                fields.push_back(v->label());
+        }
+        // Returns the existing container, if we've made it before
+        pmb->meshblock_data.Add(sync_name, rc, fields);
+    }
+    return sync_name;
+}
+
+std::shared_ptr<StateDescriptor> KBoundaries::Initialize(ParameterInput *pin)
+{
+    auto pkg = std::make_shared<StateDescriptor>("Boundaries");
+    Params &params = pkg->AllParams();
+
+    // Print the amount of ghost zone data exchanged per step, whenever it changes
+    bool report_sync_bytes = pin->GetOrAddBoolean("perf", "report_sync_bytes", false);
+    params.Add("report_sync_bytes", report_sync_bytes);
+    // Bytes sent by this rank so far this step, to blocks on this rank and others, see CountSyncBytes
+    params.Add("sync_bytes_local", 0.0, true);
+    params.Add("sync_bytes_remote", 0.0, true);
+    // Last reported totals over all ranks
+    params.Add("sync_bytes_last", -1.0, true);
+
+    return pkg;
+}
+
+TaskStatus KBoundaries::CountSyncBytes(MeshBlockData<Real> *rc)
+{
+    auto pmb = rc->GetBlockPointer();
+    auto& params = pmb->packages.Get("Boundaries")->AllParams();
+    double local = params.Get<double>("sync_bytes_local");
+    double remote = params.Get<double>("sync_bytes_remote");
+
+    // Components of all the fields we're sending
+    int ncomp = 0;
+    for (auto &v : rc->GetCellVariableVector()) {
+        if (v->IsSet(Metadata::FillGhost)) ncomp += v->GetDim(4) * v->GetDim(5) * v->GetDim(6);
+    }
+
+    // Interior size, and ghost zone width, in each direction
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+    const int nx[3] = {ib.e - ib.s + 1, jb.e - jb.s + 1, kb.e - kb.s + 1};
+    const int ng[3] = {ib.s, jb.s, kb.s};
+
+    for (int n = 0; n < pmb->pbval->nneighbor; ++n) {
+        const auto& nb = pmb->pbval->neighbor[n];
+        const int ox[3] = {nb.ni.ox1, nb.ni.ox2, nb.ni.ox3};
+        double zones = 1.;
+        for (int d = 0; d < 3; ++d) zones *= (ox[d] == 0) ? nx[d] : ng[d];
+        const double bytes = zones * ncomp * sizeof(Real);
+        if (nb.snb.rank == Globals::my_rank) {
+            local += bytes;
+        } else {
+            remote += bytes;
+        }
+    }
+
+    params.Update<double>("sync_bytes_local", local);
+    params.Update<double>("sync_bytes_remote", remote);
+    return TaskStatus::complete;
+}
+
+TaskStatus KBoundaries::CountSyncBytesMesh(MeshData<Real> *md)
+{
+    for (int b = 0; b < md->NumBlocks(); ++b) {
+        CountSyncBytes(md->GetBlockData(b).get());
+    }
+    return TaskStatus::complete;
+}
+
+void KBoundaries::ReportSyncBytes(Mesh *pmesh, const SimTime& tm)
+{
+    auto& params = pmesh->packages.Get("Boundaries")->AllParams();
+    const double local = MPISum(params.Get<double>("sync_bytes_local"));
+    const double remote = MPISum(params.Get<double>("sync_bytes_remote"));
+    params.Update<double>("sync_bytes_local", 0.);
+    params.Update<double>("sync_bytes_remote", 0.);
+    if (local + remote != params.Get<double>("sync_bytes_last") && MPIRank0()) {
+        std::cout << "Ghost zone exchange from cycle " << tm.ncycle << ": " << (local + remote) / 1.e6
+                  << " MB per step, " << remote / 1.e6 << " MB between ranks" << std::endl;
+    }
+    params.Update<double>("sync_bytes_last", local + remote);
+}
+
 void KBoundaries::SyncAllBounds(Mesh *pmesh, bool sync_prims, bool sync_phys)
 {
     // TODO this does syncs per-block.  Correctly and without race conditions afaict,
@@ -48,6 +48,11 @@
  */
 namespace KBoundaries {
 
+/**
+ * Initialize the "package," which holds only options & counters for the ghost zone exchange
+ */
+std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin);
+
 /**
  * Any KHARMA-defined boundaries.
  * These usually behave like Parthenon's Outflow in X1 and Reflect in X2, except
@@ -65,8 +70,39 @@ void OuterX2(std::shared_ptr<MeshBlockData<Real>> &rc, bool coarse);
 
 /**
  * Fix fluxes on physical boundaries. Ensure no inflow flux, correct B fields on reflecting conditions.
+ * If halo > 0, also fixes the boundary faces of that many rows of ghost zones, see perf/deep_halo
+ */
+TaskStatus FixFlux(MeshData<Real> *rc, int halo);
+
+/**
+ * Clear the boundary communication flags of each block in md, waiting on any outstanding sends.
+ * Used to finish boundary syncs which span more than one TaskCollection, see HARMDriver.
+ */
+TaskStatus ClearBoundaries(MeshData<Real> *md);
+
+/**
+ * Name of the container to exchange in the boundary sync at the end of a stage.
+ * Packages can list fields which they recompute from others right after the sync, in params "sync_optional",
+ * with "sync_optional_stages" one of "all" (exchange them anyway), "last" (only at the end of each step), or "none".
+ * If any are left out of this stage's sync, this returns a container holding the remaining fields of the stage
+ * container, sharing their data.  Otherwise, or with mesh refinement, it returns the stage container's name.
+ */
+std::string SyncContainer(Mesh *pmesh, const std::string& stage_name, bool last_stage);
+
+/**
+ * Add the ghost zone data sent by a block or blocks in one sync to this rank's total for the step,
+ * kept in the package's Params.  Added after each send task by AddBoundarySync with perf/report_sync_bytes,
+ * so only data actually sent is counted.
+ * Assumes all neighbors are on the same refinement level
+ */
+TaskStatus CountSyncBytes(MeshBlockData<Real> *rc);
+TaskStatus CountSyncBytesMesh(MeshData<Real> *md);
+
+/**
+ * Print the total ghost zone data exchanged by all ranks in this step, whenever it changes, and reset the count.
+ * Called after each step with perf/report_sync_bytes.  Must be called on all ranks
  */
-TaskStatus FixFlux(MeshData<Real> *rc);
+void ReportSyncBytes(Mesh *pmesh, const SimTime& tm);
 
 /**
  * Single call to sync all boundary conditions.
@@ -38,6 +38,10 @@
 
 #include "gr_coordinates.hpp"
 
+#include <map>
+#include <sstream>
+#include <tuple>
+
 // This needs to be included only here -- it requires full-formed Parthenon
 // types, which are not available when importing this file's header
 #include "types.hpp"
@@ -63,10 +67,55 @@ using namespace Kokkos;
  */
 GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): UniformCartesian(rs, pin) {}
 GRCoordinates::GRCoordinates(const GRCoordinates &src, int coarsen): UniformCartesian(src, coarsen) {}
+void PruneGeometryCaches() {}
 #else
 // Internal function for initializing cache
 void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3);
 
+// Registry of geometry caches, shared by all GRCoordinates objects covering the same zones in X1 & X2.
+// None of our metrics depend on X3, so e.g. every block in a column in phi can use one copy.
+// Blocks hold the caches themselves (Views), the registry just finds them for new blocks
+namespace {
+struct GeomCacheKey {
+    int system_id, n1, n2;
+    GReal x1min, x1max, x2min, x2max;
+    bool operator<(const GeomCacheKey& o) const
+    {
+        return std::tie(system_id, n1, n2, x1min, x1max, x2min, x2max) <
+               std::tie(o.system_id, o.n1, o.n2, o.x1min, o.x1max, o.x2min, o.x2max);
+    }
+};
+struct GeomCache {
+    GeomTensor2 gcon, gcov;
+    GeomScalar gdet;
+    GeomTensor3 conn, gdet_conn;
+};
+std::map<GeomCacheKey, GeomCache> geom_caches;
+// Coordinate systems seen so far, indexed by GRCoordinates::system_id
+std::vector<std::string> geom_systems;
+bool geom_finalize_hook = false;
+
+int get_system_id(const std::string& system)
+{
+    for (int i = 0; i < (int) geom_systems.size(); ++i)
+        if (geom_systems[i] == system) return i;
+    geom_systems.push_back(system);
+    return geom_systems.size() - 1;
+}
+} // namespace
+
+void PruneGeometryCaches()
+{
+    // Entries which only the registry holds are no longer used by any block
+    for (auto it = geom_caches.begin(); it != geom_caches.end();) {
+        if (it->second.gcon.use_count() == 1) {
+            it = geom_caches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 /**
  * Construct a GRCoordinates object with a transformation according to preferences set in the package
  */
@@ -77,6 +126,11 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
     std::string base_str = pin->GetString("coordinates", "base"); // Require every problem to specify very basic geometry
     std::string transform_str = pin->GetString("coordinates", "transform"); // This is guessed in kharma.cpp
 
+    // Description of the full system, to tell when caches can be shared
+    std::ostringstream system;
+    system.precision(17);
+    system << base_str << " " << transform_str;
+
     SomeBaseCoords base;
     if (base_str == "spherical_minkowski") {
         base.emplace<SphMinkowskiCoords>(SphMinkowskiCoords());
@@ -84,9 +138,11 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
         base.emplace<CartMinkowskiCoords>(CartMinkowskiCoords());
     } else if (base_str == "spherical_ks" || base_str == "ks") {
         GReal a = pin->GetReal("coordinates", "a");
+        system << " a=" << a;
         base.emplace<SphKSCoords>(SphKSCoords(a));
     } else if (base_str == "spherical_bl" || base_str == "bl") {
         GReal a = pin->GetReal("coordinates", "a");
+        system << " a=" << a;
         base.emplace<SphBLCoords>(SphBLCoords(a));
     } else {
         throw std::invalid_argument("Unsupported base coordinates!");
@@ -105,6 +161,7 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
     } else if (transform_str == "modified" || transform_str == "mks") {
         if (!spherical) throw std::invalid_argument("Transform is for spherical coordinates!");
         GReal hslope = pin->GetOrAddReal("coordinates", "hslope", 0.3);
+        system << " hslope=" << hslope;
         transform.emplace<ModifyTransform>(ModifyTransform(hslope));
     } else if (transform_str == "funky" || transform_str == "fmks") {
         if (!spherical) throw std::invalid_argument("Transform is for spherical coordinates!");
@@ -113,12 +170,15 @@ GRCoordinates::GRCoordinates(const RegionSize &rs, ParameterInput *pin): Uniform
         GReal mks_smooth = pin->GetOrAddReal("coordinates", "mks_smooth", 0.5);
         GReal poly_xt = pin->GetOrAddReal("coordinates", "poly_xt", 0.82);
         GReal poly_alpha = pin->GetOrAddReal("coordinates", "poly_alpha", 14.0);
+        system << " startx1=" << startx1 << " hslope=" << hslope << " mks_smooth=" << mks_smooth
+               << " poly_xt=" << poly_xt << " poly_alpha=" << poly_alpha;
         transform.emplace<FunkyTransform>(FunkyTransform(startx1, hslope, mks_smooth, poly_xt, poly_alpha));
     } else {
         throw std::invalid_argument("Unsupported coordinate transform!");
     }
 
     coords = CoordinateEmbedding(base, transform);
+    system_id = get_system_id(system.str());
 
     n1 = rs.nx1 + 2*Globals::nghost;
     n2 = rs.nx2 > 1 ? rs.nx2 + 2*Globals::nghost : 1;
@@ -133,6 +193,7 @@ GRCoordinates::GRCoordinates(const GRCoordinates &src, int coarsen): UniformCart
 {
     //std::cerr << "Calling coarsen constructor" << std::endl;
     coords = src.coords;
+    system_id = src.system_id;
     n1 = src.n1/coarsen;
     n2 = src.n2/coarsen;
     n3 = src.n3/coarsen;
@@ -148,13 +209,28 @@ GRCoordinates::GRCoordinates(const GRCoordinates &src, int coarsen): UniformCart
  * fun issues with C++ Lambda capture, which Kokkos brings to the fore
  */
 void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
+    // Use the caches of any block over the same X1, X2 zones
+    const GeomCacheKey key = {G.system_id, n1, n2, G.x1f(0), G.x1f(n1), G.x2f(0), G.x2f(n2)};
+    auto found = geom_caches.find(key);
+    if (found != geom_caches.end()) {
+        G.gcon_direct = found->second.gcon;
+        G.gcov_direct = found->second.gcov;
+        G.gdet_direct = found->second.gdet;
+        G.conn_direct = found->second.conn;
+        G.gdet_conn_direct = found->second.gdet_conn;
+        return;
+    }
+    // Otherwise, take the chance to free anything no longer used
+    PruneGeometryCaches();
+
     //cerr << "Creating GRCoordinate cache size " << n1 << " " << n2 << endl;
     // Cache geometry.  May be faster than re-computing. May not be.
-    G.gcon_direct = GeomTensor2("gcon", NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
-    G.gcov_direct = GeomTensor2("gcov", NLOC, n2+1, n1+1, GR_DIM, GR_DIM);
+    // Only the mu <= nu components of symmetric indices are kept, see sym_index
+    G.gcon_direct = GeomTensor2("gcon", NLOC, n2+1, n1+1, GR_SYM2);
+    G.gcov_direct = GeomTensor2("gcov", NLOC, n2+1, n1+1, GR_SYM2);
     G.gdet_direct = GeomScalar("gdet", NLOC, n2+1, n1+1);
-    G.conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_DIM, GR_DIM);
-    G.gdet_conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_DIM, GR_DIM);
+    G.conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_SYM2);
+    G.gdet_conn_direct = GeomTensor3("conn", n2, n1, GR_DIM, GR_SYM2);
 
     // Member variables have an implicit this->
     // C++ Lambdas (and therefore Kokkos Lambdas) capture pointers to objects, not full objects
@@ -196,17 +272,17 @@ void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
                             const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
                             // Add to running averages
                             gdet_local(loc, j, i) += gdet / square;
-                            DLOOP2 {
-                                gcov_local(loc, j, i, mu, nu) += gcov_loc[mu][nu] / square;
-                                gcon_local(loc, j, i, mu, nu) += gcon_loc[mu][nu] / square;
+                            DLOOP2_SYM {
+                                gcov_local(loc, j, i, sym_index(mu, nu)) += gcov_loc[mu][nu] / square;
+                                gcon_local(loc, j, i, sym_index(mu, nu)) += gcon_loc[mu][nu] / square;
                             }
                             if (loc == Loci::center) {
                                 // In the center, get the connection and gdet*connection
                                 Real conn_loc[GR_DIM][GR_DIM][GR_DIM];
                                 G.coords.conn_native(X, DELTA, conn_loc);
-                                DLOOP3 {
-                                    conn_local(j, i, mu, nu, lam) += conn_loc[mu][nu][lam] / square;
-                                    gdet_conn_local(j, i, mu, nu, lam) += gdet*conn_loc[mu][nu][lam] / square;
+                                DLOOP2_SYM for (int lam = 0; lam < GR_DIM; ++lam) {
+                                    conn_local(j, i, lam, sym_index(mu, nu)) += conn_loc[lam][mu][nu] / square;
+                                    gdet_conn_local(j, i, lam, sym_index(mu, nu)) += gdet*conn_loc[lam][mu][nu] / square;
                                 }
                             }
                         }
@@ -228,9 +304,9 @@ void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
                         const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
                         // Add to running averages
                         gdet_local(loc, j, i) += gdet / diameter;
-                        DLOOP2 {
-                            gcov_local(loc, j, i, mu, nu) += gcov_loc[mu][nu] / diameter;
-                            gcon_local(loc, j, i, mu, nu) += gcon_loc[mu][nu] / diameter;
+                        DLOOP2_SYM {
+                            gcov_local(loc, j, i, sym_index(mu, nu)) += gcov_loc[mu][nu] / diameter;
+                            gcon_local(loc, j, i, sym_index(mu, nu)) += gcon_loc[mu][nu] / diameter;
                         }
                     }
                 } else {
@@ -243,9 +319,9 @@ void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
                     const GReal gdet = G.coords.gcon_native(gcov_loc, gcon_loc);
                     // Set geometry
                     gdet_local(loc, j, i) = gdet;
-                    DLOOP2 {
-                        gcov_local(loc, j, i, mu, nu) = gcov_loc[mu][nu];
-                        gcon_local(loc, j, i, mu, nu) = gcon_loc[mu][nu];
+                    DLOOP2_SYM {
+                        gcov_local(loc, j, i, sym_index(mu, nu)) = gcov_loc[mu][nu];
+                        gcon_local(loc, j, i, sym_index(mu, nu)) = gcon_loc[mu][nu];
                     }
                 }
             }
@@ -275,8 +351,8 @@ void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
                         GReal test_sum = 0;
                         GReal sum_portions, portions[GR_DIM] = {0};
                         DLOOP1 {
-                            test_sum += gdet_conn_local(j, i, mu, mu, lam);
-                            portions[mu] = fabs(gdet_conn_local(j, i, mu, mu, lam));
+                            test_sum += gdet_conn_local(j, i, mu, sym_index(mu, lam));
+                            portions[mu] = fabs(gdet_conn_local(j, i, mu, sym_index(mu, lam)));
                             sum_portions += portions[mu];
                         }
                         DLOOP1 portions[mu] /= sum_portions;
@@ -284,16 +360,21 @@ void init_GRCoordinates(GRCoordinates& G, int n1, int n2, int n3) {
 
                         // Add the difference among components equally
                         const GReal diff = test_sum - target;
-                        DLOOP1 gdet_conn_local(j, i, mu, mu, lam) = gdet_conn_local(j, i, mu, mu, lam) - diff*portions[mu];
-
-                        // This is separated and set equal, as there will be one self-assignment
-                        DLOOP1 gdet_conn_local(j, i, mu, lam, mu) = gdet_conn_local(j, i, mu, mu, lam);
+                        // (mu, mu, lam) and (mu, lam, mu) are the same packed component
+                        DLOOP1 gdet_conn_local(j, i, mu, sym_index(mu, lam)) = gdet_conn_local(j, i, mu, sym_index(mu, lam)) - diff*portions[mu];
                     }
                 }
             }
         );
     }
 
+    // Register the new caches, making sure they're freed before Kokkos is
+    geom_caches[key] = GeomCache{G.gcon_direct, G.gcov_direct, G.gdet_direct, G.conn_direct, G.gdet_conn_direct};
+    if (!geom_finalize_hook) {
+        Kokkos::push_finalize_hook([]() { geom_caches.clear(); });
+        geom_finalize_hook = true;
+    }
+
     Flag("GRCoordinates metric init");
 }
 #endif // FAST_CARTESIAN
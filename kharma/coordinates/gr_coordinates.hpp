@@ -73,7 +73,11 @@ public:
 
     // TODO try again to get these from parent always, e.g. with the RegionSize or len()
     int n1, n2, n3;
-    // And optionally some caches
+    // Index of the coordinate system (base, transform & parameters), for sharing caches
+    int system_id = 0;
+    // And optionally some caches.  Tensors are packed by symmetry, see sym_index:
+    // (loc, j, i, sym_index(mu, nu)) for the metrics, (j, i, mu, sym_index(nu, lam)) for the connections.
+    // Blocks with the same X1, X2 zones share one copy of each, see init_GRCoordinates
 #if !FAST_CARTESIAN && !NO_CACHE
     GeomTensor2 gcon_direct, gcov_direct;
     GeomScalar gdet_direct;
@@ -97,6 +101,7 @@ public:
         n1 = src.n1;
         n2 = src.n2;
         n3 = src.n3;
+        system_id = src.system_id;
     #if !FAST_CARTESIAN && !NO_CACHE
         gcon_direct = src.gcon_direct;
         gcov_direct = src.gcov_direct;
@@ -113,6 +118,7 @@ public:
         n1 = src.n1;
         n2 = src.n2;
         n3 = src.n3;
+        system_id = src.system_id;
     #if !FAST_CARTESIAN && !NO_CACHE
         gcon_direct = src.gcon_direct;
         gcov_direct = src.gcov_direct;
@@ -150,6 +156,12 @@ public:
     // TODO Indexing functions and named slices to make it comfy
 };
 
+/**
+ * Free any shared geometry caches no longer used by a GRCoordinates object, e.g. those of blocks
+ * removed in a remesh.  Host-side only
+ */
+void PruneGeometryCaches();
+
 /**
  * Function to return native coordinates on the GRCoordinates
  */
@@ -292,22 +304,22 @@ KOKKOS_INLINE_FUNCTION void GRCoordinates::conn(const int& j, const int& i, Real
 }
 #else
 KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcon(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
-    {return gcon_direct(loc, j, i, mu, nu);}
+    {return gcon_direct(loc, j, i, sym_index(mu, nu));}
 KOKKOS_INLINE_FUNCTION Real GRCoordinates::gcov(const Loci loc, const int& j, const int& i, const int mu, const int nu) const
-    {return gcov_direct(loc, j, i, mu, nu);}
+    {return gcov_direct(loc, j, i, sym_index(mu, nu));}
 KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet(const Loci loc, const int& j, const int& i) const
     {return gdet_direct(loc, j, i);}
 KOKKOS_INLINE_FUNCTION Real GRCoordinates::conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
-    {return conn_direct(j, i, mu, nu, lam);}
+    {return conn_direct(j, i, mu, sym_index(nu, lam));}
 KOKKOS_INLINE_FUNCTION Real GRCoordinates::gdet_conn(const int& j, const int& i, const int mu, const int nu, const int lam) const
-    {return gdet_conn_direct(j, i, mu, nu, lam);}
+    {return gdet_conn_direct(j, i, mu, sym_index(nu, lam));}
 
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcon(const Loci loc, const int& j, const int& i, Real gcon[GR_DIM][GR_DIM]) const
-    {DLOOP2 gcon[mu][nu] = gcon_direct(loc, j, i, mu, nu);}
+    {DLOOP2_SYM gcon[mu][nu] = gcon[nu][mu] = gcon_direct(loc, j, i, sym_index(mu, nu));}
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gcov(const Loci loc, const int& j, const int& i, Real gcov[GR_DIM][GR_DIM]) const
-    {DLOOP2 gcov[mu][nu] = gcov_direct(loc, j, i, mu, nu);}
+    {DLOOP2_SYM gcov[mu][nu] = gcov[nu][mu] = gcov_direct(loc, j, i, sym_index(mu, nu));}
 KOKKOS_INLINE_FUNCTION void GRCoordinates::conn(const int& j, const int& i, Real conn[GR_DIM][GR_DIM][GR_DIM]) const
-    {DLOOP3 conn[mu][nu][lam] = conn_direct(j, i, mu, nu, lam);}
+    {DLOOP3 conn[mu][nu][lam] = conn_direct(j, i, mu, sym_index(nu, lam));}
 KOKKOS_INLINE_FUNCTION void GRCoordinates::gdet_conn(const int& j, const int& i, Real gdet_conn[GR_DIM][GR_DIM][GR_DIM]) const
-    {DLOOP3 gdet_conn[mu][nu][lam] = gdet_conn_direct(j, i, mu, nu, lam);}
+    {DLOOP3 gdet_conn[mu][nu][lam] = gdet_conn_direct(j, i, mu, sym_index(nu, lam));}
 #endif
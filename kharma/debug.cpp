@@ -37,6 +37,7 @@
 #include "decs.hpp"
 
 #include "floors.hpp"
+#include "grmhd.hpp"
 #include "grmhd_functions.hpp"
 #include "types.hpp"
 
@@ -163,14 +164,16 @@ int CountPFlags(MeshData<Real> *md, IndexDomain domain, int verbose)
     int n_cells = 0, n_tot = 0, n_neg_in = 0, n_max_iter = 0;
     int n_utsq = 0, n_gamma = 0, n_neg_u = 0, n_neg_rho = 0, n_neg_both = 0;
     auto pmesh = md->GetMeshPointer();
+    // Flags of all blocks on this rank at once
+    auto pflag = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     GRMHD::PFlags(pmesh->block_list[0].get()));
 
     int block = 0;
     for (auto &pmb : pmesh->block_list) {
         int is = pmb->cellbounds.is(domain), ie = pmb->cellbounds.ie(domain);
         int js = pmb->cellbounds.js(domain), je = pmb->cellbounds.je(domain);
         int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
-        auto& rc = pmb->meshblock_data.Get();
-        auto pflag = rc->Get("pflag").data.GetHostMirrorAndCopy();
+        const int lid = pmb->lid;
 
     // OpenMP causes problems when used separately from Kokkos
     // TODO make this a kokkos reduction to a View
@@ -180,7 +183,7 @@ int CountPFlags(MeshData<Real> *md, IndexDomain domain, int verbose)
                 for(int i=is; i <= ie; ++i)
         {
             ++n_cells;
-            int flag = (int) pflag(k, j, i);
+            int flag = pflag(lid, k, j, i);
             if (flag > InversionStatus::success) ++n_tot; // Corner regions use negative flags.  They aren't "failures"
             if (flag == InversionStatus::neg_input) ++n_neg_in;
             if (flag == InversionStatus::max_iter) ++n_max_iter;
@@ -232,13 +235,14 @@ int CountFFlags(MeshData<Real> *md, IndexDomain domain, int verbose)
 {
     int n_cells = 0, n_tot = 0, n_geom_rho = 0, n_geom_u = 0, n_b_rho = 0, n_b_u = 0, n_temp = 0, n_gamma = 0, n_ktot = 0;
     auto pmesh = md->GetMeshPointer();
+    auto fflag = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     Floors::FFlags(pmesh->block_list[0].get()));
 
     for (auto &pmb : pmesh->block_list) {
         int is = pmb->cellbounds.is(domain), ie = pmb->cellbounds.ie(domain);
         int js = pmb->cellbounds.js(domain), je = pmb->cellbounds.je(domain);
         int ks = pmb->cellbounds.ks(domain), ke = pmb->cellbounds.ke(domain);
-        auto& rc = pmb->meshblock_data.Get();
-        auto fflag = rc->Get("fflag").data.GetHostMirrorAndCopy();
+        const int lid = pmb->lid;
 
     // See above re: Openmp. TODO Kokkosify
 //#pragma omp parallel for simd collapse(3) reduction(+:n_cells,n_tot,n_geom_rho,n_geom_u,n_b_rho,n_b_u,n_temp,n_gamma,n_ktot)
@@ -247,7 +251,7 @@ int CountFFlags(MeshData<Real> *md, IndexDomain domain, int verbose)
                 for(int i=is; i <= ie; ++i)
         {
             ++n_cells;
-            int flag = (int) fflag(k, j, i);
+            int flag = fflag(lid, k, j, i);
             if (flag != 0) ++n_tot;
             if (flag & HIT_FLOOR_GEOM_RHO) ++n_geom_rho;
             if (flag & HIT_FLOOR_GEOM_U) ++n_geom_u;
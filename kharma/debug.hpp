@@ -57,12 +57,12 @@ TaskStatus CheckNegative(MeshData<Real> *md, IndexDomain domain);
 // using ParArrayNDIntHost = ParArrayNDGeneric<Kokkos::View<int ******, parthenon::LayoutWrapper, Kokkos::HostSpace::memory_space>>;
 
 /**
- * Function for counting & printing pflags.  Note this needs a host-side array! Call pflags.getHostMirrorAndCopy() first!
+ * Function for counting & printing pflags.  Copies the flags of all blocks on this rank to the host
  */
 int CountPFlags(MeshData<Real> *md, IndexDomain domain=IndexDomain::entire, int verbose=0);
 
 /**
- * Function for counting & printing pflags.  Note this needs a host-side array! Call fflags.getHostMirrorAndCopy() first!
+ * Function for counting & printing fflags.  Copies the flags of all blocks on this rank to the host
  */
 int CountFFlags(MeshData<Real> *md, IndexDomain domain=IndexDomain::interior, int verbose=0);
 
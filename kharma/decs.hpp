@@ -70,6 +70,14 @@
 // Lots of work will need to be done for Real != double
 using Real = parthenon::Real;
 using GReal = double;
+// Reconstructed left/right states and their fluxes in the flux kernels.
+// Optionally single precision, see FLUX_SINGLE_PRECISION in CMakeLists.txt.
+// Conserved variables, fluxes written to the mesh, and geometry are always Real
+#if FLUX_SINGLE_PRECISION
+using FluxReal = float;
+#else
+using FluxReal = Real;
+#endif
 
 // A small number, compared to the grid or problem scale
 #define SMALL 1e-20
@@ -80,6 +88,16 @@ using GReal = double;
 #define DLOOP2 DLOOP1 for(int nu = 0; nu < GR_DIM; ++nu)
 #define DLOOP3 DLOOP2 for(int lam = 0; lam < GR_DIM; ++lam)
 #define DLOOP4 DLOOP3 for(int kap = 0; kap < GR_DIM; ++kap)
+// Metric tensors are symmetric, and connections symmetric in their lower indices, so the geometry
+// caches store only the GR_SYM2 components mu <= nu, indexed by sym_index(mu, nu)
+#define GR_SYM2 10
+#define DLOOP2_SYM DLOOP1 for(int nu = mu; nu < GR_DIM; ++nu)
+KOKKOS_INLINE_FUNCTION int sym_index(const int& mu, const int& nu)
+{
+    const int a = (mu < nu) ? mu : nu;
+    const int b = (mu < nu) ? nu : mu;
+    return a*GR_DIM - a*(a+1)/2 + b;
+}
 
 #define NVEC 3
 #define VLOOP for(int v = 0; v < NVEC; ++v)
@@ -141,10 +159,11 @@ using GridVector = parthenon::ParArrayND<Real>;
 using GridVars = parthenon::ParArrayND<Real>;  // TODO ELIM
 using GridInt = parthenon::ParArrayND<int>;
 
-using GeomScalar = parthenon::ParArrayND<Real>;
+// Geometry caches are plain Views of fixed rank, so that shared caches can check their use_count()
+using GeomScalar = parthenon::ParArray3D<Real>;
 using GeomVector = parthenon::ParArrayND<Real>;
-using GeomTensor2 = parthenon::ParArrayND<Real>;
-using GeomTensor3 = parthenon::ParArrayND<Real>;
+using GeomTensor2 = parthenon::ParArray4D<Real>;
+using GeomTensor3 = parthenon::ParArray4D<Real>;
 
 // Specific lambdas for our array shapes
 #define KOKKOS_LAMBDA_1D KOKKOS_LAMBDA (const int& i)
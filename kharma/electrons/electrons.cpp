@@ -151,6 +151,7 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     // TODO if nKs == 1 then rename Kel_Whatever -> Kel?
     // TODO record nKs and find a nice way to loop/vector the device-side layout?
 
+    pkg->FillDerivedMesh = Electrons::FillDerivedMesh;
     pkg->FillDerivedBlock = Electrons::FillDerivedBlock;
     return pkg;
 }
@@ -193,6 +194,29 @@ TaskStatus InitElectrons(MeshBlockData<Real> *rc, ParameterInput *pin)
     return TaskStatus::complete;
 }
 
+void UtoP(MeshData<Real> *md, IndexDomain domain, bool coarse)
+{
+    Flag(md, "UtoP electrons Mesh");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    MetadataFlag isElectrons = pmb0->packages.Get("Electrons")->Param<MetadataFlag>("ElectronsFlag");
+    MetadataFlag isPrimitive = pmb0->packages.Get("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
+    const auto& e_P = md->PackVariables(std::vector<MetadataFlag>{isElectrons, isPrimitive});
+    const auto& e_U = md->PackVariables(std::vector<MetadataFlag>{isElectrons, Metadata::Conserved});
+    const auto& rho_U = md->PackVariables(std::vector<std::string>{"cons.rho"});
+
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    const IndexRange ib = bounds.GetBoundsI(domain);
+    const IndexRange jb = bounds.GetBoundsJ(domain);
+    const IndexRange kb = bounds.GetBoundsK(domain);
+    const IndexRange block = IndexRange{0, e_P.GetDim(5) - 1};
+    pmb0->par_for("UtoP_electrons", block.s, block.e, 0, e_P.GetDim(4)-1, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_VARS {
+            e_P(b, p, k, j, i) = e_U(b, p, k, j, i) / rho_U(b, 0, k, j, i);
+        }
+    );
+}
+
 void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
 {
     Flag(rc, "UtoP electrons");
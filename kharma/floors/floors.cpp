@@ -38,7 +38,9 @@
 
 #include "debug.hpp"
 #include "fixup.hpp"
+#include "grmhd.hpp"
 #include "grmhd_functions.hpp"
+#include "local_timestep.hpp"
 #include "pack.hpp"
 
 namespace Floors
@@ -126,12 +128,21 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin)
     bool disable_floors = pin->GetOrAddBoolean("floors", "disable_floors", false);
     params.Add("disable_floors", disable_floors);
 
-    // Temporary fix just for being able to save field values
-    // Should switch these to "Integer" fields when Parthenon supports it
-    Metadata m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
-    pkg->AddField("fflag", m);
+    // Flags recording which floors were hit in each zone, kept as int16 outside Parthenon's
+    // (Real-only) fields, see FFlags.  The field "fflag" is only allocated to copy them into for output
+    params.Add("fflags", ParArray4D<int16_t>(), true);
+    if (GRMHD::OutputRequested(pin, "fflag")) {
+        Metadata m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+        pkg->AddField("fflag", m);
+    }
+
+    // Geometric floors at each zone of each block, precomputed in spherical coordinates, see UpdateGeomFloorTable.
+    // The keys record which block (level, lx1, lx2) each lid's slice was computed for
+    params.Add("geom_floor_table", ParArray5D<Real>(), true);
+    params.Add("geom_floor_keys", std::vector<int>(), true);
 
     // Floors should be applied to primitive ("Derived") variables just after they are calculated.
+    pkg->PostFillDerivedMesh = Floors::PostFillDerivedMesh;
     pkg->PostFillDerivedBlock = Floors::PostFillDerivedBlock;
     // Could print floor flags using this package, but they're very similar to pflag
     // so I'm leaving them together
@@ -142,19 +153,93 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin)
 
 TaskStatus PostFillDerivedBlock(MeshBlockData<Real> *rc)
 {
+    // With perf/fused_utop_floors, floors were applied along with UtoP, see GRMHD::PostFillDerivedBlock
     if (rc->GetBlockPointer()->packages.Get("Floors")->Param<bool>("disable_floors")
-        || !rc->GetBlockPointer()->packages.Get("Globals")->Param<bool>("in_loop")) {
+        || !rc->GetBlockPointer()->packages.Get("Globals")->Param<bool>("in_loop")
+        || rc->GetBlockPointer()->packages.Get("GRMHD")->Param<bool>("fused_utop_floors")) {
         return TaskStatus::complete;
     } else {
         return ApplyFloors(rc);
     }
 }
 
+TaskStatus PostFillDerivedMesh(MeshData<Real> *md)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    if (pmb0->packages.Get("Floors")->Param<bool>("disable_floors")
+        || !pmb0->packages.Get("Globals")->Param<bool>("in_loop")
+        || pmb0->packages.Get("GRMHD")->Param<bool>("fused_utop_floors")) {
+        return TaskStatus::complete;
+    } else {
+        return ApplyFloors(md);
+    }
+}
+
+TaskStatus ApplyFloors(MeshData<Real> *md)
+{
+    Flag(md, "Apply floors Mesh");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap prims_map, cons_map;
+    const auto& P = GRMHD::PackMHDPrims(md, prims_map);
+    const auto& U = GRMHD::PackMHDCons(md, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    const auto pflag = GRMHD::PFlags(pmb0.get());
+    const auto fflag = FFlags(pmb0.get());
+
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const Floors::Prescription floors(pmb0->packages.Get("Floors")->AllParams(), md);
+
+    // Same zones as the MeshBlockData version below
+    const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+    // Skip blocks sitting out this step under local timestepping, except for any ghost zones
+    // UtoP filled, see LocalTimestep::BlockFilled
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb0.get());
+    const IndexRange ib_b = md->GetBoundsI(IndexDomain::interior);
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+    pmb0->par_for("apply_floors", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (steps.fills_zone(gid0 + b, i, ib_b) && pflag(lid0 + b, k, j, i) >= InversionStatus::success) {
+                const auto& G = U.GetCoords(b);
+                int comboflag = apply_floors(G, P(b), m_p, gam, k, j, i, floors.for_block(lid0 + b), U(b), m_u);
+                fflag(lid0 + b, k, j, i) = (comboflag / HIT_FLOOR_GEOM_RHO) * HIT_FLOOR_GEOM_RHO;
+#if !FUSE_FLOOR_KERNELS
+            }
+        }
+    );
+    pmb0->par_for("apply_ceilings", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (steps.fills_zone(gid0 + b, i, ib_b) && pflag(lid0 + b, k, j, i) >= InversionStatus::success) {
+                const auto& G = U.GetCoords(b);
+#endif
+                int addflag = fflag(lid0 + b, k, j, i);
+                addflag |= apply_ceilings(G, P(b), m_p, gam, k, j, i, floors, U(b), m_u);
+                fflag(lid0 + b, k, j, i) = addflag;
+            }
+        }
+    );
+
+    Flag(md, "Applied");
+    return TaskStatus::complete;
+}
+
 TaskStatus ApplyFloors(MeshBlockData<Real> *rc)
 {
     Flag(rc, "Apply floors");
     auto pmb = rc->GetBlockPointer();
 
+    // Blocks sitting out this step under local timestepping keep their state, except in ghost zones
+    // UtoP filled, see LocalTimestep::BlockFilled
+    if (!LocalTimestep::BlockFilled(pmb.get())) return TaskStatus::complete;
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb.get());
+    const IndexRange ib_b = rc->GetBoundsI(IndexDomain::interior);
+    const int gid = pmb->gid;
+
     PackIndexMap prims_map, cons_map;
     auto P = GRMHD::PackMHDPrims(rc, prims_map);
     auto U = GRMHD::PackMHDCons(rc, cons_map);
@@ -162,11 +247,12 @@ TaskStatus ApplyFloors(MeshBlockData<Real> *rc)
 
     const auto& G = pmb->coords;
 
-    GridScalar pflag = rc->Get("pflag").data;
-    GridScalar fflag = rc->Get("fflag").data;
+    const auto pflag = GRMHD::PFlags(pmb.get());
+    const auto fflag = FFlags(pmb.get());
+    const int lid = pmb->lid;
 
     const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
-    const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams());
+    const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams(), pmb.get());
 
     // Apply floors over the same zones we just updated with UtoP
     // This selects the entire zone, but we then require pflag >= 0,
@@ -177,10 +263,10 @@ TaskStatus ApplyFloors(MeshBlockData<Real> *rc)
     const IndexRange kb = rc->GetBoundsK(IndexDomain::entire);
     pmb->par_for("apply_floors", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_3D {
-            if (((int) pflag(k, j, i)) >= InversionStatus::success) {
+            if (steps.fills_zone(gid, i, ib_b) && pflag(lid, k, j, i) >= InversionStatus::success) {
                 // apply_floors can involve another U_to_P call.  Hide the pflag in bottom 5 bits and retrieve both
                 int comboflag = apply_floors(G, P, m_p, gam, k, j, i, floors, U, m_u);
-                fflag(k, j, i) = (comboflag / HIT_FLOOR_GEOM_RHO) * HIT_FLOOR_GEOM_RHO;
+                fflag(lid, k, j, i) = (comboflag / HIT_FLOOR_GEOM_RHO) * HIT_FLOOR_GEOM_RHO;
 
                 // The floors as they're written guarantee a consistent state in their cells,
                 // so we do not flag any additional cells, nor do we remove existing flags
@@ -192,13 +278,13 @@ TaskStatus ApplyFloors(MeshBlockData<Real> *rc)
     );
     pmb->par_for("apply_ceilings", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_3D {
-            if (((int) pflag(k, j, i)) >= InversionStatus::success) {
+            if (steps.fills_zone(gid, i, ib_b) && pflag(lid, k, j, i) >= InversionStatus::success) {
 #endif
                 // Apply ceilings *after* floors, to make the temperature ceiling better-behaved
                 // Ceilings never involve a U_to_P call
-                int addflag = fflag(k, j, i);
+                int addflag = fflag(lid, k, j, i);
                 addflag |= apply_ceilings(G, P, m_p, gam, k, j, i, floors, U, m_u);
-                fflag(k, j, i) = addflag;
+                fflag(lid, k, j, i) = addflag;
             }
         }
     );
@@ -207,4 +293,89 @@ TaskStatus ApplyFloors(MeshBlockData<Real> *rc)
     return TaskStatus::complete;
 }
 
+ParArray4D<int16_t> FFlags(MeshBlock *pmb)
+{
+    auto& params = pmb->packages.Get("Floors")->AllParams();
+    auto fflags = params.Get<ParArray4D<int16_t>>("fflags");
+    // (Re)allocate when first used, or when the number of blocks on this rank changes on remesh
+    const int nblocks = pmb->pmy_mesh->block_list.size();
+    if (fflags.extent_int(0) != nblocks) {
+        const auto& cb = pmb->cellbounds;
+        fflags = ParArray4D<int16_t>("fflags", nblocks, cb.ncellsk(IndexDomain::entire),
+                                     cb.ncellsj(IndexDomain::entire), cb.ncellsi(IndexDomain::entire));
+        params.Update<ParArray4D<int16_t>>("fflags", fflags);
+    }
+    return fflags;
+}
+
+void UpdateGeomFloorTable(Mesh *pmesh)
+{
+    auto& pmb = pmesh->block_list[0];
+    auto& params = pmb->packages.Get("Floors")->AllParams();
+    auto table = params.Get<ParArray5D<Real>>("geom_floor_table");
+    if (!pmb->coords.coords.spherical()) return;
+
+    auto keys = params.Get<std::vector<int>>("geom_floor_keys");
+    bool changed = false;
+    // (Re)allocate when first used, or when the number of blocks on this rank changes on remesh
+    const int nblocks = pmesh->block_list.size();
+    if (table.extent_int(0) != nblocks) {
+        const auto& cb = pmb->cellbounds;
+        // rho floor, u floor, r at the faces & center
+        table = ParArray5D<Real>("geom_floor_table", nblocks, Loci::center + 1, 3,
+                                 cb.ncellsj(IndexDomain::entire), cb.ncellsi(IndexDomain::entire));
+        params.Update<ParArray5D<Real>>("geom_floor_table", table);
+        keys.assign(3 * nblocks, -1);
+        changed = true;
+    }
+
+    // Fill the slice of any block which isn't the one it was computed for.
+    // The floors depend only on X1 & X2, so blocks at the same level, lx1, lx2 share values
+    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
+    const Prescription floors(params);
+    for (auto &pmb_l : pmesh->block_list) {
+        const int lid = pmb_l->lid;
+        const int key[3] = {pmb_l->loc.level, static_cast<int>(pmb_l->loc.lx1), static_cast<int>(pmb_l->loc.lx2)};
+        if (keys[3*lid] == key[0] && keys[3*lid + 1] == key[1] && keys[3*lid + 2] == key[2]) continue;
+
+        const auto& G = pmb_l->coords;
+        const IndexRange ib = pmb_l->cellbounds.GetBoundsI(IndexDomain::entire);
+        const IndexRange jb = pmb_l->cellbounds.GetBoundsJ(IndexDomain::entire);
+        pmb_l->par_for("geom_floor_table", 0, (int) Loci::center, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA (const int& l, const int& j, const int& i) {
+                // floors has no table, so this computes the values
+                Real rhoflr_geom, uflr_geom;
+                GReal r;
+                geom_floors(G, floors, gam, 0, j, i, static_cast<Loci>(l), rhoflr_geom, uflr_geom, r);
+                table(lid, l, 0, j, i) = rhoflr_geom;
+                table(lid, l, 1, j, i) = uflr_geom;
+                table(lid, l, 2, j, i) = r;
+            }
+        );
+        for (int v = 0; v < 3; ++v) keys[3*lid + v] = key[v];
+        changed = true;
+    }
+    if (changed) params.Update<std::vector<int>>("geom_floor_keys", keys);
+}
+
+void FillOutput(MeshBlock *pmb, ParameterInput *pin)
+{
+    // Copy the flags into the Real field "fflag", if it was allocated for output
+    if (!GRMHD::OutputRequested(pin, "fflag")) return;
+    auto rc = pmb->meshblock_data.Get().get();
+
+    const auto fflag = FFlags(pmb);
+    const int lid = pmb->lid;
+    GridScalar fflag_field = rc->Get("fflag").data;
+
+    const IndexRange ib = rc->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = rc->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = rc->GetBoundsK(IndexDomain::entire);
+    pmb->par_for("fill_output_fflag", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_3D {
+            fflag_field(k, j, i) = fflag(lid, k, j, i);
+        }
+    );
+}
+
 } // namespace Floors
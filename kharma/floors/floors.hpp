@@ -80,12 +80,37 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin);
  * LOCKSTEP: this function respects P and returns consistent P<->U
  */
 TaskStatus ApplyFloors(MeshBlockData<Real> *rc);
+TaskStatus ApplyFloors(MeshData<Real> *md);
 
 /**
  * Parthenon call wrapper for ApplyFloors, called just after FillDerived == UtoP
  * Decides whether to apply floors based on options, then does so
  */
 TaskStatus PostFillDerivedBlock(MeshBlockData<Real> *rc);
+TaskStatus PostFillDerivedMesh(MeshData<Real> *md);
+
+/**
+ * Returns the floor flags of all blocks on this rank, indexed (lid, k, j, i), see HIT_FLOOR_* above.
+ * Stored as int16 rather than in a Real field, and copied to the field "fflag" only for output.
+ * Allocated on first use and re-allocated if the number of blocks changes.
+ */
+ParArray4D<int16_t> FFlags(MeshBlock *pmb);
+
+/**
+ * Fill the field "fflag" for output, if requested
+ */
+void FillOutput(MeshBlock *pmb, ParameterInput *pin);
+
+/**
+ * Refresh the table "geom_floor_table" of geometric density & internal energy floors, and the embedding
+ * radius r (for the mixed frame), at each zone (j, i) and location (face1-3 or center) of all blocks
+ * on this rank, indexed (lid, loc, var, j, i).
+ * In spherical coordinates these depend only on (j, i), so the floor kernels read them here rather than
+ * calling coord_embed and pow in every zone.  Left empty in other coordinate systems.
+ * Called once at the start of each step: the table is reallocated when the number of blocks changes,
+ * and only the slices of blocks which changed (i.e. on remesh) are recomputed.
+ */
+void UpdateGeomFloorTable(Mesh *pmesh);
 
 /**
  * Struct to hold floor values without cumbersome dictionary/string logistics.
@@ -105,6 +130,10 @@ class Prescription {
         // Floor options
         bool fluid_frame, mixed_frame;
         bool use_r_char, temp_adjust_u, adjust_k;
+        // Precomputed geometric floors, see UpdateGeomFloorTable, and which block's to use.
+        // Left empty by the Params-only constructor, in which case they're computed on the fly
+        ParArray5D<Real> geom_table;
+        int lid = 0;
 
         Prescription(const parthenon::Params& params)
         {
@@ -125,8 +154,87 @@ class Prescription {
             temp_adjust_u = params.Get<bool>("temp_adjust_u");
             adjust_k = params.Get<bool>("adjust_k");
         }
+        // Also use the floor tables of pmb's rank.
+        // Before the table is first filled, or if it's out of date for pmb, floors are computed on the fly
+        Prescription(const parthenon::Params& params, MeshBlock *pmb): Prescription(params)
+        {
+            lid = pmb->lid;
+            const auto& table = params.Get<ParArray5D<Real>>("geom_floor_table");
+            const auto& keys = params.Get<std::vector<int>>("geom_floor_keys");
+            if (table.extent_int(0) == (int) pmb->pmy_mesh->block_list.size() && table_current(keys, pmb))
+                geom_table = table;
+        }
+        // Mesh-level kernels should use this version, and select each block with for_block().
+        // The tables are used only if they're current for every block of md: a FillDerived between a remesh
+        // and the next UpdateGeomFloorTable (e.g. Parthenon's initialization of new blocks) would otherwise
+        // read stale slices for any reassigned lids
+        Prescription(const parthenon::Params& params, MeshData<Real> *md): Prescription(params)
+        {
+            auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+            lid = pmb0->lid;
+            const auto& table = params.Get<ParArray5D<Real>>("geom_floor_table");
+            const auto& keys = params.Get<std::vector<int>>("geom_floor_keys");
+            if (table.extent_int(0) != (int) pmb0->pmy_mesh->block_list.size()) return;
+            for (int b = 0; b < md->NumBlocks(); ++b) {
+                if (!table_current(keys, md->GetBlockData(b)->GetBlockPointer().get())) return;
+            }
+            geom_table = table;
+        }
+
+        // Whether pmb's slice of the table was computed for it, see UpdateGeomFloorTable
+        static bool table_current(const std::vector<int>& keys, MeshBlock *pmb)
+        {
+            const int l = pmb->lid;
+            return 3*l + 2 < (int) keys.size() && keys[3*l] == pmb->loc.level &&
+                   keys[3*l + 1] == pmb->loc.lx1 && keys[3*l + 2] == pmb->loc.lx2;
+        }
+
+        KOKKOS_INLINE_FUNCTION Prescription for_block(const int& lid_b) const
+        {
+            Prescription block_floors = *this;
+            block_floors.lid = lid_b;
+            return block_floors;
+        }
 };
 
+/**
+ * Geometric floors on density and internal energy at a zone, and its embedding radius r (0 if not spherical).
+ * Read from the Prescription's table if it has one, see UpdateGeomFloorTable, which is filled by this function
+ */
+KOKKOS_INLINE_FUNCTION void geom_floors(const GRCoordinates& G, const Floors::Prescription& floors, const Real& gam,
+                                        const int& k, const int& j, const int& i, const Loci loc,
+                                        Real& rhoflr_geom, Real& uflr_geom, GReal& r)
+{
+    if(G.coords.spherical()) {
+        if (floors.geom_table.size() > 0 && loc != Loci::corner) {
+            rhoflr_geom = floors.geom_table(floors.lid, loc, 0, j, i);
+            uflr_geom = floors.geom_table(floors.lid, loc, 1, j, i);
+            r = floors.geom_table(floors.lid, loc, 2, j, i);
+            return;
+        }
+        GReal Xembed[GR_DIM];
+        G.coord_embed(k, j, i, loc, Xembed);
+        r = Xembed[1];
+        // TODO measure whether this/if 1 is really faster
+        // GReal r = exp(G.x1v(i));
+
+        if (floors.use_r_char) {
+            // Steeper floor from iharm3d
+            Real rhoscal = pow(r, -2.) * 1 / (1 + r / floors.r_char);
+            rhoflr_geom = floors.rho_min_geom * rhoscal;
+            uflr_geom = floors.u_min_geom * pow(rhoscal, gam);
+        } else {
+            // Original floors from iharm2d
+            rhoflr_geom = floors.rho_min_geom * pow(r, -1.5);
+            uflr_geom = floors.u_min_geom * pow(r, -2.5); //rhoscal/r as in iharm2d
+        }
+    } else {
+        rhoflr_geom = floors.rho_min_geom;
+        uflr_geom = floors.u_min_geom;
+        r = 0.;
+    }
+}
+
 /**
  * Apply all ceilings together, currently at most one on velocity and two on internal energy
  * 
@@ -203,32 +311,11 @@ KOKKOS_INLINE_FUNCTION int apply_floors(const GRCoordinates& G, const VariablePa
     // Then apply floors:
     // 1. Geometric hard floors, not based on fluid relationships
     Real rhoflr_geom, uflr_geom;
-    bool use_ff;
-    if(G.coords.spherical()) {
-        GReal Xembed[GR_DIM];
-        G.coord_embed(k, j, i, loc, Xembed);
-        GReal r = Xembed[1];
-        // TODO measure whether this/if 1 is really faster
-        // GReal r = exp(G.x1v(i));
+    GReal r;
+    geom_floors(G, floors, gam, k, j, i, loc, rhoflr_geom, uflr_geom, r);
+    // Use the fluid frame if specified, or in outer domain
+    const bool use_ff = floors.fluid_frame || (floors.mixed_frame && G.coords.spherical() && r > floors.frame_switch);
 
-        // Use the fluid frame if specified, or in outer domain
-        use_ff = floors.fluid_frame || (floors.mixed_frame && r > floors.frame_switch);
-
-        if (floors.use_r_char) {
-            // Steeper floor from iharm3d
-            Real rhoscal = pow(r, -2.) * 1 / (1 + r / floors.r_char);
-            rhoflr_geom = floors.rho_min_geom * rhoscal;
-            uflr_geom = floors.u_min_geom * pow(rhoscal, gam);
-        } else {
-            // Original floors from iharm2d
-            rhoflr_geom = floors.rho_min_geom * pow(r, -1.5);
-            uflr_geom = floors.u_min_geom * pow(r, -2.5); //rhoscal/r as in iharm2d
-        }
-    } else {
-        rhoflr_geom = floors.rho_min_geom;
-        uflr_geom = floors.u_min_geom;
-        use_ff = floors.fluid_frame;
-    }
     Real rho = P(m_p.RHO, k, j, i);
     Real u = P(m_p.UU, k, j, i);
 
@@ -344,25 +431,8 @@ KOKKOS_INLINE_FUNCTION int apply_geo_floors(const GRCoordinates& G, Local& P, co
 {
     // Apply only the geometric floors
     Real rhoflr_geom, uflr_geom;
-    if(G.coords.spherical()) {
-        GReal Xembed[GR_DIM];
-        G.coord_embed(0, j, i, loc, Xembed);
-        GReal r = Xembed[1];
-
-        if (floors.use_r_char) {
-            // Steeper floor from iharm3d
-            Real rhoscal = pow(r, -2.) * 1 / (1 + r / floors.r_char);
-            rhoflr_geom = floors.rho_min_geom * rhoscal;
-            uflr_geom = floors.u_min_geom * pow(rhoscal, gam);
-        } else {
-            // Original floors from iharm2d
-            rhoflr_geom = floors.rho_min_geom * pow(r, -1.5);
-            uflr_geom = floors.u_min_geom * pow(r, -2.5); //rhoscal/r as in iharm2d
-        }
-    } else {
-        rhoflr_geom = floors.rho_min_geom;
-        uflr_geom = floors.u_min_geom;
-    }
+    GReal r;
+    geom_floors(G, floors, gam, 0, j, i, loc, rhoflr_geom, uflr_geom, r);
 
     int fflag = 0;
 #if RECORD_POST_RECON
@@ -385,25 +455,8 @@ KOKKOS_INLINE_FUNCTION int apply_geo_floors(const GRCoordinates& G, Global& P, c
 {
     // Apply only the geometric floors
     Real rhoflr_geom, uflr_geom;
-    if(G.coords.spherical()) {
-        GReal Xembed[GR_DIM];
-        G.coord_embed(k, j, i, loc, Xembed);
-        GReal r = Xembed[1];
-
-        if (floors.use_r_char) {
-            // Steeper floor from iharm3d
-            Real rhoscal = pow(r, -2.) * 1 / (1 + r / floors.r_char);
-            rhoflr_geom = floors.rho_min_geom * rhoscal;
-            uflr_geom = floors.u_min_geom * pow(rhoscal, gam);
-        } else {
-            // Original floors from iharm2d
-            rhoflr_geom = floors.rho_min_geom * pow(r, -1.5);
-            uflr_geom = floors.u_min_geom * pow(r, -2.5); //rhoscal/r as in iharm2d
-        }
-    } else {
-        rhoflr_geom = floors.rho_min_geom;
-        uflr_geom = floors.u_min_geom;
-    }
+    GReal r;
+    geom_floors(G, floors, gam, k, j, i, loc, rhoflr_geom, uflr_geom, r);
 
     int fflag = 0;
 #if RECORD_POST_RECON
@@ -35,6 +35,7 @@
 #include "flux.hpp"
 
 #include "source.hpp"
+#include "wind.hpp"
 
 using namespace parthenon;
 
@@ -117,3 +118,106 @@ TaskStatus Flux::PtoU(MeshBlockData<Real> *rc, IndexDomain domain)
     Flag(rc, "Got conserved variables");
     return TaskStatus::complete;
 }
+
+template<int Pkgs>
+TaskStatus Flux::ApplyFluxesAndUpdate(MeshData<Real> *md, MeshData<Real> *md_base, const Real gam0, const Real gam1,
+                                      const Real beta_dt, MeshData<Real> *md_out, const int halo)
+{
+    Flag(md, "Applying fluxes and updating");
+    // Pointers
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& pkgs = pmb0->packages.AllPackages();
+    // Options
+    const int ndim = pmesh->ndim;
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const bool use_wind = pkgs.count("Wind");
+    const Wind::WindParams wind = use_wind ? Wind::GetParams(pmb0.get()) : Wind::WindParams();
+
+    // Pack variables.  Parthenon's functions update every Independent variable,
+    // all of which in KHARMA also have fluxes
+    PackIndexMap prims_map, cons_map;
+    auto P = GRMHD::PackMHDPrims(md, prims_map);
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Independent}, cons_map);
+    const auto& U_base = md_base->PackVariables(std::vector<MetadataFlag>{Metadata::Independent});
+    auto U_out = md_out->PackVariables(std::vector<MetadataFlag>{Metadata::Independent});
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    const int nvar = U.GetDim(4);
+    // Get sizes.  Like Parthenon, we update the whole block, but dU/dt is only nonzero in the interior,
+    // plus any halo of ghost zones with valid fluxes in nontrivial dimensions
+    const IndexRange ib_i = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb_i = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb_i = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange ib = IndexRange{ib_i.s - halo, ib_i.e + halo};
+    const IndexRange jb = (ndim > 1) ? IndexRange{jb_i.s - halo, jb_i.e + halo} : jb_i;
+    const IndexRange kb = (ndim > 2) ? IndexRange{kb_i.s - halo, kb_i.e + halo} : kb_i;
+    const IndexRange ib_e = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb_e = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb_e = md->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+    // Under local timestepping, each block takes its own multiple of the step, or sits it out entirely
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb0.get());
+    const int gid0 = pmb0->gid;
+
+    pmb0->par_for("apply_fluxes_update", block.s, block.e, kb_e.s, kb_e.e, jb_e.s, jb_e.e, ib_e.s, ib_e.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (!steps.is_active(gid0 + b)) {
+                for (int p = 0; p < nvar; ++p) U_out(b, p, k, j, i) = U_base(b, p, k, j, i);
+                return;
+            }
+            const Real dt_b = beta_dt * steps.factor(gid0 + b);
+            const auto& G = U.GetCoords(b);
+            const bool interior = (k >= kb.s && k <= kb.e && j >= jb.s && j <= jb.e && i >= ib.s && i <= ib.e);
+
+            // Source terms for this zone
+            Real grmhd_du[GR_DIM] = {0}, wind_drho = 0., wind_dT[GR_DIM] = {0};
+            if (interior) {
+                GRMHD::calc_source<Pkgs>(G, P(b), m_p, gam, k, j, i, grmhd_du);
+                if (use_wind)
+                    Wind::calc_source(G, wind, gam, k, j, i, wind_drho, wind_dT);
+            }
+
+            for (int p = 0; p < nvar; ++p) {
+                Real du = 0.;
+                if (interior) {
+                    // Flux divergence, as Parthenon calculates it
+                    du = G.Area(X1DIR, k, j, i + 1) * U(b).flux(X1DIR, p, k, j, i + 1) -
+                         G.Area(X1DIR, k, j, i) * U(b).flux(X1DIR, p, k, j, i);
+                    if (ndim > 1)
+                        du += G.Area(X2DIR, k, j + 1, i) * U(b).flux(X2DIR, p, k, j + 1, i) -
+                              G.Area(X2DIR, k, j, i) * U(b).flux(X2DIR, p, k, j, i);
+                    if (ndim > 2)
+                        du += G.Area(X3DIR, k + 1, j, i) * U(b).flux(X3DIR, p, k + 1, j, i) -
+                              G.Area(X3DIR, k, j, i) * U(b).flux(X3DIR, p, k, j, i);
+                    du = -du / G.Volume(k, j, i);
+
+                    // Sources, in the order the separate tasks would add them
+                    if (p == m_u.UU) du += grmhd_du[0];
+                    if (p >= m_u.U1 && p <= m_u.U3) du += grmhd_du[1 + p - m_u.U1];
+                    if (use_wind) {
+                        if (p == m_u.RHO) du += wind_drho;
+                        if (p == m_u.UU) du += wind_dT[0];
+                        if (p >= m_u.U1 && p <= m_u.U3) du += wind_dT[1 + p - m_u.U1];
+                    }
+                }
+
+                // Average with the base state and take the substep
+                const Real U_avg = gam1 * U(b, p, k, j, i) + gam0 * U_base(b, p, k, j, i);
+                U_out(b, p, k, j, i) = U_avg + dt_b * du;
+            }
+        }
+    );
+
+    Flag(md, "Applied");
+    return TaskStatus::complete;
+}
+
+template TaskStatus Flux::ApplyFluxesAndUpdate<PackageSet::runtime>(MeshData<Real> *md, MeshData<Real> *md_base,
+                                                                    const Real gam0, const Real gam1, const Real beta_dt,
+                                                                    MeshData<Real> *md_out, const int halo);
+template TaskStatus Flux::ApplyFluxesAndUpdate<PackageSet::grhd>(MeshData<Real> *md, MeshData<Real> *md_base,
+                                                                 const Real gam0, const Real gam1, const Real beta_dt,
+                                                                 MeshData<Real> *md_out, const int halo);
+template TaskStatus Flux::ApplyFluxesAndUpdate<PackageSet::b_field>(MeshData<Real> *md, MeshData<Real> *md_base,
+                                                                    const Real gam0, const Real gam1, const Real beta_dt,
+                                                                    MeshData<Real> *md_out, const int halo);
@@ -40,8 +40,11 @@
 #include "debug.hpp"
 #include "floors.hpp"
 #include "flux_functions.hpp"
+#include "grmhd.hpp"
+#include "local_timestep.hpp"
 #include "pack.hpp"
 #include "reconstruction.hpp"
+#include "task_timing.hpp"
 #include "types.hpp"
 
 // Package functions
@@ -52,6 +55,13 @@
 #include "electrons.hpp"
 
 namespace Flux {
+/**
+ * Which faces GetFlux should calculate: all of them, only the "core" faces whose reconstruction stencils
+ * lie entirely in the interior of each block, or only the "shell" of remaining faces, which need ghost zones.
+ * Splitting the two lets the core fluxes be calculated while a boundary exchange is in flight.
+ */
+enum class FluxRegion {all=0, core, shell};
+
 /**
  * Calculate dU/dt from a set of fluxes.
  * This combines Parthenon's "FluxDivergence" operation with the GRMHD source term
@@ -62,6 +72,40 @@ namespace Flux {
  */
 TaskStatus ApplyFluxes(MeshData<Real> *md, MeshData<Real> *mdudt);
 
+/**
+ * Apply the fluxes and all explicit source terms, and take the RK substep, in a single kernel.
+ * Equivalent to Update::FluxDivergence, GRMHD::AddSource & Wind::AddSource,
+ * followed by Update::WeightedSumData(md, md_base, gam1, gam0) (for Parthenon's integrators,
+ * AverageIndependentData with gam1 = beta, gam0 = 1 - beta) and
+ * Update::UpdateIndependentData(md, dUdt, beta_dt, md_out), except that dU/dt is never written to memory
+ * (and md itself is not overwritten with the average).
+ * Thus it can't be used when something else needs dU/dt, e.g. the implicit solver in the ImEx driver.
+ * Nor with B_CD, whose AddSource modifies the stage's state directly, see GRMHD::Initialize.
+ * If halo > 0, the update is also taken in that many rows of ghost zones, which must have valid fluxes.
+ *
+ * Templated on the set of packages like GRMHD::AddSource, instantiated in flux.cpp
+ */
+template<int Pkgs=PackageSet::runtime>
+TaskStatus ApplyFluxesAndUpdate(MeshData<Real> *md, MeshData<Real> *md_base, const Real gam0, const Real gam1,
+                                const Real beta_dt, MeshData<Real> *md_out, const int halo);
+
+/**
+ * Add the fused update task to a list, using the version specialized for the loaded packages
+ */
+inline TaskID AddApplyFluxesAndUpdate(TaskID& t_start, TaskList& tl, MeshData<Real> *md, MeshData<Real> *md_base,
+                                      const Real gam0, const Real gam1, const Real beta_dt, MeshData<Real> *md_out,
+                                      const int halo=0)
+{
+    const int pkgs = SpecializedPackageSet(md->GetBlockData(0)->GetBlockPointer()->packages);
+    if (pkgs == PackageSet::runtime) {
+        return tl.AddTask(t_start, TIMED(Flux::ApplyFluxesAndUpdate<PackageSet::runtime>), md, md_base, gam0, gam1, beta_dt, md_out, halo);
+    } else if (pkgs & PackageSet::b_field) {
+        return tl.AddTask(t_start, TIMED(Flux::ApplyFluxesAndUpdate<PackageSet::b_field>), md, md_base, gam0, gam1, beta_dt, md_out, halo);
+    } else {
+        return tl.AddTask(t_start, TIMED(Flux::ApplyFluxesAndUpdate<PackageSet::grhd>), md, md_base, gam0, gam1, beta_dt, md_out, halo);
+    }
+}
+
 /**
  * Fill all conserved variables (U) from primitive variables (P), over the whole grid.
  * Second declaration is for Parthenon's benefit, similar to e.g.
@@ -89,6 +133,185 @@ KOKKOS_INLINE_FUNCTION Real hlle(const Real& fluxL, const Real& fluxR, const Rea
     return (cmax*fluxL + cmin*fluxR - cmax*cmin*(Ur - Ul)) / (cmax + cmin);
 }
 
+/**
+ * Reconstruct a single row of zones in direction dir, then calculate the conserved variables,
+ * fluxes, and signal speeds at each face, and write the final HLL/LLF fluxes to U.flux(dir),
+ * as well as the maximum signal speed to ctop(b, dir-1) if store_ctop is set.
+ * If ctop_lid >= 0, also reduces max(ctop/dx) over the interior faces of the row segment into ctop_block(ctop_lid, dir-1),
+ * which is used for the timestep in place of the ctop field (see GRMHD::CtopBuffer).
+ *
+ * This is the body of the flux kernel in GetFlux, split out of the outer loop over rows.
+ * Fluxes are calculated for faces is_l through ie_l, which can be any segment of a row.
+ * Expects scratch memory for Pl/Pr, Ul/Ur, Fl/Fr of size (nvar, n1), and cmax/cmin of size n1,
+ * already allocated by the caller.  Leaves the team synchronized when it returns.
+ *
+ * The left/right states and fluxes are stored as FluxReal, which is float if KHARMA is compiled with
+ * FLUX_SINGLE_PRECISION.  hlle/llf take Real arguments, so the final fluxes are combined in double precision.
+ */
+template <ReconstructionType Recon, int dir, int Pkgs>
+KOKKOS_INLINE_FUNCTION void calc_flux_row(parthenon::team_mbr_t& member, const GRCoordinates& G,
+                                          const VariablePack<Real>& P, const VariableFluxPack<Real>& U,
+                                          const MeshBlockPack<VariablePack<Real>>& ctop, const int& b, const bool& store_ctop,
+                                          const ParArray2D<Real>& ctop_block, const int& ctop_lid, const IndexRange& ib,
+                                          const VarMap& m_p, const VarMap& m_u,
+                                          const EMHD::EMHD_parameters& emhd_params, const Floors::Prescription& floors,
+                                          const Real& gam, const Real& ctop_max, const bool& use_hlle,
+                                          const bool& disable_floors, const int& nvar,
+                                          const int& k, const int& j, const int& is_l, const int& ie_l,
+                                          const ScratchPad2D<FluxReal>& Pl_s, const ScratchPad2D<FluxReal>& Pr_s,
+                                          const ScratchPad2D<FluxReal>& Ul_s, const ScratchPad2D<FluxReal>& Ur_s,
+                                          const ScratchPad2D<FluxReal>& Fl_s, const ScratchPad2D<FluxReal>& Fr_s,
+                                          const ScratchPad1D<Real>& cmax, const ScratchPad1D<Real>& cmin)
+{
+    const Loci loc = loc_of(dir);
+
+    // Wrapper for a big switch statement between reconstruction schemes. Possibly slow.
+    // This function is generally a lot of if statements
+    // In X1, the left state at face i comes from zone i-1, so we start one zone early
+    KReconstruction::reconstruct<Recon, dir>(member, G, P, k, j, is_l - (dir == X1DIR), ie_l, Pl_s, Pr_s);
+
+    // Sync all threads in the team so that scratch memory is consistent
+    member.team_barrier();
+
+    // Calculate conserved fluxes at centers & faces
+    parthenon::par_for_inner(member, is_l, ie_l,
+        [&](const int& i) {
+            auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
+            auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
+            // Apply floors to the *reconstructed* primitives, because without TVD
+            // we have no guarantee they remotely resemble the *centered* primitives
+            if (KReconstruction::is_stencil5(Recon) && !disable_floors) {
+                Floors::apply_geo_floors(G, Pl, m_p, gam, j, i, floors, loc);
+                Floors::apply_geo_floors(G, Pr, m_p, gam, j, i, floors, loc);
+            }
+#if !FUSE_FLUX_KERNELS
+        }
+    );
+    member.team_barrier();
+
+    // LEFT FACES, final ctop
+    parthenon::par_for_inner(member, is_l, ie_l,
+        [&](const int& i) {
+            auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
+#endif
+            auto Ul = Kokkos::subview(Ul_s, Kokkos::ALL(), i);
+            auto Fl = Kokkos::subview(Fl_s, Kokkos::ALL(), i);
+            // LR -> flux
+            // Declare temporary vectors
+            FourVectors Dtmp;
+
+            // Left
+            GRMHD::calc_4vecs<Pkgs>(G, Pl, m_p, j, i, loc, Dtmp);
+            Flux::prim_to_flux<Pkgs>(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
+            Flux::prim_to_flux<Pkgs>(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
+
+            // Magnetosonic speeds
+            Real cmaxL, cminL;
+            Flux::vchar<Pkgs>(G, Pl, m_p, Dtmp, gam, k, j, i, loc, dir, cmaxL, cminL);
+
+#if !FUSE_FLUX_KERNELS
+            // Record speeds
+            cmax(i) = max(0., cmaxL);
+            cmin(i) = max(0., -cminL);
+        }
+    );
+    member.team_barrier();
+
+    // RIGHT FACES, final ctop
+    parthenon::par_for_inner(member, is_l, ie_l,
+        [&](const int& i) {
+            // LR -> flux
+            // Declare temporary vectors
+            FourVectors Dtmp;
+            auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
+#endif
+            auto Ur = Kokkos::subview(Ur_s, Kokkos::ALL(), i);
+            auto Fr = Kokkos::subview(Fr_s, Kokkos::ALL(), i);
+            // Right
+            // TODO GRMHD/GRHD versions of this
+            GRMHD::calc_4vecs<Pkgs>(G, Pr, m_p, j, i, loc, Dtmp);
+            Flux::prim_to_flux<Pkgs>(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
+            Flux::prim_to_flux<Pkgs>(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
+
+            // Magnetosonic speeds
+            Real cmaxR, cminR;
+            Flux::vchar<Pkgs>(G, Pr, m_p, Dtmp, gam, k, j, i, loc, dir, cmaxR, cminR);
+
+#if FUSE_FLUX_KERNELS
+            // Calculate cmax/min from local variables
+            cmax(i) = fabs(max(cmaxL,  cmaxR));
+            cmin(i) = fabs(max(-cminL, -cminR));
+
+            if (use_hlle) {
+                for (int p=0; p < nvar; ++p)
+                    U.flux(dir, p, k, j, i) = hlle(Fl(p), Fr(p), cmax(i), cmin(i), Ul(p), Ur(p));
+            } else {
+                for (int p=0; p < nvar; ++p)
+                    U.flux(dir, p, k, j, i) = llf(Fl(p), Fr(p), cmax(i), cmin(i), Ul(p), Ur(p));
+            }
+            if (has_psi<Pkgs>(m_u)) {
+                // The unphysical variable psi and its corrections can propagate at the max speed
+                // for the stepsize, rather than the sound speed
+                // Since the speeds are the same it will always correspond to the LLF flux
+                U.flux(dir, m_u.PSI, k, j, i) = llf(Fl(m_u.PSI), Fr(m_u.PSI), ctop_max, ctop_max, Ul(m_u.PSI), Ur(m_u.PSI));
+                U.flux(dir, m_u.B1+dir-1, k, j, i) = llf(Fl(m_u.B1+dir-1), Fr(m_u.B1+dir-1), ctop_max, ctop_max, Ul(m_u.B1+dir-1), Ur(m_u.B1+dir-1));
+            }
+#else
+            // Calculate cmax/min based on comparison with cached values
+            cmax(i) = fabs(max(cmax(i),  cmaxR));
+            cmin(i) = fabs(max(cmin(i), -cminR));
+#endif
+            if (store_ctop) ctop(b, dir-1, k, j, i) = max(cmax(i), cmin(i));
+        }
+    );
+    member.team_barrier();
+
+#if !FUSE_FLUX_KERNELS
+    // Apply what we've calculated
+    for (int p=0; p < nvar; ++p) {
+        if (has_psi<Pkgs>(m_u) && (p == m_u.PSI || p == m_u.B1+dir-1)) {
+            // The unphysical variable psi and its corrections can propagate at the max speed for the stepsize, rather than the sound speed
+            // Since the speeds are the same it will always correspond to the LLF flux
+            parthenon::par_for_inner(member, is_l, ie_l,
+                [&](const int& i) {
+                    U.flux(dir, p, k, j, i) = llf(Fl_s(p,i), Fr_s(p,i), ctop_max, ctop_max, Ul_s(p,i), Ur_s(p,i));
+                }
+            );
+        } else if (use_hlle) {
+            // Option to try HLLE fluxes for everything else
+            parthenon::par_for_inner(member, is_l, ie_l,
+                [&](const int& i) {
+                    U.flux(dir, p, k, j, i) = hlle(Fl_s(p,i), Fr_s(p,i), cmax(i), cmin(i), Ul_s(p,i), Ur_s(p,i));
+                }
+            );
+        } else {
+            // Or LLF, probably safest option
+            parthenon::par_for_inner(member, is_l, ie_l,
+                [&](const int& i) {
+                    U.flux(dir, p, k, j, i) = llf(Fl_s(p,i), Fr_s(p,i), cmax(i), cmin(i), Ul_s(p,i), Ur_s(p,i));
+                }
+            );
+        }
+    }
+    // Scratch is re-used by any subsequent row
+    member.team_barrier();
+#endif
+
+    // Reduce the signal speed over the row for the timestep.  The reduction leaves the team synchronized
+    if (ctop_lid >= 0) {
+        Real row_max = 0.;
+        Kokkos::parallel_reduce(Kokkos::TeamVectorRange(member, max(ib.s, is_l), min(ib.e, ie_l) + 1),
+            [&](const int& i, Real& lmax) {
+                const Real dx = (dir == X1DIR) ? G.dx1v(i) : ((dir == X2DIR) ? G.dx2v(j) : G.dx3v(k));
+                lmax = max(lmax, max(cmax(i), cmin(i)) / dx);
+            }
+        , Kokkos::Max<Real>(row_max));
+        Kokkos::single(Kokkos::PerTeam(member), [&]() {
+            Kokkos::atomic_fetch_max(&ctop_block(ctop_lid, dir-1), row_max);
+        });
+    }
+}
+
 /**
  * Reconstruct the values of primitive variables at left and right zone faces,
  * find the corresponding conserved variables and their fluxes through the zone faces
@@ -98,15 +321,20 @@ KOKKOS_INLINE_FUNCTION Real hlle(const Real& fluxL, const Real& fluxR, const Rea
  * Memory-wise, this fills the "flux" portions of the "conserved" fields.  All fluxes are applied
  * together "ApplyFluxes," and the final fields are calculated by Parthenon in 
  * Also fills the "ctop" vector with the signal speed mhd_vchar -- used to estimate timestep later.
+ * With perf/reduce_ctop, the per-block maximum of ctop/dx is reduced on the fly instead,
+ * and the ctop field is only kept if it's needed for output or checks.
  * 
  * This function is defined in the header because it is templated on the reconstruction scheme and
  * direction.  Since there are only a few reconstruction schemes supported, and we will only ever
  * need fluxes in three directions, we can recompile the function for every combination.
  * This allows some extra optimization from knowing that dir != 0 in parcticular, and inlining
  * the particular reconstruction call we need.
+ *
+ * @param region calculate all faces, or just the core or shell faces, see FluxRegion
+ * @param halo_extra rows of ghost faces to calculate beyond the usual one, see perf/deep_halo
  */
-template <ReconstructionType Recon, int dir>
-inline TaskStatus GetFlux(MeshData<Real> *md)
+template <ReconstructionType Recon, int dir, int Pkgs=PackageSet::runtime>
+inline TaskStatus GetFlux(MeshData<Real> *md, const FluxRegion region, const int halo_extra)
 {
     Flag(md, "Recon and flux");
     // Pointers
@@ -124,18 +352,16 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     const bool use_hlle = pars.Get<bool>("use_hlle");
     const bool disable_floors = floor_pars.Get<bool>("disable_floors");
     // Pull out a struct of just the actual floor values for speed
-    const Floors::Prescription floors(floor_pars);
+    const Floors::Prescription floors(floor_pars, md);
     // Check presence of different packages
     const auto& pkgs = pmb0->packages.AllPackages();
-    const bool use_b_flux_ct = pkgs.count("B_FluxCT");
     const bool use_b_cd = pkgs.count("B_CD");
-    const bool use_electrons = pkgs.count("Electrons");
     const bool use_emhd = pkgs.count("EMHD");
     // Pull flag indicating primitive variables
     const MetadataFlag isPrimitive = pars.Get<MetadataFlag>("PrimitiveFlag");
 
     const Real gam = pars.Get<Real>("gamma");
-    const double ctop_max = (use_b_cd) ? globals.Get<Real>("ctop_max_last") : 0.0;
+    const Real ctop_max = (use_b_cd) ? globals.Get<Real>("ctop_max_last") : 0.0;
 
     EMHD::EMHD_parameters emhd_params_tmp;
     if (use_emhd) {
@@ -144,11 +370,20 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     }
     const EMHD::EMHD_parameters& emhd_params = emhd_params_tmp;
 
-    const Loci loc = loc_of(dir);
+    // Signal speeds are written to the ctop field if we're keeping it, and/or reduced
+    // into a per-block buffer for the timestep
+    const bool store_ctop = pars.Get<bool>("store_ctop");
+    const bool reduce_ctop = pars.Get<bool>("reduce_ctop");
+    const ParArray2D<Real> ctop_block = (reduce_ctop) ? GRMHD::CtopBuffer(pmb0.get()) : ParArray2D<Real>();
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+    // Blocks sitting out this step under local timestepping don't need fluxes
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb0.get());
 
     // Pack variables.  Keep ctop separate
     PackIndexMap prims_map, cons_map;
-    const auto& ctop = md->PackVariables(std::vector<std::string>{"ctop"});
+    MeshBlockPack<VariablePack<Real>> ctop;
+    if (store_ctop) ctop = md->PackVariables(std::vector<std::string>{"ctop"});
     const auto& P_all = md->PackVariables(std::vector<MetadataFlag>{isPrimitive}, prims_map);
     const auto& U_all = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
     const VarMap m_u(cons_map, true), m_p(prims_map, false);
@@ -159,24 +394,38 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
     const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
     const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
-    const IndexRange block = IndexRange{0, ctop.GetDim(5) - 1};
+    const IndexRange block = IndexRange{0, U_all.GetDim(5) - 1};
     const int nvar = U_all.GetDim(4);
-    // 1-zone halo in nontrivial dimensions
+    // 1-zone halo in nontrivial dimensions, plus any extra for stepping through ghost zones
     // We leave is/ie, js/je, ks/ke with their usual definitions for consistency, and define
     // the loop bounds separately to include the appropriate halo
-    int halo = 1;
+    const int halo = 1 + halo_extra;
     const IndexRange il = IndexRange{ib.s - halo, ib.e + halo};
     const IndexRange jl = (ndim > 1) ? IndexRange{jb.s - halo, jb.e + halo} : jb;
     const IndexRange kl = (ndim > 2) ? IndexRange{kb.s - halo, kb.e + halo} : kb;
 
+    // Core faces: those whose reconstruction stencil (3 zones behind the face, 2 ahead) is in the interior.
+    // Outside dir, that just means the face's zone is in the interior
+    IndexRange ic = (dir == X1DIR) ? IndexRange{ib.s + 3, ib.e - 2} : ib;
+    IndexRange jc = (dir == X2DIR) ? IndexRange{jb.s + 3, jb.e - 2} : jb;
+    IndexRange kc = (dir == X3DIR) ? IndexRange{kb.s + 3, kb.e - 2} : kb;
+    if (ic.e < ic.s || jc.e < jc.s || kc.e < kc.s) {
+        // Blocks too small to have a core.  The shell is then everything
+        if (region == FluxRegion::core) return TaskStatus::complete;
+        kc = IndexRange{0, -1};
+    }
+    // The core kernel runs over only the core rows.  Otherwise, rows in the core are split around it
+    const IndexRange jr = (region == FluxRegion::core) ? jc : jl;
+    const IndexRange kr = (region == FluxRegion::core) ? kc : kl;
+
     // Allocate scratch space
     const int scratch_level = 1; // 0 is actual scratch (tiny); 1 is HBM
-    const size_t var_size_in_bytes = parthenon::ScratchPad2D<Real>::shmem_size(nvar, n1);
+    const size_t var_size_in_bytes = parthenon::ScratchPad2D<FluxReal>::shmem_size(nvar, n1);
     const size_t speed_size_in_bytes = parthenon::ScratchPad2D<Real>::shmem_size(1, n1);
     // Allocate enough to cache prims, conserved, and fluxes, for left and right faces,
-    // plus temporaries inside reconstruction (most use 1, WENO5 uses none, linear_vl uses a bunch)
+    // plus temporaries inside reconstruction (most use 1, WENO5/PPM/MP5 use none, linear_vl uses a bunch)
     // Then add cmax and cmin!
-    const size_t total_scratch_bytes = (6 + 1*(Recon != ReconstructionType::weno5) +
+    const size_t total_scratch_bytes = (6 + 1*(!KReconstruction::is_stencil5(Recon)) +
                                             4*(Recon == ReconstructionType::linear_vl)) * var_size_in_bytes
                                         + 2 * speed_size_in_bytes;
 
@@ -184,151 +433,147 @@ inline TaskStatus GetFlux(MeshData<Real> *md)
     // This isn't a pmb0->par_for_outer because Parthenon's current overloaded definitions
     // do not accept three pairs of bounds, which we need in order to iterate over blocks
     parthenon::par_for_outer(DEFAULT_OUTER_LOOP_PATTERN, "calc_flux", pmb0->exec_space,
-        total_scratch_bytes, scratch_level, block.s, block.e, kl.s, kl.e, jl.s, jl.e,
+        total_scratch_bytes, scratch_level, block.s, block.e, kr.s, kr.e, jr.s, jr.e,
         KOKKOS_LAMBDA(parthenon::team_mbr_t member, const int& b, const int& k, const int& j) {
+            if (!steps.is_active(gid0 + b)) return;
             const auto& G = U_all.GetCoords(b);
-            ScratchPad2D<Real> Pl_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Pr_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Ul_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Ur_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Fl_s(member.team_scratch(scratch_level), nvar, n1);
-            ScratchPad2D<Real> Fr_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Pl_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Pr_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Ul_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Ur_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Fl_s(member.team_scratch(scratch_level), nvar, n1);
+            ScratchPad2D<FluxReal> Fr_s(member.team_scratch(scratch_level), nvar, n1);
             ScratchPad1D<Real> cmax(member.team_scratch(scratch_level), n1);
             ScratchPad1D<Real> cmin(member.team_scratch(scratch_level), n1);
 
-            // Wrapper for a big switch statement between reconstruction schemes. Possibly slow.
-            // This function is generally a lot of if statements
-            KReconstruction::reconstruct<Recon, dir>(member, G, P_all(b), k, j, il.s, il.e, Pl_s, Pr_s);
-
-            // Sync all threads in the team so that scratch memory is consistent
-            member.team_barrier();
-
-            // Calculate conserved fluxes at centers & faces
-            parthenon::par_for_inner(member, il.s, il.e,
-                [&](const int& i) {
-                    auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
-                    auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
-                    // Apply floors to the *reconstructed* primitives, because without TVD
-                    // we have no guarantee they remotely resemble the *centered* primitives
-                    if (Recon == ReconstructionType::weno5 && !disable_floors) {
-                        Floors::apply_geo_floors(G, Pl, m_p, gam, j, i, floors, loc);
-                        Floors::apply_geo_floors(G, Pr, m_p, gam, j, i, floors, loc);
-                    }
-#if !FUSE_FLUX_KERNELS
-                }
-            );
-            member.team_barrier();
-
-            // LEFT FACES, final ctop
-            parthenon::par_for_inner(member, il.s, il.e,
-                [&](const int& i) {
-                    auto Pl = Kokkos::subview(Pl_s, Kokkos::ALL(), i);
-#endif
-                    auto Ul = Kokkos::subview(Ul_s, Kokkos::ALL(), i);
-                    auto Fl = Kokkos::subview(Fl_s, Kokkos::ALL(), i);
-                    // LR -> flux
-                    // Declare temporary vectors
-                    FourVectors Dtmp;
-
-                    // Left
-                    GRMHD::calc_4vecs(G, Pl, m_p, j, i, loc, Dtmp);
-                    Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, 0, Ul, m_u, loc);
-                    Flux::prim_to_flux(G, Pl, m_p, Dtmp, emhd_params, gam, j, i, dir, Fl, m_u, loc);
+            // Only rows in the interior count toward the timestep.  Blocks of a MeshData are contiguous in lid
+            const int ctop_lid = (reduce_ctop && k >= kb.s && k <= kb.e && j >= jb.s && j <= jb.e) ? lid0 + b : -1;
 
-                    // Magnetosonic speeds
-                    Real cmaxL, cminL;
-                    Flux::vchar(G, Pl, m_p, Dtmp, gam, k, j, i, loc, dir, cmaxL, cminL);
-
-#if !FUSE_FLUX_KERNELS
-                    // Record speeds
-                    cmax(i) = max(0., cmaxL);
-                    cmin(i) = max(0., -cminL);
-                }
-            );
-            member.team_barrier();
-
-            // RIGHT FACES, final ctop
-            parthenon::par_for_inner(member, il.s, il.e,
-                [&](const int& i) {
-                    // LR -> flux
-                    // Declare temporary vectors
-                    FourVectors Dtmp;
-                    auto Pr = Kokkos::subview(Pr_s, Kokkos::ALL(), i);
-#endif
-                    auto Ur = Kokkos::subview(Ur_s, Kokkos::ALL(), i);
-                    auto Fr = Kokkos::subview(Fr_s, Kokkos::ALL(), i);
-                    // Right
-                    // TODO GRMHD/GRHD versions of this
-                    GRMHD::calc_4vecs(G, Pr, m_p, j, i, loc, Dtmp);
-                    Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, 0, Ur, m_u, loc);
-                    Flux::prim_to_flux(G, Pr, m_p, Dtmp, emhd_params, gam, j, i, dir, Fr, m_u, loc);
-
-                    // Magnetosonic speeds
-                    Real cmaxR, cminR;
-                    Flux::vchar(G, Pr, m_p, Dtmp, gam, k, j, i, loc, dir, cmaxR, cminR);
-
-#if FUSE_FLUX_KERNELS
-                    // Calculate cmax/min from local variables
-                    cmax(i) = fabs(max(cmaxL,  cmaxR));
-                    cmin(i) = fabs(max(-cminL, -cminR));
-
-                    if (use_hlle) {
-                        for (int p=0; p < nvar; ++p)
-                            U_all(b).flux(dir, p, k, j, i) = hlle(Fl(p), Fr(p), cmax(i), cmin(i), Ul(p), Ur(p));
-                    } else {
-                        for (int p=0; p < nvar; ++p)
-                            U_all(b).flux(dir, p, k, j, i) = llf(Fl(p), Fr(p), cmax(i), cmin(i), Ul(p), Ur(p));
-                    }
-                    if (use_b_cd) {
-                        // The unphysical variable psi and its corrections can propagate at the max speed
-                        // for the stepsize, rather than the sound speed
-                        // Since the speeds are the same it will always correspond to the LLF flux
-                        U_all(b).flux(dir, m_u.PSI, k, j, i) = llf(Fl(m_u.PSI), Fr(m_u.PSI), ctop_max, ctop_max, Ul(m_u.PSI), Ur(m_u.PSI));
-                        U_all(b).flux(dir, m_u.B1+dir-1, k, j, i) = llf(Fl(m_u.B1+dir-1), Fr(m_u.B1+dir-1), ctop_max, ctop_max, Ul(m_u.B1+dir-1), Ur(m_u.B1+dir-1));
-                    }
-#else
-                    // Calculate cmax/min based on comparison with cached values
-                    cmax(i) = fabs(max(cmax(i),  cmaxR));
-                    cmin(i) = fabs(max(cmin(i), -cminR));
-#endif
-                    // TODO is it faster to write ctop elsewhere?
-                    ctop(b, dir-1, k, j, i) = max(cmax(i), cmin(i));
-                }
-            );
-            member.team_barrier();
+            // Split the row into (at most two) segments of faces in the requested region
+            int nseg = 1;
+            int seg_s[2] = {il.s, 0}, seg_e[2] = {il.e, 0};
+            if (region == FluxRegion::core) {
+                seg_s[0] = ic.s; seg_e[0] = ic.e;
+            } else if (region == FluxRegion::shell && k >= kc.s && k <= kc.e && j >= jc.s && j <= jc.e) {
+                nseg = 2;
+                seg_e[0] = ic.s - 1;
+                seg_s[1] = ic.e + 1; seg_e[1] = il.e;
+            }
 
-#if !FUSE_FLUX_KERNELS
-            // Apply what we've calculated
-            for (int p=0; p < nvar; ++p) {
-                if (use_b_cd && (p == m_u.PSI || p == m_u.B1+dir-1)) {
-                    // The unphysical variable psi and its corrections can propagate at the max speed for the stepsize, rather than the sound speed
-                    // Since the speeds are the same it will always correspond to the LLF flux
-                    parthenon::par_for_inner(member, il.s, il.e,
-                        [&](const int& i) {
-                            U_all(b).flux(dir, p, k, j, i) = llf(Fl_s(p,i), Fr_s(p,i), ctop_max, ctop_max, Ul_s(p,i), Ur_s(p,i));
-                        }
-                    );
-                } else if (use_hlle) {
-                    // Option to try HLLE fluxes for everything else
-                    parthenon::par_for_inner(member, il.s, il.e,
-                        [&](const int& i) {
-                            U_all(b).flux(dir, p, k, j, i) = hlle(Fl_s(p,i), Fr_s(p,i), cmax(i), cmin(i), Ul_s(p,i), Ur_s(p,i));
-                        }
-                    );
-                } else {
-                    // Or LLF, probably safest option
-                    parthenon::par_for_inner(member, il.s, il.e,
-                        [&](const int& i) {
-                            U_all(b).flux(dir, p, k, j, i) = llf(Fl_s(p,i), Fr_s(p,i), cmax(i), cmin(i), Ul_s(p,i), Ur_s(p,i));
-                        }
-                    );
-                }
+            for (int s = 0; s < nseg; ++s) {
+                calc_flux_row<Recon, dir, Pkgs>(member, G, P_all(b), U_all(b), ctop, b, store_ctop, ctop_block, ctop_lid, ib,
+                                                m_p, m_u, emhd_params, floors.for_block(lid0 + b),
+                                                gam, ctop_max, use_hlle, disable_floors, nvar,
+                                                k, j, seg_s[s], seg_e[s], Pl_s, Pr_s, Ul_s, Ur_s, Fl_s, Fr_s, cmax, cmin);
             }
-#endif
         }
     );
 
     Flag(md, "Finished recon and flux");
     return TaskStatus::complete;
 }
+
+/**
+ * Add the flux calculation with a particular reconstruction and set of packages to a task list.
+ * See AddFluxCalculations.
+ */
+template <ReconstructionType Recon, int Pkgs>
+inline TaskID AddFluxTasks(TaskID& t_start, TaskID& t_ghosts, TaskList& tl, MeshData<Real> *md,
+                           bool split, int halo)
+{
+    // Name the timers of each direction & region separately, with the scheme in use,
+    // as these all share a function name, see TaskTiming
+    const std::string recon = ReconstructionName(Recon);
+    auto name = [&recon](const std::string& func, const std::string& dir, const std::string& region) {
+        return "Flux::" + func + "<" + recon + (dir.empty() ? "" : ", " + dir) + ">" + (region.empty() ? "" : " " + region);
+    };
+    if (split) {
+        // Core faces don't need the ghost zones, so they can go as soon as we start
+        auto t_core_flux1 = tl.AddTask(t_start, TIMED_AS(name("GetFlux", "X1DIR", "core"), Flux::GetFlux<Recon, X1DIR, Pkgs>), md, FluxRegion::core, halo);
+        auto t_core_flux2 = tl.AddTask(t_start, TIMED_AS(name("GetFlux", "X2DIR", "core"), Flux::GetFlux<Recon, X2DIR, Pkgs>), md, FluxRegion::core, halo);
+        auto t_core_flux3 = tl.AddTask(t_start, TIMED_AS(name("GetFlux", "X3DIR", "core"), Flux::GetFlux<Recon, X3DIR, Pkgs>), md, FluxRegion::core, halo);
+        auto t_core_flux = t_core_flux1 | t_core_flux2 | t_core_flux3;
+        auto t_shell_flux1 = tl.AddTask(t_core_flux | t_ghosts, TIMED_AS(name("GetFlux", "X1DIR", "shell"), Flux::GetFlux<Recon, X1DIR, Pkgs>), md, FluxRegion::shell, halo);
+        auto t_shell_flux2 = tl.AddTask(t_core_flux | t_ghosts, TIMED_AS(name("GetFlux", "X2DIR", "shell"), Flux::GetFlux<Recon, X2DIR, Pkgs>), md, FluxRegion::shell, halo);
+        auto t_shell_flux3 = tl.AddTask(t_core_flux | t_ghosts, TIMED_AS(name("GetFlux", "X3DIR", "shell"), Flux::GetFlux<Recon, X3DIR, Pkgs>), md, FluxRegion::shell, halo);
+        return t_shell_flux1 | t_shell_flux2 | t_shell_flux3;
+    } else {
+        auto t_calculate_flux1 = tl.AddTask(t_start | t_ghosts, TIMED_AS(name("GetFlux", "X1DIR", ""), Flux::GetFlux<Recon, X1DIR, Pkgs>), md, FluxRegion::all, halo);
+        auto t_calculate_flux2 = tl.AddTask(t_start | t_ghosts, TIMED_AS(name("GetFlux", "X2DIR", ""), Flux::GetFlux<Recon, X2DIR, Pkgs>), md, FluxRegion::all, halo);
+        auto t_calculate_flux3 = tl.AddTask(t_start | t_ghosts, TIMED_AS(name("GetFlux", "X3DIR", ""), Flux::GetFlux<Recon, X3DIR, Pkgs>), md, FluxRegion::all, halo);
+        return t_calculate_flux1 | t_calculate_flux2 | t_calculate_flux3;
+    }
+}
+
+/**
+ * Add the flux calculation with a particular reconstruction to a task list,
+ * dispatching to a version specialized for the loaded packages if possible.
+ */
+template <ReconstructionType Recon>
+inline TaskID AddSpecializedFluxTasks(TaskID& t_start, TaskID& t_ghosts, TaskList& tl, MeshData<Real> *md,
+                                      bool split, int halo)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    switch (SpecializedPackageSet(pmb0->packages)) {
+#if SPECIALIZE_PACKAGES
+    case PackageSet::grhd:
+        return AddFluxTasks<Recon, PackageSet::grhd>(t_start, t_ghosts, tl, md, split, halo);
+    case PackageSet::b_field:
+        return AddFluxTasks<Recon, PackageSet::b_field>(t_start, t_ghosts, tl, md, split, halo);
+    case PackageSet::b_field | PackageSet::electrons:
+        return AddFluxTasks<Recon, PackageSet::b_field | PackageSet::electrons>(t_start, t_ghosts, tl, md, split, halo);
+    case PackageSet::b_field | PackageSet::b_cd:
+        return AddFluxTasks<Recon, PackageSet::b_field | PackageSet::b_cd>(t_start, t_ghosts, tl, md, split, halo);
+#endif
+    default:
+        return AddFluxTasks<Recon, PackageSet::runtime>(t_start, t_ghosts, tl, md, split, halo);
+    }
+}
+
+/**
+ * Add the flux calculation to a task list, for whichever reconstruction scheme is in use.
+ * Adds one GetFlux task per direction.
+ *
+ * If t_ghosts is given, it should complete when the ghost zones of md are filled.  The fluxes through
+ * core faces, which don't need ghost zones, are then calculated first, after only t_start.
+ *
+ * With halo > 0, fluxes are also calculated for that many extra rows of ghost faces in every
+ * direction, so that the update can be taken in the ghost zones too (see perf/deep_halo).
+ * This needs the ghost zones up front, so it isn't combined with splitting.
+ *
+ * This is used identically in both drivers, so it makes sense to define it once here.
+ *
+ * @return a TaskID which completes when fluxes in all directions are calculated
+ */
+inline TaskID AddFluxCalculations(TaskID& t_start, TaskID& t_ghosts, TaskList& tl, MeshData<Real> *md, bool split=true,
+                                  int halo=0)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const auto& pars = pmb0->packages.Get("GRMHD")->AllParams();
+    const ReconstructionType recon = pars.Get<ReconstructionType>("recon");
+
+    switch (recon) {
+    case ReconstructionType::donor_cell:
+        return AddSpecializedFluxTasks<ReconstructionType::donor_cell>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::linear_mc:
+        return AddSpecializedFluxTasks<ReconstructionType::linear_mc>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::linear_vl:
+        return AddSpecializedFluxTasks<ReconstructionType::linear_vl>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::weno5:
+        return AddSpecializedFluxTasks<ReconstructionType::weno5>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::ppm:
+        return AddSpecializedFluxTasks<ReconstructionType::ppm>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::mp5:
+        return AddSpecializedFluxTasks<ReconstructionType::mp5>(t_start, t_ghosts, tl, md, split, halo);
+    case ReconstructionType::weno5_lower_poles:
+    default:
+        cerr << "Reconstruction type not supported!  Supported reconstructions:" << endl;
+        cerr << "donor_cell, linear_mc, linear_vl, ppm, mp5, weno5" << endl;
+        throw std::invalid_argument("Unsupported reconstruction algorithm!");
+    }
+}
+inline TaskID AddFluxCalculations(TaskID& t_start, TaskList& tl, MeshData<Real> *md, int halo=0)
+{
+    return AddFluxCalculations(t_start, t_start, tl, md, false, halo);
+}
 }
@@ -48,12 +48,12 @@
 namespace Flux
 {
 
-template<typename Local>
+template<int Pkgs=PackageSet::runtime, typename Local>
 KOKKOS_INLINE_FUNCTION void calc_tensor(const GRCoordinates& G, const Local& P, const VarMap& m_p, const FourVectors D,
                                         const EMHD::EMHD_parameters& emhd_params, const Real& gam, const int& dir,
                                         Real T[GR_DIM])
 {
-    if (m_p.Q >= 0) {
+    if (has_emhd<Pkgs>(m_p)) {
         // EGRMHD stress-energy tensor w/ first index up, second index down
         // Get problem closure parameters
         Real tau, chi_e, nu_e;
@@ -66,7 +66,7 @@ KOKKOS_INLINE_FUNCTION void calc_tensor(const GRCoordinates& G, const Local& P,
 
         // Then calculate the tensor
         EMHD::calc_tensor(P(m_p.RHO), P(m_p.UU), (gam - 1) * P(m_p.UU), q, dP, D, dir, T);
-    } else if (m_p.B1 >= 0) {
+    } else if (has_b<Pkgs>(m_p)) {
         // GRMHD stress-energy tensor w/ first index up, second index down
         GRMHD::calc_tensor(P(m_p.RHO), P(m_p.UU), (gam - 1) * P(m_p.UU), D, dir, T);
     } else {
@@ -108,8 +108,9 @@ KOKKOS_INLINE_FUNCTION void calc_tensor(const GRCoordinates& G, const Global& P,
  * a. conserved variables (dir==0), or
  * b. fluxes in a direction (dir!=0)
  * Keep in mind loc should usually correspond to dir for perpendicuar fluxes
+ * Optionally templated on the set of packages in use, see PackageSet in types.hpp
  */
-template<typename Local>
+template<int Pkgs=PackageSet::runtime, typename Local>
 KOKKOS_INLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Local& P, const VarMap& m_p, const FourVectors D,
                                          const EMHD::EMHD_parameters& emhd_params, const Real& gam, const int& j, const int& i, const int& dir,
                                          const Local& flux, const VarMap& m_u, const Loci loc=Loci::center)
@@ -120,14 +121,14 @@ KOKKOS_INLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Local& P,
 
     // Stress-energy tensor
     Real T[GR_DIM];
-    calc_tensor(G, P, m_p, D, emhd_params, gam, dir, T);
+    calc_tensor<Pkgs>(G, P, m_p, D, emhd_params, gam, dir, T);
     flux(m_u.UU) = T[0] * gdet + flux(m_u.RHO);
     flux(m_u.U1) = T[1] * gdet;
     flux(m_u.U2) = T[2] * gdet;
     flux(m_u.U3) = T[3] * gdet;
 
     // Magnetic field
-    if (m_p.B1 >= 0) {
+    if (has_b<Pkgs>(m_p)) {
         // Magnetic field
         if (dir == 0) {
             VLOOP flux(m_u.B1 + v) = P(m_p.B1 + v) * gdet;
@@ -137,7 +138,7 @@ KOKKOS_INLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Local& P,
             VLOOP flux(m_u.B1 + v) = (D.bcon[v+1] * D.ucon[dir] - D.bcon[dir] * D.ucon[v+1]) * gdet;
         }
         // Extra scalar psi for constraint damping, see B_CD
-        if (m_p.PSI >= 0) {
+        if (has_psi<Pkgs>(m_p)) {
             if (dir == 0) {
                 flux(m_u.PSI) = P(m_p.PSI) * gdet;
             } else {
@@ -150,13 +151,13 @@ KOKKOS_INLINE_FUNCTION void prim_to_flux(const GRCoordinates& G, const Local& P,
     }
 
     // EMHD Variables: advect like rho
-    if (m_p.Q >= 0) {
+    if (has_emhd<Pkgs>(m_p)) {
         flux(m_u.Q) = P(m_p.Q) * D.ucon[dir] * gdet;
         flux(m_u.DP) = P(m_p.DP) * D.ucon[dir] * gdet;
     }
 
     // Electrons: normalized by density
-    if (m_p.KTOT >= 0) {
+    if (has_electrons<Pkgs>(m_p)) {
         flux(m_u.KTOT) = flux(m_u.RHO) * P(m_p.KTOT);
         if (m_p.K_CONSTANT >= 0)
             flux(m_u.K_CONSTANT) = flux(m_u.RHO) * P(m_p.K_CONSTANT);
@@ -191,7 +192,7 @@ KOKKOS_INLINE_FUNCTION void p_to_u(const GRCoordinates& G, const Local& P, const
  * Calculate components of magnetosonic velocity from primitive variables
  * This is only called in GetFlux, so we only provide a ScratchPad form
  */
-template<typename Local>
+template<int Pkgs=PackageSet::runtime, typename Local>
 KOKKOS_INLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, const VarMap& m, const FourVectors& D,
                                   const Real& gam, const int& k, const int& j, const int& i, const Loci& loc, const int& dir,
                                   Real& cmax, Real& cmin)
@@ -200,7 +201,7 @@ KOKKOS_INLINE_FUNCTION void vchar(const GRCoordinates& G, const Local& P, const
     const Real ef = P(m.RHO) + gam * P(m.UU);
     const Real cs2 = gam * (gam - 1) * P(m.UU) / ef;
     Real cms2;
-    if (m.B1 >= 0) {
+    if (has_b<Pkgs>(m)) {
         // Find fast magnetosonic speed
         const Real bsq = max(dot(D.bcon, D.bcov), SMALL);
         const Real ee = bsq + ef;
@@ -36,6 +36,7 @@
 #include "decs.hpp"
 
 #include "kharma_utils.hpp"
+#include "simd.hpp"
 
 // Accuracy required for U to P
 #define UTOP_ERRTOL 1.e-8
@@ -43,6 +44,12 @@
 #define UTOP_ITER_MAX 8
 // Heuristic step size
 #define DELTA 1e-5
+// Zones per batch in u_to_p_batch: by default one vector of the target's SIMD width (see simd.hpp),
+// so that each lane of the batched solve is one vector lane.  Set with the CMake option UTOP_BATCH,
+// e.g. to a multiple of the width to keep more independent iterations in flight
+#ifndef UTOP_BATCH
+#define UTOP_BATCH KHARMA_SIMD_WIDTH
+#endif
 
 namespace GRMHD {
 
@@ -52,18 +59,15 @@ KOKKOS_INLINE_FUNCTION Real lorentz_calc_w(const Real& Bsq, const Real& D, const
                                         const Real& Qtsq, const Real& Wp);
 
 /**
- * Recover local primitive variables, with a one-dimensional Newton-Raphson iterative solver
- * Iteration starts from the current primitive values
- * 
- * Returns a code indicating whether the solver converged (success), failed (max_iter), or
- * indicating that the converged solution was unphysical (bad_ut, neg_rhou, neg_rho, neg_u)
- * 
- * On error, will not write replacement values, leaving the previous step's values in place
- * These are fixed later, in FixUtoP
+ * The pieces of the inversion below, which u_to_p and u_to_p_batch string together.
+ *
+ * u_to_p_setup: convert a zone's conserved variables to the scalars the root-finding works with,
+ * D, Bsq, QdB, Qtsq & Ep, plus the vectors Qtcon & Bcon needed to recover the velocity at the end
  */
-KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
-                                              const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
-                                              const VariablePack<Real>& P, const VarMap& m_p)
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_setup(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                    const int& k, const int& j, const int& i, const Loci loc,
+                                                    Real& D, Real& Bsq, Real& QdB, Real& Qtsq, Real& Ep,
+                                                    Real Qtcon[GR_DIM], Real Bcon[GR_DIM])
 {
     // Catch negative density
     if (U(m_u.RHO, k, j, i) <= 0.) {
@@ -74,9 +78,9 @@ KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const Vari
     const Real alpha = 1./sqrt(-G.gcon(loc, j, i, 0, 0));
     const Real gdet = G.gdet(loc, j, i);
     const Real a_over_g = alpha / gdet;
-    const Real D = U(m_u.RHO, k, j, i) * a_over_g;
+    D = U(m_u.RHO, k, j, i) * a_over_g;
 
-    Real Bcon[GR_DIM] = {0};
+    DLOOP1 Bcon[mu] = 0.;
     if (m_u.B1 >= 0) {
         Bcon[1] = U(m_u.B1, k, j, i) * a_over_g;
         Bcon[2] = U(m_u.B2, k, j, i) * a_over_g;
@@ -97,32 +101,43 @@ KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const Vari
     G.raise(Qcov, Qcon, k, j, i, loc);
     G.raise(ncov, ncon, k, j, i, loc);
 
-    const Real Bsq = dot(Bcon, Bcov);
-    const Real QdB = dot(Bcon, Qcov);
+    Bsq = dot(Bcon, Bcov);
+    QdB = dot(Bcon, Qcov);
     const Real Qdotn = dot(Qcon, ncov);
 
-    Real Qtcon[GR_DIM];
     DLOOP1 Qtcon[mu] = Qcon[mu] + ncon[mu] * Qdotn;
-    const Real Qtsq = dot(Qcon, Qcov) + pow(Qdotn, 2);
+    Qtsq = dot(Qcon, Qcov) + pow(Qdotn, 2);
 
     // Set up eqtn for W'; this is the energy density
-    const Real Ep = -Qdotn - D;
+    Ep = -Qdotn - D;
 
-    // Numerical rootfinding
+    return InversionStatus::success;
+}
 
-    // Accumulator for errors in err_eqn
-    InversionStatus eflag = InversionStatus::success;
+/**
+ * u_to_p_guess: initial guess for W' from the current primitives
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_guess(const GRCoordinates &G, const VariablePack<Real>& P, const VarMap& m_p,
+                                                    const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                    Real& Wp)
+{
+    const Real gamma = GRMHD::lorentz_calc(G, P, m_p, k, j, i, loc);
+    if (gamma < 1) return InversionStatus::bad_ut;
+    const Real rho = P(m_p.RHO, k, j, i), u = P(m_p.UU, k, j, i);
 
-    // Initial guess from primitives:
-    Real Wp, err;
-    {
-        const Real gamma = GRMHD::lorentz_calc(G, P, m_p, k, j, i, loc);
-        if (gamma < 1) return InversionStatus::bad_ut;
-        const Real rho = P(m_p.RHO, k, j, i), u = P(m_p.UU, k, j, i);
+    Wp = (rho + u + (gam - 1) * u) * gamma * gamma - rho * gamma;
+    return InversionStatus::success;
+}
 
-        Wp = (rho + u + (gam - 1) * u) * gamma * gamma - rho * gamma;
-        err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
-    }
+/**
+ * u_to_p_first_step: evaluate the error at the guess Wp, then take a Halley step from it.
+ * Leaves the new & previous points in Wp/err and Wp1/err1, ready for the secant iterations
+ */
+KOKKOS_INLINE_FUNCTION void u_to_p_first_step(const Real& gam, const Real& Bsq, const Real& D, const Real& Ep,
+                                              const Real& QdB, const Real& Qtsq, Real& Wp, Real& err,
+                                              Real& Wp1, Real& err1, InversionStatus& eflag)
+{
+    err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
 
     Real dW;
     {
@@ -143,34 +158,41 @@ KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const Vari
     }
 
     // Take the first step
-    Real Wp1 = Wp;
-    Real err1 = err;
+    Wp1 = Wp;
+    err1 = err;
     Wp += dW;
     err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
+}
 
-    // Not good enough?  apply secant method
-    int iter = 0;
-    for (iter = 0; iter < UTOP_ITER_MAX; iter++)
-    {
-        dW = clip((Wp1 - Wp) * err / (err - err1), (Real) -0.5*Wp, (Real) 2.0*Wp);
+/**
+ * u_to_p_secant_step: one secant iteration.  Returns true once converged
+ */
+KOKKOS_INLINE_FUNCTION bool u_to_p_secant_step(const Real& gam, const Real& Bsq, const Real& D, const Real& Ep,
+                                               const Real& QdB, const Real& Qtsq, Real& Wp, Real& err,
+                                               Real& Wp1, Real& err1, InversionStatus& eflag)
+{
+    const Real dW = clip((Wp1 - Wp) * err / (err - err1), (Real) -0.5*Wp, (Real) 2.0*Wp);
 
-        Wp1 = Wp;
-        err1 = err;
+    Wp1 = Wp;
+    err1 = err;
 
-        Wp += dW;
+    Wp += dW;
 
-        if (fabs(dW / Wp) < UTOP_ERRTOL) break;
+    if (fabs(dW / Wp) < UTOP_ERRTOL) return true;
 
-        err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
+    err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
 
-        if (fabs(err / Wp) < UTOP_ERRTOL) break;
-    }
-    // If there was a bad gamma calculation, do not set primitives other than B
-    // Uncomment to error on any bad velocity.  iharm2d/3d do not do this.
-    //if (eflag) return eflag;
-    // Return failure to converge
-    if (iter == UTOP_ITER_MAX) return InversionStatus::max_iter;
+    return fabs(err / Wp) < UTOP_ERRTOL;
+}
 
+/**
+ * u_to_p_finish: recover & write the primitives from the converged W'
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_finish(const Real& gam, const Real& Bsq, const Real& D, const Real& QdB,
+                                                     const Real& Qtsq, const Real& Wp, const Real Qtcon[GR_DIM],
+                                                     const Real Bcon[GR_DIM], const int& k, const int& j, const int& i,
+                                                     const VariablePack<Real>& P, const VarMap& m_p)
+{
     // Find utsq, gamma, rho from Wp
     const Real gamma = lorentz_calc_w(Bsq, D, QdB, Qtsq, Wp);
     if (gamma < 1) return InversionStatus::bad_ut;
@@ -199,6 +221,197 @@ KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const Vari
     return InversionStatus::success;
 }
 
+/**
+ * Recover local primitive variables, with a one-dimensional Newton-Raphson iterative solver
+ * Iteration starts from the current primitive values
+ * 
+ * Returns a code indicating whether the solver converged (success), failed (max_iter), or
+ * indicating that the converged solution was unphysical (bad_ut, neg_rhou, neg_rho, neg_u)
+ * 
+ * On error, will not write replacement values, leaving the previous step's values in place
+ * These are fixed later, in FixUtoP
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                              const VariablePack<Real>& P, const VarMap& m_p, int& niter)
+{
+    niter = 0;
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    InversionStatus status = u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon);
+    if (status != InversionStatus::success) return status;
+
+    // Numerical rootfinding
+
+    // Accumulator for errors in err_eqn
+    InversionStatus eflag = InversionStatus::success;
+
+    // Initial guess from primitives, and a first step
+    Real Wp, err, Wp1, err1;
+    status = u_to_p_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+    if (status != InversionStatus::success) return status;
+    u_to_p_first_step(gam, Bsq, D, Ep, QdB, Qtsq, Wp, err, Wp1, err1, eflag);
+
+    // Not good enough?  apply secant method
+    int iter = 0;
+    for (iter = 0; iter < UTOP_ITER_MAX; iter++)
+    {
+        if (u_to_p_secant_step(gam, Bsq, D, Ep, QdB, Qtsq, Wp, err, Wp1, err1, eflag)) break;
+    }
+    // Count the first step along with the secant steps
+    niter = 1 + ((iter < UTOP_ITER_MAX) ? iter + 1 : iter);
+    // If there was a bad gamma calculation, do not set primitives other than B
+    // Uncomment to error on any bad velocity.  iharm2d/3d do not do this.
+    //if (eflag) return eflag;
+    // Return failure to converge
+    if (iter == UTOP_ITER_MAX) return InversionStatus::max_iter;
+
+    return u_to_p_finish(gam, Bsq, D, QdB, Qtsq, Wp, Qtcon, Bcon, k, j, i, P, m_p);
+}
+// Version without an iteration count
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                              const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                              const VariablePack<Real>& P, const VarMap& m_p)
+{
+    int niter;
+    return u_to_p(G, U, m_u, gam, k, j, i, loc, P, m_p, niter);
+}
+
+/**
+ * Version of u_to_p starting from the W' of a previous solve, Wp_cache, used with perf/cache_wp.
+ * If Wp_cache is positive, this skips the guess from the primitives and the first (Halley) step: if the
+ * cached W' still solves the system it is used directly, otherwise the secant iterations start from it.
+ * Otherwise this proceeds exactly as u_to_p.
+ * Updates Wp_cache with the solution, or resets it to zero on failure
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_cached(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                     const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                     const VariablePack<Real>& P, const VarMap& m_p, Real& Wp_cache, int& niter)
+{
+    niter = 0;
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    InversionStatus status = u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon);
+    if (status != InversionStatus::success) {
+        Wp_cache = 0.;
+        return status;
+    }
+
+    InversionStatus eflag = InversionStatus::success;
+    Real Wp, err, Wp1, err1;
+    bool converged = false;
+    if (Wp_cache > 0.) {
+        // Start from the cached W', with a second point nearby for the first secant step
+        Wp = Wp_cache;
+        err = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
+        converged = fabs(err / Wp) < UTOP_ERRTOL;
+        Wp1 = (1. + DELTA) * Wp;
+        err1 = err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp1, eflag);
+    } else {
+        status = u_to_p_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+        if (status != InversionStatus::success) {
+            Wp_cache = 0.;
+            return status;
+        }
+        u_to_p_first_step(gam, Bsq, D, Ep, QdB, Qtsq, Wp, err, Wp1, err1, eflag);
+        niter = 1;
+    }
+
+    if (!converged) {
+        int iter = 0;
+        for (iter = 0; iter < UTOP_ITER_MAX; iter++)
+        {
+            if (u_to_p_secant_step(gam, Bsq, D, Ep, QdB, Qtsq, Wp, err, Wp1, err1, eflag)) break;
+        }
+        niter += (iter < UTOP_ITER_MAX) ? iter + 1 : iter;
+        if (iter == UTOP_ITER_MAX) {
+            Wp_cache = 0.;
+            return InversionStatus::max_iter;
+        }
+    }
+
+    status = u_to_p_finish(gam, Bsq, D, QdB, Qtsq, Wp, Qtcon, Bcon, k, j, i, P, m_p);
+    Wp_cache = (status == InversionStatus::success) ? Wp : 0.;
+    return status;
+}
+
+/**
+ * Batched version of u_to_p, for N consecutive zones of a row starting at i0, used with perf/batch_utop.
+ * Zones with active[l] false are skipped, and their status[l] left as success.
+ *
+ * Each zone's inputs are gathered into arrays by lane, and the secant iterations run over all lanes
+ * together, with lanes which have converged masked off rather than branching out.  This lets CPU compilers
+ * vectorize the iterations, which are the bulk of the work.  Every lane performs exactly the operations of
+ * u_to_p in the same order, so results are bitwise identical unless the compiler contracts or vectorizes
+ * them differently from the scalar loop (see tests/perf_identity).  On GPUs the scalar version is preferable.
+ */
+template<int N>
+KOKKOS_INLINE_FUNCTION void u_to_p_batch(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                         const Real& gam, const int& k, const int& j, const int& i0, const Loci loc,
+                                         const VariablePack<Real>& P, const VarMap& m_p,
+                                         const bool active[N], InversionStatus status[N])
+{
+    // Inputs & state by lane.  Lanes not iterating keep these harmless values
+    Real D[N], Bsq[N], QdB[N], Qtsq[N], Ep[N], Qtcon[GR_DIM][N], Bcon[GR_DIM][N];
+    Real Wp[N], err[N], Wp1[N], err1[N];
+    bool done[N];
+    InversionStatus eflag = InversionStatus::success;
+    for (int l = 0; l < N; ++l) {
+        D[l] = 1.; Bsq[l] = 0.; QdB[l] = 0.; Qtsq[l] = 0.; Ep[l] = 1.;
+        Wp[l] = 1.; err[l] = 1.; Wp1[l] = 2.; err1[l] = 2.;
+        status[l] = InversionStatus::success;
+        done[l] = true;
+        if (!active[l]) continue;
+
+        const int i = i0 + l;
+        Real Qtcon_l[GR_DIM], Bcon_l[GR_DIM];
+        status[l] = u_to_p_setup(G, U, m_u, k, j, i, loc, D[l], Bsq[l], QdB[l], Qtsq[l], Ep[l], Qtcon_l, Bcon_l);
+        if (status[l] != InversionStatus::success) continue;
+        DLOOP1 {
+            Qtcon[mu][l] = Qtcon_l[mu];
+            Bcon[mu][l] = Bcon_l[mu];
+        }
+        status[l] = u_to_p_guess(G, P, m_p, gam, k, j, i, loc, Wp[l]);
+        if (status[l] != InversionStatus::success) continue;
+        u_to_p_first_step(gam, Bsq[l], D[l], Ep[l], QdB[l], Qtsq[l], Wp[l], err[l], Wp1[l], err1[l], eflag);
+        done[l] = false;
+    }
+
+    // Secant iterations, as u_to_p_secant_step over every lane, keeping the results only for lanes
+    // which haven't converged.  Lanes leaving the loop unconverged have hit UTOP_ITER_MAX
+    bool converged[N];
+    for (int l = 0; l < N; ++l) converged[l] = done[l];
+    for (int iter = 0; iter < UTOP_ITER_MAX; iter++) {
+        int nleft = 0;
+        for (int l = 0; l < N; ++l) {
+            InversionStatus eflag_l = InversionStatus::success;
+            const Real dW = clip((Wp1[l] - Wp[l]) * err[l] / (err[l] - err1[l]), (Real) -0.5*Wp[l], (Real) 2.0*Wp[l]);
+            const Real Wp_new = Wp[l] + dW;
+            const bool converged_dW = fabs(dW / Wp_new) < UTOP_ERRTOL;
+            const Real err_new = err_eqn(gam, Bsq[l], D[l], Ep[l], QdB[l], Qtsq[l], Wp_new, eflag_l);
+            const bool converged_err = fabs(err_new / Wp_new) < UTOP_ERRTOL;
+
+            const bool live = !converged[l];
+            Wp1[l] = live ? Wp[l] : Wp1[l];
+            err1[l] = live ? err[l] : err1[l];
+            Wp[l] = live ? Wp_new : Wp[l];
+            err[l] = (live && !converged_dW) ? err_new : err[l];
+            converged[l] = converged[l] || converged_dW || converged_err;
+            nleft += !converged[l];
+        }
+        if (nleft == 0) break;
+    }
+
+    for (int l = 0; l < N; ++l) {
+        if (done[l]) continue;
+        if (!converged[l]) {
+            status[l] = InversionStatus::max_iter;
+            continue;
+        }
+        const Real Qtcon_l[GR_DIM] = {Qtcon[0][l], Qtcon[1][l], Qtcon[2][l], Qtcon[3][l]};
+        const Real Bcon_l[GR_DIM] = {Bcon[0][l], Bcon[1][l], Bcon[2][l], Bcon[3][l]};
+        status[l] = u_to_p_finish(gam, Bsq[l], D[l], QdB[l], Qtsq[l], Wp[l], Qtcon_l, Bcon_l, k, j, i0 + l, P, m_p);
+    }
+}
+
 // Document this
 KOKKOS_INLINE_FUNCTION Real err_eqn(const Real& gam, const Real& Bsq, const Real& D, const Real& Ep, const Real& QdB,
                                     const Real& Qtsq, const Real& Wp, InversionStatus& eflag)
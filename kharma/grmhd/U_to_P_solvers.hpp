@@ -0,0 +1,403 @@
+/* 
+ *  File: U_to_P_solvers.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include "kharma_utils.hpp"
+#include "U_to_P.hpp"
+
+// Largest v^2 allowed the 2D solver, matching the limit on u~^2 in lorentz_calc_w
+#define UTOP_VSQ_MAX (1. - 1.e-7)
+
+/**
+ * Alternative primitive recovery algorithms, selected with GRMHD/inverter.  All solve the same system
+ * as u_to_p, starting from u_to_p_setup, and write the primitives with u_to_p_finish, so they differ
+ * only in how they find the root W' and so in their cost & robustness. Returned status codes are the same.
+ *
+ * twod: Noble et al. (2006) "2D" scheme, Newton-Raphson in W and v^2 together
+ * palenzuela: Palenzuela et al. (2015), Brent's method in x = W/D, bracketed in [1+q-s, 2+2q-s]
+ * kastaun: Kastaun et al. (2021), Brent's method in mu = 1/(h gamma), bracketed in (0, 1]
+ *
+ * The two bracketed methods cannot start from a bad guess, and so are the most robust at high
+ * magnetization & Lorentz factor, where onedw most often fails.
+ * See tests/performance/inversion.sh for a benchmark comparing the solvers.
+ */
+namespace GRMHD {
+
+/**
+ * Inversion options, from the GRMHD package parameters.
+ * The default "onedw" solver, u_to_p, uses the compile-time UTOP_ERRTOL and UTOP_ITER_MAX instead,
+ * so that its results don't change.
+ */
+class InversionSettings {
+    public:
+        InversionType type;
+        Real tol;
+        int iter_max;
+        // Retry failures with u_to_p_entropy
+        bool entropy_fallback;
+        // Start from each zone's previous W' with u_to_p_cached, and record iteration counts
+        bool cache_wp, histogram;
+
+        InversionSettings(const parthenon::Params& params)
+        {
+            type = params.Get<InversionType>("inverter");
+            tol = params.Get<Real>("inverter_tol");
+            iter_max = params.Get<int>("inverter_iter_max");
+            entropy_fallback = params.Get<bool>("entropy_fallback");
+            cache_wp = params.Get<bool>("cache_wp");
+            histogram = params.Get<bool>("utop_histogram");
+        }
+};
+
+/**
+ * Brent's method for the root of f in [a, b], after Numerical Recipes' zbrent.
+ * Returns max_iter if f doesn't change sign over the bracket, or if the root isn't found in iter_max evaluations
+ */
+template<typename Function>
+KOKKOS_INLINE_FUNCTION InversionStatus brent_root(const Function& f, Real a, Real b, const Real& tol, const int& iter_max,
+                                                  Real& root, int& niter)
+{
+    Real fa = f(a), fb = f(b);
+    niter = 0;
+    if (fa * fb > 0.) return InversionStatus::max_iter;
+
+    Real c = b, fc = fb;
+    Real d = b - a, e = d;
+    for (niter = 1; niter <= iter_max; ++niter) {
+        if (fb * fc > 0.) {
+            // Root is between a & b: rename a -> c, and reset the step lengths
+            c = a; fc = fa;
+            d = b - a; e = d;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            // Keep the best guess in b
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+        const Real tol1 = 0.5 * tol * fabs(b);
+        const Real xm = 0.5 * (c - b);
+        if (fabs(xm) <= tol1 || fb == 0.) {
+            root = b;
+            return InversionStatus::success;
+        }
+        if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+            // Inverse quadratic interpolation, or secant if only two points are distinct
+            const Real s = fb / fa;
+            Real p, q;
+            if (a == c) {
+                p = 2. * xm * s;
+                q = 1. - s;
+            } else {
+                const Real qa = fa / fc, r = fb / fc;
+                p = s * (2. * xm * qa * (qa - r) - (b - a) * (r - 1.));
+                q = (qa - 1.) * (r - 1.) * (s - 1.);
+            }
+            if (p > 0.) q = -q;
+            p = fabs(p);
+            if (2. * p < min(3. * xm * q - fabs(tol1 * q), fabs(e * q))) {
+                // Accept the interpolation
+                e = d;
+                d = p / q;
+            } else {
+                // Fall back to bisection
+                d = xm;
+                e = d;
+            }
+        } else {
+            // Bounds shrinking too slowly, bisect
+            d = xm;
+            e = d;
+        }
+        a = b;
+        fa = fb;
+        b += (fabs(d) > tol1) ? d : ((xm > 0.) ? tol1 : -tol1);
+        fb = f(b);
+    }
+    return InversionStatus::max_iter;
+}
+
+/**
+ * Noble et al. (2006) 2D scheme: Newton-Raphson in (W, v^2), using the energy & momentum
+ * equations directly rather than eliminating v^2 as onedw does.
+ * Steps in W are limited as in u_to_p, and v^2 is kept in [0, UTOP_VSQ_MAX]
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_twod(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                   const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                   const VariablePack<Real>& P, const VarMap& m_p,
+                                                   const Real& tol, const int& iter_max, int& niter)
+{
+    niter = 0;
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    InversionStatus status = u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon);
+    if (status != InversionStatus::success) return status;
+
+    // Initial guess from primitives, as u_to_p
+    Real Wp;
+    status = u_to_p_guess(G, P, m_p, gam, k, j, i, loc, Wp);
+    if (status != InversionStatus::success) return status;
+    const Real gamma = GRMHD::lorentz_calc(G, P, m_p, k, j, i, loc);
+    Real W = Wp + D;
+    Real vsq = clip(1. - 1. / (gamma * gamma), 0., UTOP_VSQ_MAX);
+
+    const Real Qdotn = -(Ep + D);
+    const Real QdBsq = QdB * QdB;
+    const Real pfac = (gam - 1.) / gam;
+    for (niter = 1; niter <= iter_max; ++niter) {
+        const Real BW = Bsq + W;
+        const Real W2 = W * W;
+        const Real W3 = W2 * W;
+        const Real sqv = sqrt(1. - vsq);
+        const Real p = pfac * (W * (1. - vsq) - D * sqv);
+
+        // Residuals of the momentum & energy equations, Noble et al. eqs. 28 & 29
+        const Real f1 = Qtsq - vsq * BW * BW + QdBsq * (Bsq + 2. * W) / W2;
+        const Real f2 = Qdotn + W - p + 0.5 * Bsq * (1. + vsq) - 0.5 * QdBsq / W2;
+
+        // Jacobian
+        const Real df1dW = -2. * vsq * BW - 2. * QdBsq * BW / W3;
+        const Real df1dv = -BW * BW;
+        const Real df2dW = 1. + QdBsq / W3 - pfac * (1. - vsq);
+        const Real df2dv = 0.5 * Bsq - pfac * (-W + 0.5 * D / sqv);
+        const Real det = df1dW * df2dv - df1dv * df2dW;
+
+        const Real dW = -(df2dv * f1 - df1dv * f2) / det;
+        const Real dv = -(-df2dW * f1 + df1dW * f2) / det;
+
+        const Real W_new = W + clip(dW, -0.5 * W, 2.0 * W);
+        const Real vsq_new = clip(vsq + dv, 0., UTOP_VSQ_MAX);
+        const Real errx = fabs((W_new - W) / W) + fabs(vsq_new - vsq);
+        W = W_new;
+        vsq = vsq_new;
+        if (errx < tol) break;
+    }
+    if (niter > iter_max) {
+        niter = iter_max;
+        return InversionStatus::max_iter;
+    }
+
+    return u_to_p_finish(gam, Bsq, D, QdB, Qtsq, W - D, Qtcon, Bcon, k, j, i, P, m_p);
+}
+
+/**
+ * Master function of Palenzuela et al. (2015), in the notation of Siegel et al. (2018) sec. 3.3:
+ * f(x) = x - h gamma, for x = W/D and normalized q = E'/D, r = Qt^2/D^2, s = B^2/D, t = Q.B/D^(3/2)
+ */
+struct PalenzuelaResidual {
+    Real gam, q, r, s, t;
+    KOKKOS_INLINE_FUNCTION Real operator()(const Real& x) const
+    {
+        const Real x2 = x * x;
+        // Clip 1/gamma^2 to values lorentz_calc_w would accept
+        const Real gm2 = clip(1. - (x2 * r + (2. * x + s) * t * t) / (x2 * (x + s) * (x + s)), 1. - UTOP_VSQ_MAX, 1.);
+        const Real gamma = 1. / sqrt(gm2);
+        const Real eps = -1. + x / gamma * (1. - gamma * gamma) +
+                         gamma * (1. + q - s + 0.5 * (s * gm2 + t * t / x2));
+        // Specific enthalpy of an ideal gas, h = 1 + gam eps
+        const Real h = 1. + gam * max(eps, 0.);
+        return x - h * gamma;
+    }
+};
+
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_palenzuela(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                         const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                         const VariablePack<Real>& P, const VarMap& m_p,
+                                                         const Real& tol, const int& iter_max, int& niter)
+{
+    niter = 0;
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    InversionStatus status = u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon);
+    if (status != InversionStatus::success) return status;
+
+    const PalenzuelaResidual f = {gam, Ep / D, Qtsq / (D * D), Bsq / D, QdB / pow(D, 1.5)};
+    // Bracket from Palenzuela et al., noting x = h gamma >= 1
+    const Real x_lo = max(1. + f.q - f.s, 1.);
+    const Real x_hi = max(2. + 2. * f.q - f.s, 2. * x_lo);
+    Real x;
+    status = brent_root(f, x_lo, x_hi, tol, iter_max, x, niter);
+    if (status != InversionStatus::success) return status;
+
+    return u_to_p_finish(gam, Bsq, D, QdB, Qtsq, D * (x - 1.), Qtcon, Bcon, k, j, i, P, m_p);
+}
+
+/**
+ * Master function of Kastaun et al. (2021) eq. 44, f(mu) = mu - 1/(nu + rbar^2 mu), for mu = 1/(h gamma),
+ * with normalized q = E'/D, r^2 = Qt^2/D^2, b^2 = B^2/D, r.b = Q.B/D^(3/2).
+ * The minimum enthalpy of an ideal gas is h0 = 1
+ */
+struct KastaunResidual {
+    Real gam, q, rsq, bsq, rbsq, v0sq;
+    KOKKOS_INLINE_FUNCTION Real operator()(const Real& mu) const
+    {
+        const Real x = 1. / (1. + mu * bsq);
+        const Real rbarsq = rsq * x * x + mu * x * (1. + x) * rbsq;
+        const Real qbar = q - 0.5 * bsq - 0.5 * mu * mu * x * x * (bsq * rsq - rbsq);
+        const Real vsq = min(mu * mu * rbarsq, v0sq);
+        const Real gamma = 1. / sqrt(1. - vsq);
+        // Clamp eps to the ideal gas' valid range, eps >= 0
+        const Real eps = max(gamma * (qbar - mu * rbarsq) + vsq * gamma * gamma / (1. + gamma), 0.);
+        // a = p / (rho (1 + eps))
+        const Real a = (gam - 1.) * eps / (1. + eps);
+        const Real nu = max((1. + a) * (1. + eps) / gamma, (1. + a) * (1. + qbar - mu * rbarsq));
+        return mu - 1. / (nu + rbarsq * mu);
+    }
+};
+
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_kastaun(const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                      const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                      const VariablePack<Real>& P, const VarMap& m_p,
+                                                      const Real& tol, const int& iter_max, int& niter)
+{
+    niter = 0;
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    InversionStatus status = u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon);
+    if (status != InversionStatus::success) return status;
+
+    const Real rsq = Qtsq / (D * D);
+    const KastaunResidual f = {gam, Ep / D, rsq, Bsq / D, QdB * QdB / (D * D * D), rsq / (1. + rsq)};
+    Real mu;
+    status = brent_root(f, 0., 1., tol, iter_max, mu, niter);
+    if (status != InversionStatus::success) return status;
+
+    // W = D h gamma = D / mu
+    return u_to_p_finish(gam, Bsq, D, QdB, Qtsq, D * (1. - mu) / mu, Qtcon, Bcon, k, j, i, P, m_p);
+}
+
+/**
+ * Residual of the momentum equation (Noble et al. eq. 28, solved for v^2) as a function of the Lorentz factor,
+ * when the enthalpy is given by the entropy K = p/rho^gam rather than by the energy equation
+ */
+struct EntropyResidual {
+    Real gam, K, D, Bsq, QdB, Qtsq;
+    KOKKOS_INLINE_FUNCTION Real operator()(const Real& gamma) const
+    {
+        const Real rho = D / gamma;
+        const Real W = (rho + gam / (gam - 1.) * K * pow(rho, gam)) * gamma * gamma;
+        const Real BW = Bsq + W;
+        return (Qtsq + QdB * QdB * (Bsq + 2. * W) / (W * W)) / (BW * BW) - (1. - 1. / (gamma * gamma));
+    }
+};
+
+/**
+ * Recover the primitives of a zone using the advected entropy K = p/rho^gam in place of the energy equation,
+ * for zones where the usual inversion failed.  Tracking KTOT with the Electrons package provides K = U(KTOT)/U(RHO).
+ *
+ * The root is bracketed in gamma between 1 and the largest Lorentz factor lorentz_calc_w accepts,
+ * so this succeeds for nearly any conserved state with positive D and K.
+ * The result doesn't conserve energy, so on success this also sets the conserved energy to match,
+ * returning the change to U(UU) in dUU.  If the retry also fails, returns the original status
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_entropy(const InversionSettings& inv,
+                                                      const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                      const Real& gam, const Real& K, const int& k, const int& j, const int& i,
+                                                      const Loci loc, const VariablePack<Real>& P, const VarMap& m_p,
+                                                      const InversionStatus& status, Real& dUU)
+{
+    dUU = 0.;
+    if (!(K > 0.)) return status;
+
+    Real D, Bsq, QdB, Qtsq, Ep, Qtcon[GR_DIM], Bcon[GR_DIM];
+    if (u_to_p_setup(G, U, m_u, k, j, i, loc, D, Bsq, QdB, Qtsq, Ep, Qtcon, Bcon) != InversionStatus::success)
+        return status;
+
+    const EntropyResidual f = {gam, K, D, Bsq, QdB, Qtsq};
+    Real gamma;
+    int niter;
+    if (brent_root(f, 1., sqrt(1. + 1.e7), inv.tol, inv.iter_max, gamma, niter) != InversionStatus::success)
+        return status;
+
+    const Real rho = D / gamma;
+    const Real Wp = (rho + gam / (gam - 1.) * K * pow(rho, gam)) * gamma * gamma - D;
+    if (u_to_p_finish(gam, Bsq, D, QdB, Qtsq, Wp, Qtcon, Bcon, k, j, i, P, m_p) != InversionStatus::success)
+        return status;
+
+    // The energy E' = -Q.n - D which would have given this W' is the root of err_eqn in E'.
+    // U(UU) changes by -gdet times the change in E', see u_to_p_setup
+    InversionStatus eflag = InversionStatus::success;
+    dUU = -G.gdet(loc, j, i) * err_eqn(gam, Bsq, D, Ep, QdB, Qtsq, Wp, eflag);
+    return InversionStatus::success;
+}
+
+/**
+ * Retry a failed inversion with u_to_p_entropy, if enabled with GRMHD/entropy_fallback.
+ * K is the entropy cons.Ktot / cons.rho, ignored otherwise.  Applies the change in conserved energy, and
+ * returns the new status: success if recovered, otherwise the original status, for FixUtoP
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_fallback(const InversionSettings& inv,
+                                                       const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                       const Real& gam, const Real& K,
+                                                       const int& k, const int& j, const int& i, const Loci loc,
+                                                       const VariablePack<Real>& P, const VarMap& m_p,
+                                                       const InversionStatus& status)
+{
+    if (!inv.entropy_fallback || status == InversionStatus::success || status == InversionStatus::neg_input)
+        return status;
+    Real dUU;
+    const InversionStatus new_status = u_to_p_entropy(inv, G, U, m_u, gam, K, k, j, i, loc, P, m_p, status, dUU);
+    U(m_u.UU, k, j, i) += dUU;
+    return new_status;
+}
+
+/**
+ * Recover the primitives of a zone with the solver selected in inv.
+ * Same arguments & return as u_to_p, plus the number of iterations or function evaluations taken
+ */
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_select(const InversionSettings& inv,
+                                                     const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                     const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                     const VariablePack<Real>& P, const VarMap& m_p, int& niter)
+{
+    switch (inv.type) {
+    case InversionType::twod:
+        return u_to_p_twod(G, U, m_u, gam, k, j, i, loc, P, m_p, inv.tol, inv.iter_max, niter);
+    case InversionType::palenzuela:
+        return u_to_p_palenzuela(G, U, m_u, gam, k, j, i, loc, P, m_p, inv.tol, inv.iter_max, niter);
+    case InversionType::kastaun:
+        return u_to_p_kastaun(G, U, m_u, gam, k, j, i, loc, P, m_p, inv.tol, inv.iter_max, niter);
+    case InversionType::onedw:
+    default:
+        return u_to_p(G, U, m_u, gam, k, j, i, loc, P, m_p, niter);
+    }
+}
+KOKKOS_INLINE_FUNCTION InversionStatus u_to_p_select(const InversionSettings& inv,
+                                                     const GRCoordinates &G, const VariablePack<Real>& U, const VarMap& m_u,
+                                                     const Real& gam, const int& k, const int& j, const int& i, const Loci loc,
+                                                     const VariablePack<Real>& P, const VarMap& m_p)
+{
+    int niter;
+    return u_to_p_select(inv, G, U, m_u, gam, k, j, i, loc, P, m_p, niter);
+}
+
+} // namespace GRMHD
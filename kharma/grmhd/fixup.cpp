@@ -36,12 +36,56 @@
 
 #include "floors.hpp"
 #include "flux_functions.hpp"
+#include "grmhd.hpp"
+#include "local_timestep.hpp"
 #include "pack.hpp"
 
 // Version of PLOOP guaranteeing specifically the 5 GRMHD fixup-amenable primitive vars
 #define NPRIM 5
 #define PRIMLOOP for(int p=0; p < NPRIM; ++p)
 
+/**
+ * Replace the primitives of a flagged zone with the average of its neighbors which inverted successfully,
+ * weighted by distance.  Only good zones are read, and only the flagged zone is written,
+ * so zones can be fixed in any order
+ */
+KOKKOS_INLINE_FUNCTION void fix_zone(const VariablePack<Real>& P, const ParArray4D<int8_t>& pflag, const int& lid,
+                                     const int& k, const int& j, const int& i,
+                                     const IndexRange& kb, const IndexRange& jb, const IndexRange& ib,
+                                     const IndexRange& kb_b, const IndexRange& jb_b, const IndexRange& ib_b,
+                                     const int& verbose)
+{
+    // Luckily fixups are rare, so we don't have to worry about optimizing this too much
+    double wsum = 0.;
+    double sum[NPRIM] = {0.};
+    // For all neighboring cells...
+    for (int n = -1; n <= 1; n++) {
+        for (int m = -1; m <= 1; m++) {
+            for (int l = -1; l <= 1; l++) {
+                int ii = i + l, jj = j + m, kk = k + n;
+                // If we haven't overstepped array bounds...
+                // Count only the good cells.  Note interpolated "fixed" cells stay flagged
+                if (inside(kk, jj, ii, kb, jb, ib) && pflag(lid, kk, jj, ii) == InversionStatus::success) {
+                    // Weight by distance
+                    double w = 1./(abs(l) + abs(m) + abs(n) + 1);
+                    wsum += w;
+                    PRIMLOOP sum[p] += w * P(p, kk, jj, ii);
+                }
+            }
+        }
+    }
+
+    if(wsum < 1.e-10) {
+        // TODO probably should crash here.
+#ifndef KOKKOS_ENABLE_SYCL
+        if (verbose >= 1 && inside(k, j, i, kb_b, jb_b, ib_b)) // If an interior zone...
+            printf("No neighbors were available at %d %d %d!\n", i, j, k);
+#endif
+    } else {
+        PRIMLOOP P(p, k, j, i) = sum[p]/wsum;
+    }
+}
+
 TaskStatus GRMHD::FixUtoP(MeshBlockData<Real> *rc)
 {
     // We expect primitives all the way out to 3 ghost zones on all sides.
@@ -52,17 +96,25 @@ TaskStatus GRMHD::FixUtoP(MeshBlockData<Real> *rc)
     auto pmb = rc->GetBlockPointer();
     const auto& G = pmb->coords;
 
+    // Blocks sitting out this step under local timestepping weren't inverted, except in any
+    // ghost zones interpolated for their next step, see LocalTimestep::BlockFilled
+    if (!LocalTimestep::BlockFilled(pmb.get())) return TaskStatus::complete;
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb.get());
+    const int gid = pmb->gid;
+
     // TODO what should be averaged on a fixup? Just these core 5 prims?
     // Should there be a flag to do more?
     auto P = GRMHD::PackHDPrims(rc);
 
-    GridScalar pflag = rc->Get("pflag").data;
-    GridScalar fflag = rc->Get("fflag").data;
+    // Pick up any flags synchronized from neighbors along with the primitives, see GRMHD::Initialize
+    GRMHD::CopyPFlags(rc, true);
+    const auto pflag = GRMHD::PFlags(pmb.get());
+    const int lid = pmb->lid;
 
     const auto& pars = pmb->packages.Get("GRMHD")->AllParams();
     const Real gam = pars.Get<Real>("gamma");
     const int verbose = pars.Get<int>("verbose");
-    const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams());
+    const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams(), pmb.get());
 
     const IndexRange ib = rc->GetBoundsI(IndexDomain::entire);
     const IndexRange jb = rc->GetBoundsJ(IndexDomain::entire);
@@ -72,49 +124,32 @@ TaskStatus GRMHD::FixUtoP(MeshBlockData<Real> *rc)
     const IndexRange jb_b = rc->GetBoundsJ(IndexDomain::interior);
     const IndexRange kb_b = rc->GetBoundsK(IndexDomain::interior);
 
-    // TODO attempt to recover from entropy here if it's present
+    // Zones which could be recovered from the entropy already were, see GRMHD/entropy_fallback
 
+    // With perf/sparse_fixup, visit only the zones UtoP listed, unless the list overflowed.
+    // The count is checked on device: the sparse kernel covers the whole list & skips entries past it,
+    // and the sweep skips the block unless the list overflowed
+    const bool sparse = pars.Get<bool>("sparse_fixup");
+    const auto fixup_list = sparse ? GRMHD::FixupList(pmb.get()) : ParArray2D<int>();
+    const auto fixup_count = sparse ? GRMHD::FixupCount(pmb.get()) : ParArray1D<int>();
+    const int n1 = ib.e + 1, n2 = jb.e + 1;
+
+    if (sparse) {
+        pmb->par_for("fix_U_to_P_sparse", 0, fixup_list.extent_int(1) - 1,
+            KOKKOS_LAMBDA (const int &n) {
+                if (!fixups_listed(fixup_list, fixup_count, lid) || n >= fixup_count(lid)) return;
+                const int idx = fixup_list(lid, n);
+                const int k = idx / (n1 * n2), j = (idx / n1) % n2, i = idx % n1;
+                fix_zone(P, pflag, lid, k, j, i, kb, jb, ib, kb_b, jb_b, ib_b, verbose);
+            }
+        );
+    }
     pmb->par_for("fix_U_to_P", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_3D {
+            if (fixups_listed(fixup_list, fixup_count, lid)) return;
             // Negative flags mark physical corners, which shouldn't be fixed
-            if (((int) pflag(k, j, i)) > InversionStatus::success) {
-                // Luckily fixups are rare, so we don't have to worry about optimizing this too much
-                double wsum = 0., wsum_x = 0.;
-                double sum[NPRIM] = {0.}, sum_x[NPRIM] = {0.};
-                // For all neighboring cells...
-                for (int n = -1; n <= 1; n++) {
-                    for (int m = -1; m <= 1; m++) {
-                        for (int l = -1; l <= 1; l++) {
-                            int ii = i + l, jj = j + m, kk = k + n;
-                            // If we haven't overstepped array bounds...
-                            if (inside(kk, jj, ii, kb, jb, ib)) {
-                                // Weight by distance
-                                double w = 1./(abs(l) + abs(m) + abs(n) + 1);
-
-                                // Count only the good cells, if we can
-                                if (((int) pflag(kk, jj, ii)) == InversionStatus::success) {
-                                    // Weight by distance.  Note interpolated "fixed" cells stay flagged
-                                    wsum += w;
-                                    PRIMLOOP sum[p] += w * P(p, kk, jj, ii);
-                                }
-                                // Just in case, keep a sum of even the bad ones
-                                wsum_x += w;
-                                PRIMLOOP sum_x[p] += w * P(p, kk, jj, ii);
-                            }
-                        }
-                    }
-                }
-
-                if(wsum < 1.e-10) {
-                    // TODO probably should crash here.
-#ifndef KOKKOS_ENABLE_SYCL
-                    if (verbose >= 1 && inside(k, j, i, kb_b, jb_b, ib_b)) // If an interior zone...
-                        printf("No neighbors were available at %d %d %d!\n", i, j, k);
-#endif
-                    //PRIMLOOP P(p, k, j, i) = sum_x[p]/wsum_x;
-                } else {
-                    PRIMLOOP P(p, k, j, i) = sum[p]/wsum;
-                }
+            if (steps.fills_zone(gid, i, ib_b) && pflag(lid, k, j, i) > InversionStatus::success) {
+                fix_zone(P, pflag, lid, k, j, i, kb, jb, ib, kb_b, jb_b, ib_b, verbose);
             }
         }
     );
@@ -125,12 +160,22 @@ TaskStatus GRMHD::FixUtoP(MeshBlockData<Real> *rc)
     auto U = GRMHD::PackMHDCons(rc, cons_map);
     P = GRMHD::PackMHDPrims(rc, prims_map);
     const VarMap m_u(cons_map, true), m_p(prims_map, false);
-    // Get new sizes
-    const int nvar = P.GetDim(4);
 
+    if (sparse) {
+        pmb->par_for("fix_U_to_P_floors_sparse", 0, fixup_list.extent_int(1) - 1,
+            KOKKOS_LAMBDA (const int &n) {
+                if (!fixups_listed(fixup_list, fixup_count, lid) || n >= fixup_count(lid)) return;
+                const int idx = fixup_list(lid, n);
+                const int k = idx / (n1 * n2), j = (idx / n1) % n2, i = idx % n1;
+                apply_geo_floors(G, P, m_p, gam, k, j, i, floors);
+                GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u);
+            }
+        );
+    }
     pmb->par_for("fix_U_to_P_floors", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_3D {
-            if (((int) pflag(k, j, i)) > InversionStatus::success) {
+            if (fixups_listed(fixup_list, fixup_count, lid)) return;
+            if (steps.fills_zone(gid, i, ib_b) && pflag(lid, k, j, i) > InversionStatus::success) {
                 apply_geo_floors(G, P, m_p, gam, k, j, i, floors);
 
                 // Make sure to keep lockstep
@@ -150,3 +195,124 @@ TaskStatus GRMHD::FixUtoP(MeshBlockData<Real> *rc)
     Flag(rc, "Fixed U to P inversions");
     return TaskStatus::complete;
 }
+
+TaskStatus GRMHD::FixUtoP(MeshData<Real> *md)
+{
+    // Same operation as above over all blocks at once.  Each block's zones are still fixed
+    // only from that block's own neighbors, as when called block-by-block
+    Flag(md, "Fixing U to P inversions Mesh");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    PackIndexMap hd_map;
+    auto P = GRMHD::PackHDPrims(md, hd_map);
+
+    GRMHD::CopyPFlags(md, true);
+    const auto pflag = GRMHD::PFlags(pmb0.get());
+
+    const auto& pars = pmb0->packages.Get("GRMHD")->AllParams();
+    const Real gam = pars.Get<Real>("gamma");
+    const int verbose = pars.Get<int>("verbose");
+    const Floors::Prescription floors(pmb0->packages.Get("Floors")->AllParams(), md);
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+
+    const IndexRange ib_b = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb_b = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb_b = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P.GetDim(5) - 1};
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb0.get());
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+
+    // With perf/sparse_fixup, visit only the listed zones of each block, and sweep just the blocks
+    // whose lists overflowed.  As above, the counts are only read on device
+    const bool sparse = pars.Get<bool>("sparse_fixup");
+    const auto fixup_list = sparse ? GRMHD::FixupList(pmb0.get()) : ParArray2D<int>();
+    const auto fixup_count = sparse ? GRMHD::FixupCount(pmb0.get()) : ParArray1D<int>();
+    const int n1 = ib.e + 1, n2 = jb.e + 1;
+
+    if (sparse) {
+        pmb0->par_for("fix_U_to_P_sparse", block.s, block.e, 0, fixup_list.extent_int(1) - 1,
+            KOKKOS_LAMBDA (const int &b, const int &n) {
+                if (!steps.is_filled(gid0 + b) || !fixups_listed(fixup_list, fixup_count, lid0 + b) ||
+                    n >= fixup_count(lid0 + b)) return;
+                const int idx = fixup_list(lid0 + b, n);
+                const int k = idx / (n1 * n2), j = (idx / n1) % n2, i = idx % n1;
+                fix_zone(P(b), pflag, lid0 + b, k, j, i, kb, jb, ib, kb_b, jb_b, ib_b, verbose);
+            }
+        );
+    }
+    pmb0->par_for("fix_U_to_P", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (fixups_listed(fixup_list, fixup_count, lid0 + b) || !steps.fills_zone(gid0 + b, i, ib_b)) return;
+            if (pflag(lid0 + b, k, j, i) > InversionStatus::success) {
+                fix_zone(P(b), pflag, lid0 + b, k, j, i, kb, jb, ib, kb_b, jb_b, ib_b, verbose);
+            }
+        }
+    );
+
+    PackIndexMap prims_map, cons_map;
+    auto U = GRMHD::PackMHDCons(md, cons_map);
+    P = GRMHD::PackMHDPrims(md, prims_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    if (sparse) {
+        pmb0->par_for("fix_U_to_P_floors_sparse", block.s, block.e, 0, fixup_list.extent_int(1) - 1,
+            KOKKOS_LAMBDA (const int &b, const int &n) {
+                if (!steps.is_filled(gid0 + b) || !fixups_listed(fixup_list, fixup_count, lid0 + b) ||
+                    n >= fixup_count(lid0 + b)) return;
+                const int idx = fixup_list(lid0 + b, n);
+                const int k = idx / (n1 * n2), j = (idx / n1) % n2, i = idx % n1;
+                const auto& G = U.GetCoords(b);
+                apply_geo_floors(G, P(b), m_p, gam, k, j, i, floors.for_block(lid0 + b));
+                GRMHD::p_to_u(G, P(b), m_p, gam, k, j, i, U(b), m_u);
+            }
+        );
+    }
+    pmb0->par_for("fix_U_to_P_floors", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (fixups_listed(fixup_list, fixup_count, lid0 + b) || !steps.fills_zone(gid0 + b, i, ib_b)) return;
+            if (pflag(lid0 + b, k, j, i) > InversionStatus::success) {
+                const auto& G = U.GetCoords(b);
+                apply_geo_floors(G, P(b), m_p, gam, k, j, i, floors.for_block(lid0 + b));
+                GRMHD::p_to_u(G, P(b), m_p, gam, k, j, i, U(b), m_u);
+            }
+        }
+    );
+
+    Flag(md, "Fixed U to P inversions");
+    return TaskStatus::complete;
+}
+
+ParArray2D<int> GRMHD::FixupList(MeshBlock *pmb)
+{
+    auto& params = pmb->packages.Get("GRMHD")->AllParams();
+    auto fixup_list = params.Get<ParArray2D<int>>("fixup_list");
+    // (Re)allocate when first used, or when the number of blocks on this rank changes on remesh.
+    // Room for 1/sparse_fixup_divisor (default 1/32) of each block's zones, beyond which FixUtoP
+    // falls back to sweeping the block
+    const int nblocks = pmb->pmy_mesh->block_list.size();
+    if (fixup_list.extent_int(0) != nblocks) {
+        const auto& cb = pmb->cellbounds;
+        const int ncells = cb.ncellsk(IndexDomain::entire) * cb.ncellsj(IndexDomain::entire) *
+                           cb.ncellsi(IndexDomain::entire);
+        const int divisor = params.Get<int>("sparse_fixup_divisor");
+        fixup_list = ParArray2D<int>("fixup_list", nblocks, std::max(ncells / divisor, 1));
+        params.Update<ParArray2D<int>>("fixup_list", fixup_list);
+    }
+    return fixup_list;
+}
+
+ParArray1D<int> GRMHD::FixupCount(MeshBlock *pmb)
+{
+    auto& params = pmb->packages.Get("GRMHD")->AllParams();
+    auto fixup_count = params.Get<ParArray1D<int>>("fixup_count");
+    const int nblocks = pmb->pmy_mesh->block_list.size();
+    if (fixup_count.extent_int(0) != nblocks) {
+        fixup_count = ParArray1D<int>("fixup_count", nblocks);
+        params.Update<ParArray1D<int>>("fixup_count", fixup_count);
+    }
+    return fixup_count;
+}
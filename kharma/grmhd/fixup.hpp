@@ -48,5 +48,39 @@ namespace GRMHD {
  * LOCKSTEP: this function expects and should preserve P<->U
  */
 TaskStatus FixUtoP(MeshBlockData<Real> *rc);
+TaskStatus FixUtoP(MeshData<Real> *md);
+// Overloaded functions can't be handed to AddTask, so the drivers add these
+inline TaskStatus FixUtoPBlockTask(MeshBlockData<Real> *rc) { return FixUtoP(rc); }
+inline TaskStatus FixUtoPMeshTask(MeshData<Real> *md) { return FixUtoP(md); }
+
+/**
+ * Per-block lists of the zones UtoP flagged, indexed (lid, n), for perf/sparse_fixup.
+ * Entries are flattened indices (k * n2 + j) * n1 + i over the block's entire domain.
+ * FixupCount holds the number flagged in each block.  If this overflows the list, FixUtoP
+ * sweeps that block as usual, as it does when the list wasn't filled by the last UtoP.
+ * The counts are only ever read on device, so FixUtoP never waits on them.
+ * Allocated on first use and re-allocated if the number of blocks changes.
+ */
+ParArray2D<int> FixupList(MeshBlock *pmb);
+ParArray1D<int> FixupCount(MeshBlock *pmb);
+
+/**
+ * Append a flagged zone to its block's list, see FixupList
+ */
+KOKKOS_INLINE_FUNCTION void record_fixup(const ParArray2D<int>& list, const ParArray1D<int>& count, const int& lid,
+                                         const int& k, const int& j, const int& i, const int& n2, const int& n1)
+{
+    const int n = Kokkos::atomic_fetch_add(&count(lid), 1);
+    if (n < list.extent_int(1)) list(lid, n) = (k * n2 + j) * n1 + i;
+}
+
+/**
+ * Whether FixUtoP can visit just the zones in a block's list: false without perf/sparse_fixup,
+ * or if the list overflowed
+ */
+KOKKOS_INLINE_FUNCTION bool fixups_listed(const ParArray2D<int>& list, const ParArray1D<int>& count, const int& lid)
+{
+    return count.extent_int(0) > 0 && count(lid) <= list.extent_int(1);
+}
 
 }
@@ -48,12 +48,14 @@
 #include "debug.hpp"
 #include "fixup.hpp"
 #include "floors.hpp"
+#include "local_timestep.hpp"
 #include "flux.hpp"
 #include "gr_coordinates.hpp"
 #include "kharma.hpp"
 #include "grmhd_functions.hpp"
 #include "source.hpp"
 #include "U_to_P.hpp"
+#include "U_to_P_solvers.hpp"
 
 using namespace parthenon;
 // Need to access these directly for reductions
@@ -126,21 +128,37 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
 
     // Reconstruction scheme: plm, weno5, ppm...
     std::string recon = pin->GetOrAddString("GRMHD", "reconstruction", "weno5");
-    if (recon == "donor_cell") {
-        params.Add("recon", ReconstructionType::donor_cell);
-    } else if (recon == "linear_vl") {
-        params.Add("recon", ReconstructionType::linear_vl);
-    } else if (recon == "linear_mc") {
-        params.Add("recon", ReconstructionType::linear_mc);
-    } else if (recon == "weno5") {
-        params.Add("recon", ReconstructionType::weno5);
-    // } else if (recon == "weno5_lower_poles") {
-    //     params.Add("recon", ReconstructionType::weno5_lower_poles);
+    params.Add("recon", KReconstruction::ParseReconstructionType(recon));
+
+    // Primitive variable recovery: the usual one-dimensional Newton-Raphson solve in W', or one of the
+    // alternatives in U_to_P_solvers.hpp.  The tolerance & iteration limit apply only to the alternatives
+    std::string inverter = pin->GetOrAddString("GRMHD", "inverter", "onedw");
+    if (inverter == "onedw") {
+        params.Add("inverter", InversionType::onedw);
+    } else if (inverter == "twod") {
+        params.Add("inverter", InversionType::twod);
+    } else if (inverter == "palenzuela") {
+        params.Add("inverter", InversionType::palenzuela);
+    } else if (inverter == "kastaun") {
+        params.Add("inverter", InversionType::kastaun);
     } else {
-        cerr << "Reconstruction type not supported!  Supported reconstructions:" << endl;
-        cerr << "donor_cell, linear_mc, linear_vl, weno5" << endl;
-        throw std::invalid_argument("Unsupported reconstruction algorithm!");
+        cerr << "Inverter type not supported!  Supported inverters:" << endl;
+        cerr << "onedw, twod, palenzuela, kastaun" << endl;
+        throw std::invalid_argument("Unsupported inversion algorithm!");
     }
+    Real inverter_tol = pin->GetOrAddReal("GRMHD", "inverter_tol", UTOP_ERRTOL);
+    params.Add("inverter_tol", inverter_tol);
+    int inverter_iter_max = pin->GetOrAddInteger("GRMHD", "inverter_iter_max", 30);
+    params.Add("inverter_iter_max", inverter_iter_max);
+    // When the inversion fails, retry using the advected entropy (see U_to_P_solvers.hpp) before resorting
+    // to FixUtoP's neighbor averages.  Requires the total entropy Ktot, tracked when electrons are enabled
+    bool electrons = pin->GetOrAddBoolean("electrons", "on", false);
+    bool entropy_fallback = pin->GetOrAddBoolean("GRMHD", "entropy_fallback", electrons);
+    if (entropy_fallback && !electrons) {
+        cerr << "GRMHD/entropy_fallback requires evolving the total entropy, with electrons/on=true!" << endl;
+        throw std::invalid_argument("Unsupported inversion options!");
+    }
+    params.Add("entropy_fallback", entropy_fallback);
 
     // Diagnostic data
     int verbose = pin->GetOrAddInteger("debug", "verbose", 0);
@@ -171,16 +189,153 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     auto implicit_grmhd = (driver_type == "imex") &&
                           (pin->GetBoolean("emhd", "on") || pin->GetOrAddBoolean("GRMHD", "implicit", false));
     params.Add("implicit", implicit_grmhd);
+    // The HARM driver can replace Parthenon's integrator (parthenon/time/integrator) with a low-storage SSP
+    // integrator, which updates a single stage container in place.  See HARMDriver & LowStorageCoeffs.
+    // The SSP coefficient bounds the stable "cfl" per step, which is spread over all of a scheme's stages.
+    // Their end-to-end memory & zone-cycles against rk2/rk3 haven't been measured, see tests/performance.
+    // Electron heating needs the state from before each stage, so it can't be used with these
+    auto integrator = pin->GetOrAddString("driver", "integrator", "parthenon");
+    if (integrator != "parthenon" && (driver_type != "harm" || pin->GetOrAddBoolean("electrons", "on", false))) {
+        cerr << "Low-storage integrators require the HARM driver, and don't support electrons!" << endl;
+        throw std::invalid_argument("Unsupported integrator!");
+    }
 
     // Performance options
     // Packed communications kernels, exchanging all boundary buffers of an MPI process
     // together.  Useful if # MeshBlocks is > # MPI ranks
     bool pack_comms = pin->GetOrAddBoolean("perf", "pack_comms", true);
     params.Add("pack_comms", pack_comms);
+    // With the HARM driver, primitive ghost zones are recomputed from the conserved variables right after each sync,
+    // and the synced values only seed the inversion.  Skipping them changes results only at the level of the
+    // inversion tolerance. "all" syncs them every stage, "last" only at the end of each step, "none" never.
+    // See KBoundaries::SyncContainer.  The default stays "all" so that results don't depend on the
+    // block decomposition.  tests/performance/run.sh benchmarks "last" and "none" against it.
+    // (prims.B needs no entry: under this driver it isn't FillGhost, and is always recomputed from cons.B)
+    if (driver_type == "harm") {
+        std::string sync_prims = pin->GetOrAddString("GRMHD", "sync_prims", "all");
+        if (sync_prims != "all" && sync_prims != "last" && sync_prims != "none") {
+            throw std::invalid_argument("GRMHD/sync_prims must be one of all, last, none!");
+        }
+        params.Add("sync_optional", std::vector<std::string>{"prims.rho", "prims.u", "prims.uvec"});
+        params.Add("sync_optional_stages", sync_prims);
+    }
     // Synchronize boundary variables twice.  Ensures KHARMA is agnostic to the breakdown
     // of meshblocks, at the cost of twice the MPI overhead, for potentially much worse strong scaling.
     bool two_sync = pin->GetOrAddBoolean("perf", "two_sync", false);
+    // Overlap the second sync with the next stage's flux calculation: the next stage calculates fluxes
+    // which don't need ghost zones while the sync is in flight.  See HARMDriver.
+    // Only the second sync is overlapped, so this requires two_sync.  The first sync could be overlapped
+    // the same way, since core fluxes need only the interior primitives, but that would mean splitting
+    // UtoP & fixups into interior and ghost zone parts
+    bool overlap_comms = pin->GetOrAddBoolean("perf", "overlap_comms", false);
+    if (overlap_comms && !two_sync) {
+        throw std::invalid_argument("perf/overlap_comms overlaps the second boundary sync, and requires perf/two_sync!");
+    }
+    params.Add("overlap_comms", overlap_comms);
     params.Add("two_sync", two_sync);
+    // Apply fluxes & sources and take each substep in one kernel, without writing dU/dt to memory,
+    // see Flux::ApplyFluxesAndUpdate.  Only used by the HARM driver, as the ImEx driver needs dU/dt.
+    // Always used with perf/deep_halo, below, and with local timestepping, which steps blocks within it
+    bool fused_update = pin->GetOrAddBoolean("perf", "fused_update", false) ||
+                        pin->GetOrAddBoolean("perf", "deep_halo", false) ||
+                        pin->GetOrAddBoolean("local_timestep", "on", false);
+    // B_CD::AddSource adds its dB directly to the stage's state rather than to dU/dt, which
+    // the fused kernel can't reproduce, so the two can't be combined
+    const std::string b_field_solver = pin->GetOrAddString("b_field", "solver", "flux_ct");
+    if (fused_update && (b_field_solver == "constraint_damping" || b_field_solver == "b_cd")) {
+        cerr << "perf/fused_update (implied by perf/deep_halo and local_timestep/on) can't be used with constraint damping!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    params.Add("fused_update", fused_update);
+    // Reduce the signal speed to a per-block maximum as the fluxes are calculated, rather than
+    // writing ctop for every zone and face and reading it back in EstimateTimestep.
+    // The ctop field is still allocated and filled if it is needed for output or extra_checks,
+    // and under local timestepping, where blocks which didn't step fall back to their last ctop values
+    bool reduce_ctop = pin->GetOrAddBoolean("perf", "reduce_ctop", false);
+    params.Add("reduce_ctop", reduce_ctop);
+    bool store_ctop = !reduce_ctop || extra_checks >= 1 || OutputRequested(pin, "ctop") ||
+                      pin->GetOrAddBoolean("local_timestep", "on", false);
+    params.Add("store_ctop", store_ctop);
+    // Per-block maxima of ctop/dx in each direction, indexed by lid, and a host copy read once per step.
+    // Allocated by CtopBuffer, copied by FetchCtopBuffer
+    params.Add("ctop_block", ParArray2D<Real>(), true);
+    params.Add("ctop_block_h", ParArray2D<Real>::HostMirror(), true);
+    // Fill primitives, apply floors and fix inversions over whole MeshData partitions, rather than
+    // launching the same kernels once per block.  Ignored with mesh refinement, which must prolongate first
+    bool mesh_utop = pin->GetOrAddBoolean("perf", "mesh_utop", false);
+    params.Add("mesh_utop", mesh_utop);
+    // Take the intermediate RK stages through a deep layer of ghost zones, rather than syncing after each:
+    // every stage's update also covers the ghost zones which the following stages will reconstruct from,
+    // so only the last stage syncs.  nghost is raised to fit, see KHARMA::FixParameters.
+    // HARM driver only, and implies fused_update, since Parthenon's flux divergence covers only the interior
+    bool deep_halo = pin->GetOrAddBoolean("perf", "deep_halo", false);
+    if (deep_halo) {
+        if (driver_type != "harm" || integrator != "parthenon" || two_sync || overlap_comms ||
+            pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none") {
+            cerr << "perf/deep_halo requires the HARM driver with Parthenon's integrators," << endl;
+            cerr << "and can't be combined with mesh refinement or two_sync!" << endl;
+            throw std::invalid_argument("Unsupported performance options!");
+        }
+    }
+    params.Add("deep_halo", deep_halo);
+    // Rows of ghost zones by which each stage's update must extend beyond the next: the next stage
+    // calculates fluxes one row further out, reconstructs them from stencil_reach zones beyond that,
+    // and fixups average over one more.  The last stage updates only the interior as usual
+    params.Add("deep_halo_stride", KReconstruction::stencil_reach(params.Get<ReconstructionType>("recon")) + 2);
+    // Invert zones in groups of UTOP_BATCH (by default the SIMD width) along each row, iterating them together
+    // with converged zones masked off, so that the compiler can vectorize the solve.  Results should be bitwise identical to the
+    // default, but a compiler may contract (FMA) or vectorize sqrt/pow differently in the two loops, which
+    // changes the last bits: tests/perf_identity checks this at zero tolerance for a given build.
+    // Intended for CPUs: on GPUs, the usual one-thread-per-zone kernel is better
+    bool batch_utop = pin->GetOrAddBoolean("perf", "batch_utop", false);
+    if (batch_utop && params.Get<InversionType>("inverter") != InversionType::onedw) {
+        cerr << "perf/batch_utop supports only the default inverter, onedw!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    params.Add("batch_utop", batch_utop);
+    // Keep each zone's converged W' from the last inversion in the field "utop_wp", and start the next from it
+    // rather than from the primitives.  Default inverter only
+    bool cache_wp = pin->GetOrAddBoolean("perf", "cache_wp", false);
+    params.Add("cache_wp", cache_wp);
+    // Record the iterations each zone's inversion took in "utop_niter", and add a histogram
+    // of them over the interior to the history file, see CountUtoPIterations
+    bool utop_histogram = pin->GetOrAddBoolean("perf", "utop_histogram", false);
+    params.Add("utop_histogram", utop_histogram);
+    if (cache_wp && params.Get<InversionType>("inverter") != InversionType::onedw) {
+        cerr << "perf/cache_wp supports only the default inverter, onedw!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    if (batch_utop && (cache_wp || utop_histogram)) {
+        cerr << "perf/batch_utop can't be combined with perf/cache_wp or perf/utop_histogram!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    // Have UtoP list the zones it flags, so that FixUtoP visits only those rather than sweeping every zone.
+    // Lists are per-block, indexed by lid, see FixupList.  Not with the ImEx driver's synchronized pflags,
+    // which can flag ghost zones after UtoP
+    bool sparse_fixup = pin->GetOrAddBoolean("perf", "sparse_fixup", false);
+    if (sparse_fixup && driver_type == "imex" && !implicit_grmhd) {
+        cerr << "perf/sparse_fixup can't be used with the ImEx driver unless GRMHD is implicit!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    params.Add("sparse_fixup", sparse_fixup);
+    // Lists have room for 1/sparse_fixup_divisor of each block's zones.  Mostly for testing the fallback
+    // to a full sweep when they overflow, see tests/perf_identity
+    int sparse_fixup_divisor = pin->GetOrAddInteger("perf", "sparse_fixup_divisor", 32);
+    if (sparse_fixup_divisor < 1) {
+        throw std::invalid_argument("perf/sparse_fixup_divisor must be at least 1!");
+    }
+    params.Add("sparse_fixup_divisor", sparse_fixup_divisor);
+    // Apply the floors & ceilings to each zone in the UtoP kernel, just after inverting it, rather than
+    // in separate passes from Floors::ApplyFloors.  GRMHD's UtoP then runs in PostFillDerived, after the
+    // other packages have filled their primitives (e.g. B) from U, see PostFillDerivedBlock
+    bool fused_utop_floors = pin->GetOrAddBoolean("perf", "fused_utop_floors", false);
+    if (fused_utop_floors && (driver_type != "harm" || batch_utop)) {
+        cerr << "perf/fused_utop_floors requires the HARM driver, and can't be combined with perf/batch_utop!" << endl;
+        throw std::invalid_argument("Unsupported performance options!");
+    }
+    params.Add("fused_utop_floors", fused_utop_floors);
+    params.Add("fixup_list", ParArray2D<int>(), true);
+    params.Add("fixup_count", ParArray1D<int>(), true);
 
     // Adaptive mesh refinement options
     // Only active if "refinement" and "numlevel" parameters allow
@@ -266,24 +421,60 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     // so they are allocated only by B field packages.
 
     // Maximum signal speed (magnitude).
-    // Needs to be cached from flux updates for calculating the timestep later
-    m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_vector);
-    pkg->AddField("ctop", m);
+    // Needs to be cached from flux updates for calculating the timestep later,
+    // unless we're reducing it on the fly (see perf/reduce_ctop above)
+    if (store_ctop) {
+        m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy}, s_vector);
+        pkg->AddField("ctop", m);
+    }
 
     // Flag denoting UtoP inversion failures
-    // Only needed if we're actually calling UtoP, but always allocated as it's retrieved often
-    // Needs boundary sync if treating primitive variables as fundamental
-    if (driver_type == "imex" && !implicit_grmhd) {
+    // Kept as one int8 per zone outside of Parthenon's (Real-only) fields, see PFlags.
+    // The field "pflag" is only a copy, allocated for output or for the boundary sync needed
+    // when treating primitive variables as fundamental
+    params.Add("pflags", ParArray4D<int8_t>(), true);
+    const bool sync_pflag = driver_type == "imex" && !implicit_grmhd;
+    params.Add("sync_pflag", sync_pflag);
+    if (sync_pflag) {
         m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy, Metadata::FillGhost});
-    } else {
+        pkg->AddField("pflag", m);
+    } else if (OutputRequested(pin, "pflag")) {
         m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+        pkg->AddField("pflag", m);
+    }
+
+    // Converged W' of each zone's last inversion, and the iterations it took, see perf/cache_wp & perf/utop_histogram
+    if (cache_wp) {
+        m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+        pkg->AddField("utop_wp", m);
+    }
+    if (utop_histogram) {
+        m = Metadata({Metadata::Real, Metadata::Cell, Metadata::Derived, Metadata::OneCopy});
+        pkg->AddField("utop_niter", m);
+
+        // One history entry per iteration count, up to the most the inverter can take
+        const int niter_max = (params.Get<InversionType>("inverter") == InversionType::onedw) ? UTOP_ITER_MAX + 1
+                                                                                                : inverter_iter_max;
+        parthenon::HstVar_list hst_vars = {};
+        for (int n = 0; n <= niter_max; ++n) {
+            hst_vars.emplace_back(parthenon::HistoryOutputVar(UserHistoryOperation::sum,
+                                  [n](MeshData<Real> *md) { return GRMHD::CountUtoPIterations(md, n); },
+                                  "UtoP_niter_" + std::to_string(n)));
+        }
+        pkg->AddParam<>(parthenon::hist_param_key, hst_vars);
     }
-    pkg->AddField("pflag", m);
 
     if (!implicit_grmhd) {
         // If we're using a step that requires calling UtoP, register it
         // Calling this messes up implicit stepping, so we only register it here
-        pkg->FillDerivedBlock = GRMHD::FillDerivedBlock;
+        // The MeshData version is used with perf/mesh_utop, see HARMDriver
+        if (fused_utop_floors) {
+            pkg->PostFillDerivedMesh = GRMHD::PostFillDerivedMesh;
+            pkg->PostFillDerivedBlock = GRMHD::PostFillDerivedBlock;
+        } else {
+            pkg->FillDerivedMesh = GRMHD::FillDerivedMesh;
+            pkg->FillDerivedBlock = GRMHD::FillDerivedBlock;
+        }
     }
 
     // Finally, the StateDescriptor/Package object determines the Callbacks Parthenon makes to
@@ -297,18 +488,145 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
     return pkg;
 }
 
-void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
+void UtoP(MeshData<Real> *md, IndexDomain domain, bool coarse, bool fuse_floors)
+{
+    Flag(md, "Filling Primitives Mesh");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    // Floors need the full set of primitives
+    PackIndexMap prims_map, cons_map;
+    const auto& U = GRMHD::PackMHDCons(md, cons_map);
+    const auto& P = fuse_floors ? GRMHD::PackMHDPrims(md, prims_map) : GRMHD::PackHDPrims(md, prims_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+
+    const auto pflag = PFlags(pmb0.get());
+    const auto fflag = fuse_floors ? Floors::FFlags(pmb0.get()) : ParArray4D<int16_t>();
+    const Floors::Prescription floors(pmb0->packages.Get("Floors")->AllParams(), md);
+
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const bool batch_utop = pmb0->packages.Get("GRMHD")->Param<bool>("batch_utop");
+    const InversionSettings inv(pmb0->packages.Get("GRMHD")->AllParams());
+    // Conserved entropy for inv.entropy_fallback.  Empty if not present
+    const auto& Ktot = md->PackVariables(std::vector<std::string>{"cons.Ktot"});
+    // Cached W' & iteration counts for perf/cache_wp & perf/utop_histogram.  Likewise
+    const auto& Wp = md->PackVariables(std::vector<std::string>{"utop_wp"});
+    const auto& niter_zone = md->PackVariables(std::vector<std::string>{"utop_niter"});
+
+    // See the MeshBlockData version below for notes on which zones are inverted
+    auto bounds = coarse ? pmb0->c_cellbounds : pmb0->cellbounds;
+    const IndexRange ib = bounds.GetBoundsI(domain);
+    const IndexRange jb = bounds.GetBoundsJ(domain);
+    const IndexRange kb = bounds.GetBoundsK(domain);
+    const IndexRange ib_b = bounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb_b = bounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb_b = bounds.GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+    // Blocks sitting out this step under local timestepping keep their primitives,
+    // except in any x1 ghost zones interpolated for their next step, see LocalTimestep::BlockFilled
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb0.get());
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+
+    // List the zones flagged for FixUtoP, see perf/sparse_fixup.  Only when inverting the whole block
+    // as usual: otherwise the count is set past the end of the list, and FixUtoP sweeps the block
+    const bool sparse_fixup = pmb0->packages.Get("GRMHD")->Param<bool>("sparse_fixup");
+    const bool record_fixups = sparse_fixup && domain == IndexDomain::entire && !coarse;
+    const auto fixup_list = sparse_fixup ? FixupList(pmb0.get()) : ParArray2D<int>();
+    const auto fixup_count = sparse_fixup ? FixupCount(pmb0.get()) : ParArray1D<int>();
+    const int n1 = ib.e + 1, n2 = jb.e + 1;
+    if (sparse_fixup) {
+        const int count_start = record_fixups ? 0 : fixup_list.extent_int(1) + 1;
+        pmb0->par_for("reset_fixup_count", block.s, block.e,
+            KOKKOS_LAMBDA (const int &b) {
+                fixup_count(lid0 + b) = count_start;
+            }
+        );
+    }
+
+    if (batch_utop) {
+        const int nbatch = (ib.e - ib.s + UTOP_BATCH) / UTOP_BATCH;
+        pmb0->par_for("U_to_P_batch", block.s, block.e, kb.s, kb.e, jb.s, jb.e, 0, nbatch - 1,
+            KOKKOS_LAMBDA (const int &b, const int &k, const int &j, const int &n) {
+                if (!steps.is_filled(gid0 + b)) return;
+                const auto& G = U.GetCoords(b);
+                const int is = ib.s + n * UTOP_BATCH;
+                bool active[UTOP_BATCH];
+                InversionStatus status[UTOP_BATCH];
+                for (int l = 0; l < UTOP_BATCH; ++l) {
+                    const int i = is + l;
+                    active[l] = i <= ib.e && steps.fills_zone(gid0 + b, i, ib_b) && (inside(k, j, i, kb_b, jb_b, ib_b) ||
+                                abs(P(b, m_p.RHO, k, j, i)) > SMALL || abs(P(b, m_p.UU, k, j, i)) > SMALL);
+                }
+                GRMHD::u_to_p_batch<UTOP_BATCH>(G, U(b), m_u, gam, k, j, is, Loci::center, P(b), m_p, active, status);
+                for (int l = 0; l < UTOP_BATCH && is + l <= ib.e; ++l) {
+                    const int i = is + l;
+                    if (!steps.fills_zone(gid0 + b, i, ib_b)) continue;
+                    const Real K = inv.entropy_fallback ? Ktot(b, 0, k, j, i) / U(b, m_u.RHO, k, j, i) : 0.;
+                    pflag(lid0 + b, k, j, i) = active[l] ? GRMHD::u_to_p_fallback(inv, G, U(b), m_u, gam, K, k, j, i,
+                                                                                  Loci::center, P(b), m_p, status[l]) : -1;
+                    if (record_fixups && pflag(lid0 + b, k, j, i) > InversionStatus::success)
+                        record_fixup(fixup_list, fixup_count, lid0 + b, k, j, i, n2, n1);
+                }
+            }
+        );
+        CopyPFlags(md, false);
+        Flag(md, "Filled");
+        return;
+    }
+
+    pmb0->par_for("U_to_P", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D {
+            if (!steps.fills_zone(gid0 + b, i, ib_b)) return;
+            const auto& G = U.GetCoords(b);
+            if (inside(k, j, i, kb_b, jb_b, ib_b) ||
+                abs(P(b, m_p.RHO, k, j, i)) > SMALL || abs(P(b, m_p.UU, k, j, i)) > SMALL) {
+                int niter;
+                const InversionStatus status = inv.cache_wp ?
+                    GRMHD::u_to_p_cached(G, U(b), m_u, gam, k, j, i, Loci::center, P(b), m_p, Wp(b, 0, k, j, i), niter) :
+                    GRMHD::u_to_p_select(inv, G, U(b), m_u, gam, k, j, i, Loci::center, P(b), m_p, niter);
+                if (inv.histogram) niter_zone(b, 0, k, j, i) = niter;
+                const Real K = inv.entropy_fallback ? Ktot(b, 0, k, j, i) / U(b, m_u.RHO, k, j, i) : 0.;
+                pflag(lid0 + b, k, j, i) = GRMHD::u_to_p_fallback(inv, G, U(b), m_u, gam, K, k, j, i, Loci::center,
+                                                                  P(b), m_p, status);
+                if (record_fixups && pflag(lid0 + b, k, j, i) > InversionStatus::success)
+                    record_fixup(fixup_list, fixup_count, lid0 + b, k, j, i, n2, n1);
+                // Floors & ceilings as in Floors::ApplyFloors, on the same zones
+                if (fuse_floors && pflag(lid0 + b, k, j, i) >= InversionStatus::success) {
+                    const int comboflag = Floors::apply_floors(G, P(b), m_p, gam, k, j, i, floors.for_block(lid0 + b), U(b), m_u);
+                    const int addflag = Floors::apply_ceilings(G, P(b), m_p, gam, k, j, i, floors, U(b), m_u);
+                    fflag(lid0 + b, k, j, i) = ((comboflag / HIT_FLOOR_GEOM_RHO) * HIT_FLOOR_GEOM_RHO) | addflag;
+                }
+            } else {
+                pflag(lid0 + b, k, j, i) = -1;
+            }
+        }
+    );
+    CopyPFlags(md, false);
+    Flag(md, "Filled");
+}
+
+void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse, bool fuse_floors)
 {
     Flag(rc, "Filling Primitives");
     auto pmb = rc->GetBlockPointer();
     const auto& G = pmb->coords;
 
+    // Blocks sitting out this step under local timestepping keep their primitives,
+    // except in any x1 ghost zones interpolated for their next step, see LocalTimestep::BlockFilled
+    if (!LocalTimestep::BlockFilled(pmb.get())) return;
+    const LocalTimestep::BlockSteps steps = LocalTimestep::GetBlockSteps(pmb.get());
+    const int gid = pmb->gid;
+
     PackIndexMap prims_map, cons_map;
     auto U = GRMHD::PackMHDCons(rc, cons_map);
-    auto P = GRMHD::PackHDPrims(rc, prims_map);
+    auto P = fuse_floors ? GRMHD::PackMHDPrims(rc, prims_map) : GRMHD::PackHDPrims(rc, prims_map);
     const VarMap m_u(cons_map, true), m_p(prims_map, false);
 
-    GridScalar pflag = rc->Get("pflag").data;
+    const auto pflag = PFlags(pmb.get());
+    const int lid = pmb->lid;
+    // Flags & prescription for floors applied in the same kernel, see PostFillDerivedBlock
+    const auto fflag = fuse_floors ? Floors::FFlags(pmb.get()) : ParArray4D<int16_t>();
+    const Floors::Prescription floors(pmb->packages.Get("Floors")->AllParams(), pmb.get());
 
     // KHARMA uses only one boundary exchange, in the conserved variables
     // Except where FixUtoP has no neighbors, and must fix with bad zones, this is fully identical
@@ -317,6 +635,13 @@ void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     // used in the same way for fixups.  If it fails & thus might be different, it is ignored.
 
     const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
+    const bool batch_utop = pmb->packages.Get("GRMHD")->Param<bool>("batch_utop");
+    const InversionSettings inv(pmb->packages.Get("GRMHD")->AllParams());
+    // Conserved entropy for inv.entropy_fallback.  Empty if not present
+    auto Ktot = rc->PackVariables(std::vector<std::string>{"cons.Ktot"});
+    // Cached W' & iteration counts for perf/cache_wp & perf/utop_histogram.  Likewise
+    auto Wp = rc->PackVariables(std::vector<std::string>{"utop_wp"});
+    auto niter_zone = rc->PackVariables(std::vector<std::string>{"utop_niter"});
 
     // Get the primitives from our conserved versions
     // Currently this returns *all* zones, including all ghosts, even
@@ -334,21 +659,97 @@ void UtoP(MeshBlockData<Real> *rc, IndexDomain domain, bool coarse)
     const IndexRange jb_b = bounds.GetBoundsJ(IndexDomain::interior);
     const IndexRange kb_b = bounds.GetBoundsK(IndexDomain::interior);
 
+    // List the zones flagged for FixUtoP, see the MeshData version above
+    const bool sparse_fixup = pmb->packages.Get("GRMHD")->Param<bool>("sparse_fixup");
+    const bool record_fixups = sparse_fixup && domain == IndexDomain::entire && !coarse;
+    const auto fixup_list = sparse_fixup ? FixupList(pmb.get()) : ParArray2D<int>();
+    const auto fixup_count = sparse_fixup ? FixupCount(pmb.get()) : ParArray1D<int>();
+    const int n1 = ib.e + 1, n2 = jb.e + 1;
+    if (sparse_fixup) {
+        Kokkos::deep_copy(Kokkos::subview(fixup_count, lid), record_fixups ? 0 : fixup_list.extent_int(1) + 1);
+    }
+
+    if (batch_utop) {
+        // Same selection of zones as below, in groups of UTOP_BATCH along each row.  See perf/batch_utop
+        const int nbatch = (ib.e - ib.s + UTOP_BATCH) / UTOP_BATCH;
+        pmb->par_for("U_to_P_batch", kb.s, kb.e, jb.s, jb.e, 0, nbatch - 1,
+            KOKKOS_LAMBDA (const int &k, const int &j, const int &n) {
+                const int is = ib.s + n * UTOP_BATCH;
+                bool active[UTOP_BATCH];
+                InversionStatus status[UTOP_BATCH];
+                for (int l = 0; l < UTOP_BATCH; ++l) {
+                    const int i = is + l;
+                    active[l] = i <= ib.e && steps.fills_zone(gid, i, ib_b) && (inside(k, j, i, kb_b, jb_b, ib_b) ||
+                                abs(P(m_p.RHO, k, j, i)) > SMALL || abs(P(m_p.UU, k, j, i)) > SMALL);
+                }
+                GRMHD::u_to_p_batch<UTOP_BATCH>(G, U, m_u, gam, k, j, is, Loci::center, P, m_p, active, status);
+                for (int l = 0; l < UTOP_BATCH && is + l <= ib.e; ++l) {
+                    const int i = is + l;
+                    if (!steps.fills_zone(gid, i, ib_b)) continue;
+                    const Real K = inv.entropy_fallback ? Ktot(0, k, j, i) / U(m_u.RHO, k, j, i) : 0.;
+                    pflag(lid, k, j, i) = active[l] ? GRMHD::u_to_p_fallback(inv, G, U, m_u, gam, K, k, j, i,
+                                                                             Loci::center, P, m_p, status[l]) : -1;
+                    if (record_fixups && pflag(lid, k, j, i) > InversionStatus::success)
+                        record_fixup(fixup_list, fixup_count, lid, k, j, i, n2, n1);
+                }
+            }
+        );
+        CopyPFlags(rc, false);
+        Flag(rc, "Filled");
+        return;
+    }
+
     pmb->par_for("U_to_P", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_3D {
+            if (!steps.fills_zone(gid, i, ib_b)) return;
             if (inside(k, j, i, kb_b, jb_b, ib_b) ||
                 abs(P(m_p.RHO, k, j, i)) > SMALL || abs(P(m_p.UU, k, j, i)) > SMALL) {
                 // Run over all interior zones and any initialized ghosts
-                pflag(k, j, i) = GRMHD::u_to_p(G, U, m_u, gam, k, j, i, Loci::center, P, m_p);
+                int niter;
+                const InversionStatus status = inv.cache_wp ?
+                    GRMHD::u_to_p_cached(G, U, m_u, gam, k, j, i, Loci::center, P, m_p, Wp(0, k, j, i), niter) :
+                    GRMHD::u_to_p_select(inv, G, U, m_u, gam, k, j, i, Loci::center, P, m_p, niter);
+                if (inv.histogram) niter_zone(0, k, j, i) = niter;
+                const Real K = inv.entropy_fallback ? Ktot(0, k, j, i) / U(m_u.RHO, k, j, i) : 0.;
+                pflag(lid, k, j, i) = GRMHD::u_to_p_fallback(inv, G, U, m_u, gam, K, k, j, i, Loci::center, P, m_p, status);
+                if (record_fixups && pflag(lid, k, j, i) > InversionStatus::success)
+                    record_fixup(fixup_list, fixup_count, lid, k, j, i, n2, n1);
+                // Apply floors & ceilings while this zone's state is still in cache.  As in Floors::ApplyFloors,
+                // this includes zones which failed to invert, and drops the flag apply_floors returns in the bottom bits
+                if (fuse_floors && pflag(lid, k, j, i) >= InversionStatus::success) {
+                    const int comboflag = Floors::apply_floors(G, P, m_p, gam, k, j, i, floors, U, m_u);
+                    const int addflag = Floors::apply_ceilings(G, P, m_p, gam, k, j, i, floors, U, m_u);
+                    fflag(lid, k, j, i) = ((comboflag / HIT_FLOOR_GEOM_RHO) * HIT_FLOOR_GEOM_RHO) | addflag;
+                }
             } else {
                 // Don't *use* un-initialized zones for fixes, but also don't *fix* them
-                pflag(k, j, i) = -1;
+                pflag(lid, k, j, i) = -1;
             }
         }
     );
+    CopyPFlags(rc, false);
     Flag(rc, "Filled");
 }
 
+TaskStatus PostFillDerivedMesh(MeshData<Real> *md)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    // Floors are applied under the same conditions as Floors::PostFillDerivedMesh, which then does nothing
+    const bool apply_floors = !pmb0->packages.Get("Floors")->Param<bool>("disable_floors") &&
+                              pmb0->packages.Get("Globals")->Param<bool>("in_loop");
+    UtoP(md, IndexDomain::entire, false, apply_floors);
+    return TaskStatus::complete;
+}
+
+TaskStatus PostFillDerivedBlock(MeshBlockData<Real> *rc)
+{
+    auto pmb = rc->GetBlockPointer();
+    const bool apply_floors = !pmb->packages.Get("Floors")->Param<bool>("disable_floors") &&
+                              pmb->packages.Get("Globals")->Param<bool>("in_loop");
+    UtoP(rc, IndexDomain::entire, false, apply_floors);
+    return TaskStatus::complete;
+}
+
 Real EstimateTimestep(MeshBlockData<Real> *rc)
 {
     Flag(rc, "Estimating timestep");
@@ -357,7 +758,6 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
     IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
     IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
     const auto& G = pmb->coords;
-    auto& ctop = rc->Get("ctop").data;
 
     // TODO: move timestep limiter into an override of SetGlobalTimestep
     // TODO: move diagnostic printing to PostStepDiagnostics, now it's broken here
@@ -392,25 +792,46 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
         return globals.Get<double>("dt_light");
     }
 
-    typename Kokkos::MinMax<Real>::value_type minmax;
-    pmb->par_reduce("ndt_min", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
-        KOKKOS_LAMBDA(const int k, const int j, const int i,
-                      typename Kokkos::MinMax<Real>::value_type &lminmax) {
-            double ndt_zone = 1 / (1 / (G.dx1v(i) / ctop(0, k, j, i)) +
-                                   1 / (G.dx2v(j) / ctop(1, k, j, i)) +
-                                   1 / (G.dx3v(k) / ctop(2, k, j, i)));
-            // Effective "max speed" used for the timestep
-            double ctop_max_zone = min(G.dx1v(i), min(G.dx2v(j), G.dx3v(k))) / ndt_zone;
-
-            if (!isnan(ndt_zone) && (ndt_zone < lminmax.min_val))
-                lminmax.min_val = ndt_zone;
-            if (!isnan(ctop_max_zone) && (ctop_max_zone > lminmax.max_val))
-                lminmax.max_val = ctop_max_zone;
-        }
-    , Kokkos::MinMax<Real>(minmax));
     // Keep dt to do some checks below
-    const double min_ndt = minmax.min_val;
-    const double nctop = minmax.max_val;
+    double min_ndt, nctop;
+    const int lid = pmb->lid;
+    // Copied once for all blocks, after the last stage's fluxes, see FetchCtopBuffer
+    const bool reduce_ctop = grmhd_pars.Get<bool>("reduce_ctop");
+    const auto ctop_block_h = (reduce_ctop) ? grmhd_pars.Get<ParArray2D<Real>::HostMirror>("ctop_block_h")
+                                            : ParArray2D<Real>::HostMirror();
+    const Real ctop_block_sum = (lid < ctop_block_h.extent_int(0)) ?
+                                ctop_block_h(lid, 0) + ctop_block_h(lid, 1) + ctop_block_h(lid, 2) : 0.;
+    // Blocks which took no fluxes this step (idle under local timestepping) have no maxima,
+    // and use the full scan of their stored ctop below
+    if (reduce_ctop && (ctop_block_sum > 0. || !grmhd_pars.Get<bool>("store_ctop"))) {
+        // Use the per-block maxima of ctop/dx reduced during the flux calculation.
+        // Taking the max in each direction separately makes this slightly more conservative than
+        // the per-zone minimum below.  A block with no signal speed at all has no CFL limit, and gets dt_max
+        min_ndt = 1 / ctop_block_sum;
+        // Zones are uniform in the native coordinates, so the first zone's widths are every zone's,
+        // and this is the same effective "max speed" as below, from the (smaller) separable min_ndt
+        nctop = std::min(G.dx1v(ib.s), std::min(G.dx2v(jb.s), G.dx3v(kb.s))) / min_ndt;
+    } else {
+        auto& ctop = rc->Get("ctop").data;
+        typename Kokkos::MinMax<Real>::value_type minmax;
+        pmb->par_reduce("ndt_min", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA(const int k, const int j, const int i,
+                          typename Kokkos::MinMax<Real>::value_type &lminmax) {
+                double ndt_zone = 1 / (1 / (G.dx1v(i) / ctop(0, k, j, i)) +
+                                       1 / (G.dx2v(j) / ctop(1, k, j, i)) +
+                                       1 / (G.dx3v(k) / ctop(2, k, j, i)));
+                // Effective "max speed" used for the timestep
+                double ctop_max_zone = min(G.dx1v(i), min(G.dx2v(j), G.dx3v(k))) / ndt_zone;
+
+                if (!isnan(ndt_zone) && (ndt_zone < lminmax.min_val))
+                    lminmax.min_val = ndt_zone;
+                if (!isnan(ctop_max_zone) && (ctop_max_zone > lminmax.max_val))
+                    lminmax.max_val = ctop_max_zone;
+            }
+        , Kokkos::MinMax<Real>(minmax));
+        min_ndt = minmax.min_val;
+        nctop = minmax.max_val;
+    }
 
     // Apply limits
     const double cfl = grmhd_pars.Get<double>("cfl");
@@ -425,9 +846,148 @@ Real EstimateTimestep(MeshBlockData<Real> *rc)
     }
 
     Flag(rc, "Estimated");
+    // With local timestepping, the block's own limit sets its level, see LocalTimestep
+    if (pmb->packages.AllPackages().count("LocalTimestep")) {
+        return LocalTimestep::BlockTimestep(pmb.get(), std::max(min_ndt * cfl, dt_min), ndt);
+    }
     return ndt;
 }
 
+ParArray2D<Real> CtopBuffer(MeshBlock *pmb)
+{
+    auto& params = pmb->packages.Get("GRMHD")->AllParams();
+    auto ctop_block = params.Get<ParArray2D<Real>>("ctop_block");
+    // (Re)allocate when first used, or when the number of blocks on this rank changes on remesh.
+    // New buffers start zeroed
+    const int nblocks = pmb->pmy_mesh->block_list.size();
+    if (ctop_block.extent_int(0) != nblocks) {
+        ctop_block = ParArray2D<Real>("ctop_block", nblocks, NVEC);
+        params.Update<ParArray2D<Real>>("ctop_block", ctop_block);
+    }
+    return ctop_block;
+}
+
+TaskStatus FetchCtopBuffer(Mesh *pmesh)
+{
+    auto& params = pmesh->packages.Get("GRMHD")->AllParams();
+    if (!params.Get<bool>("reduce_ctop") || pmesh->block_list.size() == 0) return TaskStatus::complete;
+    // Copy all blocks' maxima at once, and zero them for the next step.
+    // Zeroing every step also clears any entries left over from blocks moved by a remesh
+    auto ctop_block = CtopBuffer(pmesh->block_list[0].get());
+    auto ctop_block_h = params.Get<ParArray2D<Real>::HostMirror>("ctop_block_h");
+    if (ctop_block_h.extent_int(0) != ctop_block.extent_int(0)) {
+        ctop_block_h = Kokkos::create_mirror_view(ctop_block);
+        params.Update<ParArray2D<Real>::HostMirror>("ctop_block_h", ctop_block_h);
+    }
+    Kokkos::deep_copy(ctop_block_h, ctop_block);
+    Kokkos::deep_copy(ctop_block, 0.);
+    return TaskStatus::complete;
+}
+
+ParArray4D<int8_t> PFlags(MeshBlock *pmb)
+{
+    auto& params = pmb->packages.Get("GRMHD")->AllParams();
+    auto pflags = params.Get<ParArray4D<int8_t>>("pflags");
+    // (Re)allocate when first used, or when the number of blocks on this rank changes on remesh
+    const int nblocks = pmb->pmy_mesh->block_list.size();
+    if (pflags.extent_int(0) != nblocks) {
+        const auto& cb = pmb->cellbounds;
+        pflags = ParArray4D<int8_t>("pflags", nblocks, cb.ncellsk(IndexDomain::entire),
+                                    cb.ncellsj(IndexDomain::entire), cb.ncellsi(IndexDomain::entire));
+        params.Update<ParArray4D<int8_t>>("pflags", pflags);
+    }
+    return pflags;
+}
+
+void CopyPFlags(MeshBlockData<Real> *rc, bool from_field)
+{
+    auto pmb = rc->GetBlockPointer();
+    const bool sync_pflag = pmb->packages.Get("GRMHD")->Param<bool>("sync_pflag");
+    if (!sync_pflag) return;
+
+    const auto pflag = PFlags(pmb.get());
+    const int lid = pmb->lid;
+    GridScalar pflag_field = rc->Get("pflag").data;
+
+    const IndexRange ib = rc->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = rc->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = rc->GetBoundsK(IndexDomain::entire);
+    if (from_field) {
+        pmb->par_for("copy_pflag_from_field", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA_3D {
+                pflag(lid, k, j, i) = static_cast<int8_t>(pflag_field(k, j, i));
+            }
+        );
+    } else {
+        pmb->par_for("copy_pflag_to_field", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+            KOKKOS_LAMBDA_3D {
+                pflag_field(k, j, i) = pflag(lid, k, j, i);
+            }
+        );
+    }
+}
+
+void CopyPFlags(MeshData<Real> *md, bool from_field)
+{
+    // Only needed for the ImEx driver's primitive sync, so not worth a kernel over the whole pack
+    for (int b = 0; b < md->NumBlocks(); ++b) {
+        CopyPFlags(md->GetBlockData(b).get(), from_field);
+    }
+}
+
+void FillOutput(MeshBlock *pmb, ParameterInput *pin)
+{
+    // Copy the flags into the Real field "pflag", if it was allocated for output.
+    // With sync_pflag it's already kept up to date, see CopyPFlags
+    auto rc = pmb->meshblock_data.Get().get();
+    if (pmb->packages.Get("GRMHD")->Param<bool>("sync_pflag") || !OutputRequested(pin, "pflag")) return;
+
+    const auto pflag = PFlags(pmb);
+    const int lid = pmb->lid;
+    GridScalar pflag_field = rc->Get("pflag").data;
+
+    const IndexRange ib = rc->GetBoundsI(IndexDomain::entire);
+    const IndexRange jb = rc->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = rc->GetBoundsK(IndexDomain::entire);
+    pmb->par_for("fill_output_pflag", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_3D {
+            pflag_field(k, j, i) = pflag(lid, k, j, i);
+        }
+    );
+}
+
+Real CountUtoPIterations(MeshData<Real> *md, const int n)
+{
+    auto niter_zone = md->PackVariables(std::vector<std::string>{"utop_niter"});
+
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, niter_zone.GetDim(5) - 1};
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    Real count;
+    Kokkos::Sum<Real> count_reducer(count);
+    pmb0->par_reduce("UtoP_niter_count", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_MESH_3D_REDUCE {
+            if (static_cast<int>(niter_zone(b, 0, k, j, i)) == n) local_result += 1.;
+        }
+    , count_reducer);
+    return count;
+}
+
+bool OutputRequested(ParameterInput *pin, const std::string& var)
+{
+    for (InputBlock *pib = pin->pfirst_block; pib != nullptr; pib = pib->pnext) {
+        if (pib->block_name.compare(0, 16, "parthenon/output") == 0 &&
+            pin->DoesParameterExist(pib->block_name, "variables")) {
+            const std::string vars = pin->GetString(pib->block_name, "variables");
+            if (vars.find(var) != std::string::npos) return true;
+        }
+    }
+    return false;
+}
+
 Real EstimateRadiativeTimestep(MeshBlockData<Real> *rc)
 {
     Flag(rc, "Estimating shortest light crossing time");
@@ -68,12 +68,20 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t pack
  * input: U, whatever form
  * output: U and P match down to inversion errors
  */
-// void UtoP(MeshData<Real> *md, IndexDomain domain=IndexDomain::entire, bool coarse=false);
-// inline void FillDerivedMesh(MeshData<Real> *md) { UtoP(md); }
-void UtoP(MeshBlockData<Real> *rc, IndexDomain domain=IndexDomain::entire, bool coarse=false);
+void UtoP(MeshData<Real> *md, IndexDomain domain=IndexDomain::entire, bool coarse=false, bool fuse_floors=false);
+inline void FillDerivedMesh(MeshData<Real> *md) { UtoP(md); }
+void UtoP(MeshBlockData<Real> *rc, IndexDomain domain=IndexDomain::entire, bool coarse=false, bool fuse_floors=false);
 inline void FillDerivedBlock(MeshBlockData<Real> *rc) { UtoP(rc); }
 inline TaskStatus FillDerivedBlockTask(MeshBlockData<Real> *rc) { UtoP(rc); return TaskStatus::complete; }
 
+/**
+ * UtoP with the floors & ceilings applied in the same kernel (fuse_floors above), for perf/fused_utop_floors.
+ * Registered as PostFillDerived instead of FillDerived, so that the other packages' primitives are
+ * filled first.  Floors::PostFillDerived* then do nothing
+ */
+TaskStatus PostFillDerivedMesh(MeshData<Real> *md);
+TaskStatus PostFillDerivedBlock(MeshBlockData<Real> *rc);
+
 /**
  * Fix the primitive variables
  * Applies floors to the calculated primitives, and fixes up any failed inversions
@@ -95,6 +103,46 @@ Real EstimateTimestep(MeshBlockData<Real> *rc);
 // Internal version for the light phase speed crossing time of smallest zone
 Real EstimateRadiativeTimestep(MeshBlockData<Real> *rc);
 
+/**
+ * Returns the per-block maxima of ctop/dx in each direction, used for the timestep with perf/reduce_ctop.
+ * Indexed (lid, dir-1), filled by the flux kernels and reset by FetchCtopBuffer.
+ * Allocated on first use and re-allocated if the number of blocks on this rank changes.
+ */
+ParArray2D<Real> CtopBuffer(MeshBlock *pmb);
+
+/**
+ * Copy CtopBuffer for all blocks on this rank to the host param "ctop_block_h", and zero it for the next step.
+ * Added by the drivers as a task on the last stage, in a region of its own between the flux calculation
+ * and EstimateTimestep, which then only reads the copy.
+ */
+TaskStatus FetchCtopBuffer(Mesh *pmesh);
+
+/**
+ * Returns the UtoP inversion flags of all blocks on this rank, indexed (lid, k, j, i).
+ * Values are InversionStatus, or -1 for zones which weren't inverted.
+ * Stored as int8 rather than in a Real field, and copied to the field "pflag" only for output.
+ * Allocated on first use and re-allocated if the number of blocks changes.
+ */
+ParArray4D<int8_t> PFlags(MeshBlock *pmb);
+
+/**
+ * Copy the flags to (or back from) the field "pflag", only when it is synchronized as a primitive variable
+ * under the ImEx driver.  A no-op otherwise
+ */
+void CopyPFlags(MeshBlockData<Real> *rc, bool from_field);
+void CopyPFlags(MeshData<Real> *md, bool from_field);
+
+/**
+ * Returns the number of interior zones whose last inversion took n iterations, for perf/utop_histogram.
+ * Registered as one history output per n
+ */
+Real CountUtoPIterations(MeshData<Real> *md, const int n);
+
+/**
+ * Returns whether a variable is listed in any output block of the input file
+ */
+bool OutputRequested(ParameterInput *pin, const std::string& var);
+
 /**
  * Return a tag per-block indicating whether to refine it
  * 
@@ -104,7 +152,7 @@ AmrTag CheckRefinement(MeshBlockData<Real> *rc);
 
 /**
  * Fill fields which are calculated only for output to file
- * Currently just the current jcon
+ * Currently just the inversion flags "pflag", see PFlags
  */
 void FillOutput(MeshBlock *pmb, ParameterInput *pin);
 
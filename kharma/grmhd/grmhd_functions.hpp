@@ -201,7 +201,8 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const GridVector
     G.lower(D.bcon, D.bcov, k, j, i, loc);
 }
 // Primitive/VarMap versions of calc_4vecs for kernels that use "packed" primitives
-template<typename Local>
+// Optionally templated on the set of packages, so the B field check can be made at compile time
+template<int Pkgs=PackageSet::runtime, typename Local>
 KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Local& P, const VarMap& m,
                                       const int& j, const int& i, const Loci loc, FourVectors& D)
 {
@@ -213,7 +214,7 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Local& P, c
 
     G.lower(D.ucon, D.ucov, 0, j, i, loc);
 
-    if (m.B1 >= 0) {
+    if (has_b<Pkgs>(m)) {
         D.bcon[0] = 0;
         VLOOP D.bcon[0] += P(m.B1 + v) * D.ucov[v+1];
         VLOOP D.bcon[v+1] = (P(m.B1 + v) + D.bcon[0] * D.ucon[v+1]) / D.ucon[0];
@@ -223,7 +224,7 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Local& P, c
         DLOOP1 D.bcon[mu] = D.bcov[mu] = 0.;
     }
 }
-template<typename Global>
+template<int Pkgs=PackageSet::runtime, typename Global>
 KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Global& P, const VarMap& m,
                                       const int& k, const int& j, const int& i, const Loci loc, FourVectors& D)
 {
@@ -235,7 +236,7 @@ KOKKOS_INLINE_FUNCTION void calc_4vecs(const GRCoordinates& G, const Global& P,
 
     G.lower(D.ucon, D.ucov, k, j, i, loc);
 
-    if (m.B1 >= 0) {
+    if (has_b<Pkgs>(m)) {
         D.bcon[0] = 0;
         VLOOP D.bcon[0] += P(m.B1 + v, k, j, i) * D.ucov[v+1];
         VLOOP D.bcon[v+1] = (P(m.B1 + v, k, j, i) + D.bcon[0] * D.ucon[v+1]) / D.ucon[0];
@@ -36,15 +36,67 @@
 
 #include "decs.hpp"
 #include "grmhd_functions.hpp"
+#include "task_timing.hpp"
+#include "types.hpp"
 
 namespace GRMHD
 {
 
+/**
+ * Calculate the GRMHD source term sqrt(-g) T^mu_nu Gamma^nu_lam_mu in a single zone,
+ * for U (new_du[0]) & U1-3 (new_du[1-3]).
+ * Used in AddSource below and in the fused update kernel Flux::ApplyFluxesAndUpdate
+ */
+template<int Pkgs=PackageSet::runtime, typename Global>
+KOKKOS_INLINE_FUNCTION void calc_source(const GRCoordinates& G, const Global& P, const VarMap& m_p, const Real& gam,
+                                        const int& k, const int& j, const int& i, Real new_du[GR_DIM])
+{
+    FourVectors D;
+    GRMHD::calc_4vecs<Pkgs>(G, P, m_p, k, j, i, Loci::center, D);
+    // Get stuff we don't want to recalculate every loop iteration
+    // This is basically a manual version of GRMHD::calc_tensor but saves recalculating e.g. dot(bcon, bcov) 4 times
+    Real pgas = (gam - 1) * P(m_p.UU, k, j, i);
+    Real bsq = (has_b<Pkgs>(m_p)) ? dot(D.bcon, D.bcov) : 0.;
+    Real eta = pgas + P(m_p.RHO, k, j, i) + P(m_p.UU, k, j, i) + bsq;
+    Real ptot = pgas + 0.5 * bsq;
+
+    // Contract mhd stress tensor with connection, and multiply by metric determinant
+    DLOOP1 new_du[mu] = 0.;
+    DLOOP2 {
+        Real Tmunu = (eta * D.ucon[mu] * D.ucov[nu] +
+                    ptot * (mu == nu) -
+                    D.bcon[mu] * D.bcov[nu]);
+
+        for (int lam = 0; lam < GR_DIM; ++lam) {
+            new_du[lam] += Tmunu * G.gdet_conn(j, i, nu, lam, mu);
+        }
+    }
+}
+
 /**
  * Function to apply the GRMHD source term over the entire grid.
  * 
  * Note Flux::ApplyFluxes = parthenon::FluxDivergence + GRMHD::AddSource
+ *
+ * Templated on the set of packages (see PackageSet in types.hpp), of which only the presence of
+ * B matters here.  Instantiated in source.cpp for PackageSet::grhd, b_field, and runtime.
  */
+template<int Pkgs=PackageSet::runtime>
 TaskStatus AddSource(MeshData<Real> *md, MeshData<Real> *mdudt);
 
+/**
+ * Add the source term task to a list, using the version specialized for the loaded packages
+ */
+inline TaskID AddSourceTask(TaskID& t_start, TaskList& tl, MeshData<Real> *md, MeshData<Real> *mdudt)
+{
+    const int pkgs = SpecializedPackageSet(md->GetBlockData(0)->GetBlockPointer()->packages);
+    if (pkgs == PackageSet::runtime) {
+        return tl.AddTask(t_start, TIMED(GRMHD::AddSource<PackageSet::runtime>), md, mdudt);
+    } else if (pkgs & PackageSet::b_field) {
+        return tl.AddTask(t_start, TIMED(GRMHD::AddSource<PackageSet::b_field>), md, mdudt);
+    } else {
+        return tl.AddTask(t_start, TIMED(GRMHD::AddSource<PackageSet::grhd>), md, mdudt);
+    }
+}
+
 }
@@ -45,6 +45,7 @@
 #include "b_cd.hpp"
 #include "electrons.hpp"
 #include "grmhd.hpp"
+#include "local_timestep.hpp"
 #include "wind.hpp"
 
 #include "boundaries.hpp"
@@ -53,6 +54,52 @@
 #include "flux.hpp"
 #include "resize_restart.hpp"
 #include "source.hpp"
+#include "task_timing.hpp"
+
+LowStorageCoeffs GetLowStorageCoeffs(const std::string& name)
+{
+    LowStorageCoeffs ls;
+    if (name == "ssprk3") {
+        ls.nstages = 3;
+        ls.gam0 = {0., 3./4, 1./3};
+        ls.gam1 = {1., 1./4, 2./3};
+        ls.beta = {1., 1./4, 2./3};
+        ls.delta0 = {0., 0., 0.};
+        ls.delta1 = {0., 0., 0.};
+    } else if (name == "ssprk10_4") {
+        // Five forward Euler steps of dt/6, then the registers are mixed: in Ketcheson's form,
+        // q2 <- q2/25 + 9 q1/25, q1 <- 15 q2 - 5 q1.  Here the q1 update is folded into the fifth stage,
+        // and q2, which replaces U0, is written in terms of the new q1.  Then four more Euler steps,
+        // and the last stage finishes with U0 <- q2 + 3/5 q1 + dt/10 L(q1)
+        ls.nstages = 10;
+        ls.gam0 = {0., 0., 0., 0., 3./5, 0., 0., 0., 0., 1.};
+        ls.gam1 = {1., 1., 1., 1., 2./5, 1., 1., 1., 1., 3./5};
+        ls.beta = {1./6, 1./6, 1./6, 1./6, 1./15, 1./6, 1./6, 1./6, 1./6, 1./10};
+        ls.delta0 = {0., 0., 0., 0., -1./2, 0., 0., 0., 0., 0.};
+        ls.delta1 = {0., 0., 0., 0., 9./10, 0., 0., 0., 0., 0.};
+    } else {
+        cerr << "Low-storage integrator " << name << " not supported!  Supported integrators:" << endl;
+        cerr << "parthenon (use parthenon/time/integrator), ssprk3, ssprk10_4" << endl;
+        throw std::invalid_argument("Unsupported integrator!");
+    }
+    return ls;
+}
+
+HARMDriver::HARMDriver(ParameterInput *pin, ApplicationInput *papp, Mesh *pm) : MultiStageDriver(pin, papp, pm)
+{
+    const std::string name = pin->GetOrAddString("driver", "integrator", "parthenon");
+    low_storage = (name != "parthenon");
+    if (low_storage) {
+        ls = GetLowStorageCoeffs(name);
+        // Parthenon runs the stages we list.  Every intermediate stage shares the one container "1",
+        // and the last stage writes to the base state as usual
+        integrator->nstages = ls.nstages;
+        integrator->beta = ls.beta;
+        integrator->stage_name = std::vector<std::string>(ls.nstages + 1, "1");
+        integrator->stage_name[0] = "base";
+        integrator->stage_name[ls.nstages] = "base";
+    }
+}
 
 TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
 {
@@ -69,6 +116,13 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     Real beta = integrator->beta[stage - 1];
     const Real dt = integrator->dt;
     auto stage_name = integrator->stage_name;
+    // Weights of the base state and the previous stage in this stage's update, see LowStorageCoeffs
+    const Real gam0 = (low_storage) ? ls.gam0[stage - 1] : 1. - beta;
+    const Real gam1 = (low_storage) ? ls.gam1[stage - 1] : beta;
+    // Whether the last stage replaced the base state, which we do once its ghost zones are filled
+    const bool mix_base = low_storage && stage > 1 && ls.delta1[stage - 2] != 0.;
+    // Whether this stage is updated in place, rather than from one container to the next
+    const bool in_place = stage_name[stage - 1] == stage_name[stage];
 
     // Which packages we load affects which tasks we'll add to the list
     auto& pkgs = blocks[0]->packages.AllPackages();
@@ -76,6 +130,25 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     bool use_b_flux_ct = pkgs.count("B_FluxCT");
     bool use_electrons = pkgs.count("Electrons");
     bool use_wind = pkgs.count("Wind");
+    // Whether blocks take different timesteps, see LocalTimestep
+    bool use_local_timestep = pkgs.count("LocalTimestep");
+    // Whether to skip writing dU/dt, see Flux::ApplyFluxesAndUpdate
+    const bool fused_update = pkgs.at("GRMHD")->Param<bool>("fused_update");
+    // Whether to overlap the second boundary sync with the next stage's flux calculation.
+    // If so, every stage but the first starts with this sync still in flight.
+    // Only implemented for packed communications, and disabled with mesh refinement, which needs to prolongate after syncing
+    const bool overlap_comms = pkgs.at("GRMHD")->Param<bool>("overlap_comms") &&
+                               pkgs.at("GRMHD")->Param<bool>("pack_comms") && !pmesh->multilevel;
+    const bool ghosts_in_flight = overlap_comms && stage > 1;
+    // Whether to take this stage's update through a layer of ghost zones deep enough for the remaining
+    // stages, instead of syncing after it.  Only the last stage syncs, see perf/deep_halo
+    const int halo = (pkgs.at("GRMHD")->Param<bool>("deep_halo")) ?
+                     (integrator->nstages - stage) * pkgs.at("GRMHD")->Param<int>("deep_halo_stride") : 0;
+    const bool skip_sync = halo > 0;
+    // Container for this stage's sync, leaving out any fields packages don't need exchanged now
+    const std::string sync_name = skip_sync ? stage_name[stage] :
+                                  KBoundaries::SyncContainer(pmesh, stage_name[stage], stage == integrator->nstages);
+    const bool report_sync_bytes = pkgs.at("Boundaries")->Param<bool>("report_sync_bytes");
 
     // Allocate the fields ("containers") we need block by block
     for (int i = 0; i < blocks.size(); i++) {
@@ -83,12 +156,15 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         // first make other useful containers
         auto &base = pmb->meshblock_data.Get();
         if (stage == 1) {
-            pmb->meshblock_data.Add("dUdt", base);
+            if (!fused_update)
+                pmb->meshblock_data.Add("dUdt", base);
             for (int i = 1; i < integrator->nstages; i++)
                 pmb->meshblock_data.Add(stage_name[i], base);
             // At the end of the step, updating "sc1" updates the base
-            // So we have to keep a copy at the beginning to calculate jcon
-            pmb->meshblock_data.Add("preserve", base);
+            // So we have to keep a copy at the beginning to calculate jcon.
+            // Low-storage integrators keep only the base & stage containers (and dUdt), so they skip it unless jcon is needed
+            if (!low_storage || pkgs.count("Current"))
+                pmb->meshblock_data.Add("preserve", base);
         }
     }
 
@@ -101,46 +177,42 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         auto &mbase = pmesh->mesh_data.GetOrAdd("base", i);
         auto &mc0 = pmesh->mesh_data.GetOrAdd(stage_name[stage - 1], i);
         auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
-        auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
+        auto &msync = pmesh->mesh_data.GetOrAdd(sync_name, i);
+
+        // Finish the last stage's second boundary sync, if it's still going.
+        // Clearing the boundaries waits for our sends, so the buffers are free to use again
+        auto t_ghosts = t_none;
+        if (ghosts_in_flight) {
+            auto t_recv_ghosts = tl.AddTask(t_none, TIMED_AS("cell_centered_bvars::ReceiveBoundaryBuffers (second sync)",
+                                                             cell_centered_bvars::ReceiveBoundaryBuffers), mc0);
+            auto t_set_ghosts = tl.AddTask(t_recv_ghosts, TIMED_AS("cell_centered_bvars::SetBoundaries (second sync)",
+                                                                   cell_centered_bvars::SetBoundaries), mc0);
+            t_ghosts = tl.AddTask(t_set_ghosts, TIMED_AS("KBoundaries::ClearBoundaries (second sync)",
+                                                         KBoundaries::ClearBoundaries), mc0.get());
+        }
 
-        auto t_start_recv = tl.AddTask(t_none, &MeshData<Real>::StartReceiving, mc1.get(),
+        // Replace the base state using the last stage, if the integrator calls for it (see LowStorageCoeffs)
+        auto t_base = t_ghosts;
+        if (mix_base) {
+            t_base = tl.AddTask(t_ghosts, TIMED_AS("Update::WeightedSumData (mix base)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
+                                std::vector<MetadataFlag>({Metadata::Independent}),
+                                mbase.get(), mc0.get(), ls.delta0[stage - 2], ls.delta1[stage - 2], mbase.get());
+        }
+
+        auto t_start_recv = t_ghosts;
+        if (!skip_sync) {
+            t_start_recv = tl.AddTask(t_ghosts, TIMED(&MeshData<Real>::StartReceiving), msync.get(),
                                     BoundaryCommSubset::all);
+        }
 
         // Calculate the HLL fluxes in each direction
         // This reconstructs the primitives (P) at faces and uses them to calculate fluxes
         // of the conserved variables (U)
         // All subsequent operations until FillDerived are applied only to U
-        const ReconstructionType& recon = blocks[0]->packages.Get("GRMHD")->Param<ReconstructionType>("recon");
-        TaskID t_calculate_flux1, t_calculate_flux2, t_calculate_flux3;
-        switch (recon) {
-        case ReconstructionType::donor_cell:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::linear_mc:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::linear_vl:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::weno5:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::ppm:
-        case ReconstructionType::mp5:
-        case ReconstructionType::weno5_lower_poles:
-            cerr << "Reconstruction type not supported!  Supported reconstructions:" << endl;
-            cerr << "donor_cell, linear_mc, linear_vl, weno5" << endl;
-            throw std::invalid_argument("Unsupported reconstruction algorithm!");
-        }
-        auto t_calculate_flux = t_calculate_flux1 | t_calculate_flux2 | t_calculate_flux3;
+        // If the ghost zones are still arriving, fluxes which don't need them are calculated first
+        auto t_calculate_flux = (ghosts_in_flight) ?
+                                Flux::AddFluxCalculations(t_none, t_start_recv, tl, mc0.get()) :
+                                Flux::AddFluxCalculations(t_start_recv, tl, mc0.get(), halo);
 
         auto t_recv_flux = t_calculate_flux;
         // TODO this appears to be implemented *only* block-wise, split it into its own region if so
@@ -149,59 +221,82 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             for (auto &pmb : pmesh->block_list) {
                 auto& rc = pmb->meshblock_data.Get();
                 auto t_send_flux =
-                    tl.AddTask(t_calculate_flux, &MeshBlockData<Real>::SendFluxCorrection, rc.get());
+                    tl.AddTask(t_calculate_flux, TIMED(&MeshBlockData<Real>::SendFluxCorrection), rc.get());
                 t_recv_flux =
-                    tl.AddTask(t_calculate_flux, &MeshBlockData<Real>::ReceiveFluxCorrection, rc.get());
+                    tl.AddTask(t_calculate_flux, TIMED(&MeshBlockData<Real>::ReceiveFluxCorrection), rc.get());
             }
         }
 
         // FIX FLUXES
         // Zero any fluxes through the pole or inflow from outflow boundaries
-        auto t_fix_flux = tl.AddTask(t_recv_flux, KBoundaries::FixFlux, mc0.get());
+        auto t_fix_flux = tl.AddTask(t_recv_flux, TIMED(KBoundaries::FixFlux), mc0.get(), halo);
+
+        // Hold fluxes through faces between timestep levels over each step of the slower side
+        auto t_freeze_flux = t_fix_flux;
+        if (use_local_timestep) {
+            t_freeze_flux = tl.AddTask(t_fix_flux, TIMED(LocalTimestep::FreezeInterfaceFluxes), mc0.get(), stage);
+        }
 
-        auto t_flux_ct = t_fix_flux;
+        auto t_flux_ct = t_freeze_flux;
         if (use_b_flux_ct) {
             // Fix the conserved fluxes (exclusively B1/2/3) so that they obey divB==0,
             // and there is no B field flux through the pole
-            t_flux_ct = tl.AddTask(t_fix_flux, B_FluxCT::TransportB, mc0.get());
+            t_flux_ct = tl.AddTask(t_freeze_flux, TIMED(B_FluxCT::TransportB), mc0.get(), halo);
         }
         auto t_flux_fixed = t_flux_ct;
 
-        // APPLY FLUXES
-        auto t_flux_div = tl.AddTask(t_flux_fixed, Update::FluxDivergence<MeshData<Real>>, mc0.get(), mdudt.get());
-
-        // ADD SOURCES TO CONSERVED VARIABLES
-        // Source term for GRMHD, \Gamma * T
-        // TODO take this out in Minkowski space
-        auto t_grmhd_source = tl.AddTask(t_flux_div, GRMHD::AddSource, mc0.get(), mdudt.get());
-        // Source term for constraint-damping.  Applied only to B
-        auto t_b_cd_source = t_grmhd_source;
-        if (use_b_cd) {
-            t_b_cd_source = tl.AddTask(t_grmhd_source, B_CD::AddSource, mc0.get(), mdudt.get());
-        }
-        // Wind source.  Applied to conserved variables similar to GR source term
-        auto t_wind_source = t_b_cd_source;
-        if (use_wind) {
-            t_wind_source = tl.AddTask(t_b_cd_source, Wind::AddSource, mdudt.get());
+        if (fused_update) {
+            // APPLY FLUXES, ADD SOURCES & UPDATE BASE CONTAINER
+            // All in one kernel, see Flux::ApplyFluxesAndUpdate
+            auto t_ready = t_flux_fixed | t_base;
+            auto t_update = Flux::AddApplyFluxesAndUpdate(t_ready, tl, mc0.get(), mbase.get(), gam0, gam1, beta * dt,
+                                                          mc1.get(), halo);
+        } else {
+            auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
+
+            // APPLY FLUXES
+            auto t_flux_div = tl.AddTask(t_flux_fixed, TIMED(Update::FluxDivergence<MeshData<Real>>), mc0.get(), mdudt.get());
+
+            // ADD SOURCES TO CONSERVED VARIABLES
+            // Source term for GRMHD, \Gamma * T
+            // TODO take this out in Minkowski space
+            auto t_grmhd_source = GRMHD::AddSourceTask(t_flux_div, tl, mc0.get(), mdudt.get());
+            // Source term for constraint-damping.  Applied only to B
+            auto t_b_cd_source = t_grmhd_source;
+            if (use_b_cd) {
+                t_b_cd_source = tl.AddTask(t_grmhd_source, TIMED(B_CD::AddSource), mc0.get(), mdudt.get());
+            }
+            // Wind source.  Applied to conserved variables similar to GR source term
+            auto t_wind_source = t_b_cd_source;
+            if (use_wind) {
+                t_wind_source = tl.AddTask(t_b_cd_source, TIMED(Wind::AddSource), mdudt.get());
+            }
+            // Done with source terms
+            auto t_sources = t_wind_source;
+
+            // UPDATE BASE CONTAINER
+            auto t_avg_data = (low_storage) ?
+                                tl.AddTask(t_sources | t_base, TIMED_AS("Update::WeightedSumData (low-storage update)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
+                                    std::vector<MetadataFlag>({Metadata::Independent}),
+                                    mc0.get(), mbase.get(), gam1, gam0, mc0.get()) :
+                                tl.AddTask(t_sources, TIMED(Update::AverageIndependentData<MeshData<Real>>),
+                                    mc0.get(), mbase.get(), beta);
+            // apply du/dt to all independent fields in the container
+            auto t_update = tl.AddTask(t_avg_data, TIMED(Update::UpdateIndependentData<MeshData<Real>>), mc0.get(),
+                                    mdudt.get(), beta * dt, mc1.get());
         }
-        // Done with source terms
-        auto t_sources = t_wind_source;
-
-        // UPDATE BASE CONTAINER
-        auto t_avg_data = tl.AddTask(t_sources, Update::AverageIndependentData<MeshData<Real>>,
-                                mc0.get(), mbase.get(), beta);
-        // apply du/dt to all independent fields in the container
-        auto t_update = tl.AddTask(t_avg_data, Update::UpdateIndependentData<MeshData<Real>>, mc0.get(),
-                                mdudt.get(), beta * dt, mc1.get());
 
         // U_to_P needs a guess in order to converge, so we copy in sc0
         // (but only the fluid primitives!)  Copying and syncing ensures that solves of the same zone
         // on adjacent ranks are seeded with the same value, which keeps them (more) similar
-        MetadataFlag isPrimitive = pkgs.at("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
-        MetadataFlag isHD = pkgs.at("GRMHD")->Param<MetadataFlag>("HDFlag");
-        auto t_copy_prims = tl.AddTask(t_none, Update::WeightedSumData<MetadataFlag, MeshData<Real>>,
-                                    std::vector<MetadataFlag>({isHD, isPrimitive}),
-                                    mc0.get(), mc0.get(), 1.0, 0.0, mc1.get());
+        // Stages updated in place already have them
+        if (!in_place) {
+            MetadataFlag isPrimitive = pkgs.at("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
+            MetadataFlag isHD = pkgs.at("GRMHD")->Param<MetadataFlag>("HDFlag");
+            auto t_copy_prims = tl.AddTask(t_ghosts, TIMED_AS("Update::WeightedSumData (copy prims)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
+                                        std::vector<MetadataFlag>({isHD, isPrimitive}),
+                                        mc0.get(), mc0.get(), 1.0, 0.0, mc1.get());
+        }
 
     }
 
@@ -210,11 +305,47 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     // Recall this syncs conserved vars *and* primitive vars to seed UtoP correctly
     const auto &pack_comms =
         blocks[0]->packages.Get("GRMHD")->Param<bool>("pack_comms");
-    AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms);
+    if (!skip_sync) {
+        AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms, sync_name);
+    }
+
+    // Copy the signal speeds reduced by the last stage's flux kernels to the host, once for all blocks.
+    // This has to be done in its own region: after every partition's fluxes, before any block's EstimateTimestep
+    if (stage == integrator->nstages && pkgs.at("GRMHD")->Param<bool>("reduce_ctop")) {
+        TaskRegion &ctop_region = tc.AddRegion(1);
+        ctop_region[0].AddTask(t_none, TIMED(GRMHD::FetchCtopBuffer), pmesh);
+    }
+
+    // Bring ghost zones from neighbors at other timestep levels to the time we'll need them
+    if (use_local_timestep) {
+        TaskRegion &lts_region = tc.AddRegion(num_partitions);
+        for (int i = 0; i < num_partitions; i++) {
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+            lts_region[i].AddTask(t_none, TIMED(LocalTimestep::InterpolateGhosts), mc1.get(), stage);
+        }
+    }
+
+    // Optionally fill the primitives, apply floors and fix inversions for each MeshData partition at once,
+    // rather than per-block below.  Without refinement, nothing needs to be done per-block before this
+    const bool mesh_utop = pkgs.at("GRMHD")->Param<bool>("mesh_utop") && !pmesh->multilevel;
+    if (mesh_utop) {
+        TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
+        for (int i = 0; i < num_partitions; i++) {
+            auto &tl = single_tasklist_per_pack_region[i];
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+            auto &msync = pmesh->mesh_data.GetOrAdd(sync_name, i);
+
+            // See the per-block version below for what each of these does
+            auto t_clear_comm_flags = t_none;
+            if (!skip_sync)
+                t_clear_comm_flags = tl.AddTask(t_none, TIMED(KBoundaries::ClearBoundaries), msync.get());
+            auto t_fill_derived = tl.AddTask(t_clear_comm_flags, TIMED(Update::FillDerived<MeshData<Real>>), mc1.get());
+            auto t_fix_derived = tl.AddTask(t_fill_derived, TIMED(GRMHD::FixUtoPMeshTask), mc1.get());
+        }
+    }
 
     // Async Region: Fill primitive values, apply physical boundary conditions,
     // add any source terms which require the full primitives->primitives step
-    // TODO this can be Meshified
     TaskRegion &async_region = tc.AddRegion(blocks.size());
     for (int i = 0; i < blocks.size(); i++) {
         auto &pmb = blocks[i];
@@ -223,30 +354,37 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         auto &sc0 = pmb->meshblock_data.Get(stage_name[stage-1]);
         auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
 
-        auto t_clear_comm_flags = tl.AddTask(t_none, &MeshBlockData<Real>::ClearBoundary,
-                                        sc1.get(), BoundaryCommSubset::all);
+        auto t_fix_derived = t_none;
+        if (!mesh_utop) {
+            auto t_clear_comm_flags = t_none;
+            if (!skip_sync) {
+                auto &sc_sync = pmb->meshblock_data.Get(sync_name);
+                t_clear_comm_flags = tl.AddTask(t_none, TIMED(&MeshBlockData<Real>::ClearBoundary),
+                                            sc_sync.get(), BoundaryCommSubset::all);
+            }
 
-        auto t_prolongBound = t_clear_comm_flags;
-        if (pmesh->multilevel) {
-            t_prolongBound = tl.AddTask(t_clear_comm_flags, ProlongateBoundaries, sc1);
+            auto t_prolongBound = t_clear_comm_flags;
+            if (pmesh->multilevel) {
+                t_prolongBound = tl.AddTask(t_clear_comm_flags, TIMED(ProlongateBoundaries), sc1);
+            }
+            // At this point, we've sync'd all internal boundaries using the conserved
+            // variables. The physical boundaries (pole, inner/outer) are trickier,
+            // since they must be applied to the primitive variables rho,u,u1,u2,u3
+            // but should apply to conserved forms of everything else.
+
+            // This call fills the fluid primitive values in all physical zones, that is, including MPI boundaries but
+            // not the physical boundaries (which haven't been filled yet!)
+            // This relies on the primitives being calculated identically in MPI boundaries, vs their corresponding
+            // physical zones in the adjacent mesh block.  To ensure this, we seed the solver with the same values
+            // in each case, by synchronizing them along with the conserved values above.
+            auto t_fill_derived = tl.AddTask(t_prolongBound, TIMED(Update::FillDerived<MeshBlockData<Real>>), sc1.get());
+            // After this call, the floors are applied (with the hook 'PostFillDerived', see floors.cpp)
+
+            // Immediately fix any inversions which failed.  Floors have been applied already as a part of (Post)FillDerived,
+            // so fixups performed by averaging zones will return logical results.  Floors are re-applied after fixups
+            // Someday this will not be necessary as guaranteed-convergent UtoP schemes exist
+            t_fix_derived = tl.AddTask(t_fill_derived, TIMED(GRMHD::FixUtoPBlockTask), sc1.get());
         }
-        // At this point, we've sync'd all internal boundaries using the conserved
-        // variables. The physical boundaries (pole, inner/outer) are trickier,
-        // since they must be applied to the primitive variables rho,u,u1,u2,u3
-        // but should apply to conserved forms of everything else.
-
-        // This call fills the fluid primitive values in all physical zones, that is, including MPI boundaries but
-        // not the physical boundaries (which haven't been filled yet!)
-        // This relies on the primitives being calculated identically in MPI boundaries, vs their corresponding
-        // physical zones in the adjacent mesh block.  To ensure this, we seed the solver with the same values
-        // in each case, by synchronizing them along with the conserved values above.
-        auto t_fill_derived = tl.AddTask(t_prolongBound, Update::FillDerived<MeshBlockData<Real>>, sc1.get());
-        // After this call, the floors are applied (with the hook 'PostFillDerived', see floors.cpp)
-
-        // Immediately fix any inversions which failed.  Floors have been applied already as a part of (Post)FillDerived,
-        // so fixups performed by averaging zones will return logical results.  Floors are re-applied after fixups
-        // Someday this will not be necessary as guaranteed-convergent UtoP schemes exist
-        auto t_fix_derived = tl.AddTask(t_fill_derived, GRMHD::FixUtoP, sc1.get());
 
         // This is a parthenon call, but in spherical coordinates it will call the KHARMA functions in
         // boundaries.cpp, which apply physical boundary conditions based on the primitive variables of GRHD,
@@ -255,7 +393,7 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         // must call FillDerived *again* (for everything except the GRHD variables) to fill P in the ghost zones.
         // This is why KHARMA packages need to implement their "FillDerived" a.k.a. UtoP functions in the form
         // UtoP(rc, domain, coarse): so that they can be run over just the boundary domains here.
-        auto t_set_bc = tl.AddTask(t_fix_derived, parthenon::ApplyBoundaryConditions, sc1);
+        auto t_set_bc = tl.AddTask(t_fix_derived, TIMED(parthenon::ApplyBoundaryConditions), sc1);
 
         // ADD SOURCES TO PRIMITIVE VARIABLES
         // In order to calculate dissipation, we must know the entropy at the beginning and end of the substep,
@@ -266,7 +404,7 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         // on the same zone match between MeshBlocks.
         auto t_heat_electrons = t_set_bc;
         if (use_electrons) {
-            auto t_heat_electrons = tl.AddTask(t_set_bc, Electrons::ApplyElectronHeating, sc0.get(), sc1.get());
+            auto t_heat_electrons = tl.AddTask(t_set_bc, TIMED(Electrons::ApplyElectronHeating), sc0.get(), sc1.get());
         }
 
         auto t_step_done = t_heat_electrons;
@@ -274,12 +412,12 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         // Estimate next time step based on ctop
         if (stage == integrator->nstages) {
             auto t_new_dt =
-                tl.AddTask(t_step_done, Update::EstimateTimestep<MeshBlockData<Real>>, sc1.get());
+                tl.AddTask(t_step_done, TIMED(Update::EstimateTimestep<MeshBlockData<Real>>), sc1.get());
 
             // Update refinement
             if (pmesh->adaptive) {
                 auto tag_refine = tl.AddTask(
-                    t_step_done, parthenon::Refinement::Tag<MeshBlockData<Real>>, sc1.get());
+                    t_step_done, TIMED(parthenon::Refinement::Tag<MeshBlockData<Real>>), sc1.get());
             }
         }
     }
@@ -289,17 +427,33 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     // identical to their physical counterparts, now that they have been
     // modified on each rank.
     const auto &two_sync = pkgs.at("GRMHD")->Param<bool>("two_sync");
-    if (two_sync) {
+    if (two_sync && overlap_comms && stage < integrator->nstages) {
+        // Just send: the next stage receives, while it calculates fluxes away from the block boundaries.
+        // The last stage syncs fully, so that the state is complete for outputs etc. at the end of the step
+        TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
+        for (int i = 0; i < num_partitions; i++) {
+            auto &tl = single_tasklist_per_pack_region[i];
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+
+            auto t_start_recv = tl.AddTask(t_none, TIMED_AS("MeshData<Real>::StartReceiving (second sync)",
+                                                            &MeshData<Real>::StartReceiving), mc1.get(),
+                                        BoundaryCommSubset::all);
+            auto t_send = tl.AddTask(t_start_recv, TIMED_AS("cell_centered_bvars::SendBoundaryBuffers (second sync)",
+                                                            cell_centered_bvars::SendBoundaryBuffers), mc1);
+            if (report_sync_bytes) tl.AddTask(t_send, TIMED(KBoundaries::CountSyncBytesMesh), mc1.get());
+        }
+    } else if (two_sync) {
         TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
         for (int i = 0; i < num_partitions; i++) {
             auto &tl = single_tasklist_per_pack_region[i];
             auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
 
-            auto t_start_recv = tl.AddTask(t_none, &MeshData<Real>::StartReceiving, mc1.get(),
+            auto t_start_recv = tl.AddTask(t_none, TIMED_AS("MeshData<Real>::StartReceiving (second sync)",
+                                                            &MeshData<Real>::StartReceiving), mc1.get(),
                                         BoundaryCommSubset::all);
         }
 
-        AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms);
+        AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms, "", " (second sync)");
 
         TaskRegion &async_region = tc.AddRegion(blocks.size());
         for (int i = 0; i < blocks.size(); i++) {
@@ -307,12 +461,13 @@ TaskCollection HARMDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             auto &tl = async_region[i];
             auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
 
-            auto t_clear_comm_flags = tl.AddTask(t_none, &MeshBlockData<Real>::ClearBoundary,
+            auto t_clear_comm_flags = tl.AddTask(t_none, TIMED_AS("MeshBlockData<Real>::ClearBoundary (second sync)",
+                                                                  &MeshBlockData<Real>::ClearBoundary),
                                             sc1.get(), BoundaryCommSubset::all);
 
             auto t_prolongBound = t_clear_comm_flags;
             if (pmesh->multilevel) {
-                t_prolongBound = tl.AddTask(t_clear_comm_flags, ProlongateBoundaries, sc1);
+                t_prolongBound = tl.AddTask(t_clear_comm_flags, TIMED(ProlongateBoundaries), sc1);
             }
         }
     }
@@ -34,13 +34,37 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <parthenon/parthenon.hpp>
 
+#include "boundaries.hpp"
+#include "task_timing.hpp"
 #include "types.hpp"
 
 using namespace parthenon;
 
+/**
+ * Coefficients of a low-storage SSP Runge-Kutta integrator, selected with driver/integrator.
+ * These keep only two registers, the base state U0 and a single stage container U updated in place:
+ *   U <- gam0[s] U0 + gam1[s] U + beta[s] dt L(U)
+ * with the last stage writing to U0 instead.  If delta1[s] != 0, the base state is then replaced by
+ *   U0 <- delta0[s] U0 + delta1[s] U
+ * before it is used in the next stage.  Parthenon's integrators are of this form with gam0 = 1 - beta,
+ * gam1 = beta, but give every stage its own container.
+ */
+struct LowStorageCoeffs {
+    int nstages;
+    std::vector<Real> gam0, gam1, beta, delta0, delta1;
+};
+
+/**
+ * Return the coefficients of a low-storage integrator by name:
+ * ssprk3: the usual 3-stage, 3rd-order SSP scheme of Shu & Osher (1988), SSP coefficient 1
+ * ssprk10_4: the 10-stage, 4th-order scheme of Ketcheson (2008), SSP coefficient 6
+ */
+LowStorageCoeffs GetLowStorageCoeffs(const std::string& name);
+
 /**
  * A Driver object orchestrates everything that has to be done to a mesh to constitute a step.
  * For HARM, this means the predictor-corrector steps of fluid evolution
@@ -48,9 +72,10 @@ using namespace parthenon;
 class HARMDriver : public MultiStageDriver {
     public:
         /**
-         * Default constructor
+         * Default constructor.  Replaces Parthenon's integrator stages with a low-storage integrator
+         * if one is selected in driver/integrator
          */
-        HARMDriver(ParameterInput *pin, ApplicationInput *papp, Mesh *pm) : MultiStageDriver(pin, papp, pm) {}
+        HARMDriver(ParameterInput *pin, ApplicationInput *papp, Mesh *pm);
 
         /**
          * All the tasks which constitute advancing the fluid in a mesh by one stage.
@@ -67,6 +92,9 @@ class HARMDriver : public MultiStageDriver {
     private:
         // Global solves need a reduction point
         AllReduce<Real> update_norm;
+        // Whether we're running a low-storage integrator, and its coefficients
+        bool low_storage = false;
+        LowStorageCoeffs ls;
 };
 
 /**
@@ -74,63 +102,71 @@ class HARMDriver : public MultiStageDriver {
  * 
  * This sequence is used identically in several places, so it makes sense
  * to define once and use elsewhere.
+ * By default this syncs the stage's own container.  Pass sync_name to sync a subset of its fields
+ * instead, see KBoundaries::SyncContainer.  timer_tag is appended to the names of its task timers,
+ * to tell apart syncs at different points in the step, see TaskTiming
  * TODO could make member of a HARMDriver/ImExDriver superclass?
  */
-inline void AddBoundarySync(TaskCollection &tc, Mesh *pmesh, BlockList_t &blocks, StagedIntegrator *integrator, int stage, bool pack_comms=false)
+inline void AddBoundarySync(TaskCollection &tc, Mesh *pmesh, BlockList_t &blocks, StagedIntegrator *integrator, int stage, bool pack_comms=false,
+                            const std::string& sync_name="", const std::string& timer_tag="")
 {
     TaskID t_none(0);
     const int num_partitions = pmesh->DefaultNumPartitions();
-    auto stage_name = integrator->stage_name;
+    const std::string& name = sync_name.empty() ? integrator->stage_name[stage] : sync_name;
+    // Count the data each send task sends, once it's sent, see KBoundaries::CountSyncBytes
+    const bool count_bytes = pmesh->packages.Get("Boundaries")->Param<bool>("report_sync_bytes");
     // TODO do these all need to be sequential?  What are the specifics here?
     if (pack_comms) {
         TaskRegion &tr1 = tc.AddRegion(num_partitions);
         for (int i = 0; i < num_partitions; i++) {
-            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(name, i);
             tr1[i].AddTask(t_none,
                 [](MeshData<Real> *mc1){ Flag(mc1, "Parthenon Send Buffers"); return TaskStatus::complete; }
             , mc1.get());
-            tr1[i].AddTask(t_none, cell_centered_bvars::SendBoundaryBuffers, mc1);
+            auto t_send = tr1[i].AddTask(t_none, TIMED_AS("cell_centered_bvars::SendBoundaryBuffers" + timer_tag, cell_centered_bvars::SendBoundaryBuffers), mc1);
+            if (count_bytes) tr1[i].AddTask(t_send, TIMED(KBoundaries::CountSyncBytesMesh), mc1.get());
         }
         TaskRegion &tr2 = tc.AddRegion(num_partitions);
         for (int i = 0; i < num_partitions; i++) {
-            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(name, i);
             tr2[i].AddTask(t_none,
                 [](MeshData<Real> *mc1){ Flag(mc1, "Parthenon Recv Buffers"); return TaskStatus::complete; }
             , mc1.get());
-            tr2[i].AddTask(t_none, cell_centered_bvars::ReceiveBoundaryBuffers, mc1);
+            tr2[i].AddTask(t_none, TIMED_AS("cell_centered_bvars::ReceiveBoundaryBuffers" + timer_tag, cell_centered_bvars::ReceiveBoundaryBuffers), mc1);
         }
         TaskRegion &tr3 = tc.AddRegion(num_partitions);
         for (int i = 0; i < num_partitions; i++) {
-            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(name, i);
             tr3[i].AddTask(t_none,
                 [](MeshData<Real> *mc1){ Flag(mc1, "Parthenon Set Boundaries"); return TaskStatus::complete; }
             , mc1.get());
-            tr3[i].AddTask(t_none, cell_centered_bvars::SetBoundaries, mc1);
+            tr3[i].AddTask(t_none, TIMED_AS("cell_centered_bvars::SetBoundaries" + timer_tag, cell_centered_bvars::SetBoundaries), mc1);
         }
     } else {
         TaskRegion &tr1 = tc.AddRegion(blocks.size());
         for (int i = 0; i < blocks.size(); i++) {
-            auto &sc1 = blocks[i]->meshblock_data.Get(stage_name[stage]);
+            auto &sc1 = blocks[i]->meshblock_data.Get(name);
             tr1[i].AddTask(t_none,
                 [](MeshBlockData<Real> *rc1){ Flag(rc1, "Parthenon Send Buffers"); return TaskStatus::complete; }
             , sc1.get());
-            tr1[i].AddTask(t_none, &MeshBlockData<Real>::SendBoundaryBuffers, sc1.get());
+            auto t_send = tr1[i].AddTask(t_none, TIMED_AS("MeshBlockData<Real>::SendBoundaryBuffers" + timer_tag, &MeshBlockData<Real>::SendBoundaryBuffers), sc1.get());
+            if (count_bytes) tr1[i].AddTask(t_send, TIMED(KBoundaries::CountSyncBytes), sc1.get());
         }
         TaskRegion &tr2 = tc.AddRegion(blocks.size());
         for (int i = 0; i < blocks.size(); i++) {
-            auto &sc1 = blocks[i]->meshblock_data.Get(stage_name[stage]);
+            auto &sc1 = blocks[i]->meshblock_data.Get(name);
             tr2[i].AddTask(t_none,
                 [](MeshBlockData<Real> *rc1){ Flag(rc1, "Parthenon Recv Buffers"); return TaskStatus::complete; }
             , sc1.get());
-            tr2[i].AddTask(t_none, &MeshBlockData<Real>::ReceiveBoundaryBuffers, sc1.get());
+            tr2[i].AddTask(t_none, TIMED_AS("MeshBlockData<Real>::ReceiveBoundaryBuffers" + timer_tag, &MeshBlockData<Real>::ReceiveBoundaryBuffers), sc1.get());
         }
         TaskRegion &tr3 = tc.AddRegion(blocks.size());
         for (int i = 0; i < blocks.size(); i++) {
-            auto &sc1 = blocks[i]->meshblock_data.Get(stage_name[stage]);
+            auto &sc1 = blocks[i]->meshblock_data.Get(name);
             tr3[i].AddTask(t_none,
                 [](MeshBlockData<Real> *rc1){ Flag(rc1, "Parthenon Set Boundaries"); return TaskStatus::complete; }
             , sc1.get());
-            tr3[i].AddTask(t_none, &MeshBlockData<Real>::SetBoundaries, sc1.get());
+            tr3[i].AddTask(t_none, TIMED_AS("MeshBlockData<Real>::SetBoundaries" + timer_tag, &MeshBlockData<Real>::SetBoundaries), sc1.get());
         }
     }
 }
@@ -56,6 +56,7 @@
 #include "resize_restart.hpp"
 #include "implicit.hpp"
 #include "source.hpp"
+#include "task_timing.hpp"
 
 TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
 {
@@ -113,43 +114,13 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         auto &mdudt = pmesh->mesh_data.GetOrAdd("dUdt", i);
         auto &mc_solver = pmesh->mesh_data.GetOrAdd("solver", i);
 
-        auto t_start_recv = tl.AddTask(t_none, &MeshData<Real>::StartReceiving, mc1.get(),
+        auto t_start_recv = tl.AddTask(t_none, TIMED(&MeshData<Real>::StartReceiving), mc1.get(),
                                     BoundaryCommSubset::all);
 
         // Calculate the HLL fluxes in each direction
         // This reconstructs the primitives (P) at faces and uses them to calculate fluxes
         // of the conserved variables (U)
-        const ReconstructionType& recon = pkgs.at("GRMHD")->Param<ReconstructionType>("recon");
-        TaskID t_calculate_flux1, t_calculate_flux2, t_calculate_flux3;
-        switch (recon) {
-        case ReconstructionType::donor_cell:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::donor_cell, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::linear_mc:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_mc, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::linear_vl:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::linear_vl, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::weno5:
-            t_calculate_flux1 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X1DIR>, mc0.get());
-            t_calculate_flux2 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X2DIR>, mc0.get());
-            t_calculate_flux3 = tl.AddTask(t_start_recv, Flux::GetFlux<ReconstructionType::weno5, X3DIR>, mc0.get());
-            break;
-        case ReconstructionType::ppm:
-        case ReconstructionType::mp5:
-        case ReconstructionType::weno5_lower_poles:
-            cerr << "Reconstruction type not supported!  Supported reconstructions:" << endl;
-            cerr << "donor_cell, linear_mc, linear_vl, weno5" << endl;
-            throw std::invalid_argument("Unsupported reconstruction algorithm!");
-        }
-        auto t_calculate_flux = t_calculate_flux1 | t_calculate_flux2 | t_calculate_flux3;
+        auto t_calculate_flux = Flux::AddFluxCalculations(t_start_recv, tl, mc0.get());
 
         auto t_recv_flux = t_calculate_flux;
         // TODO this appears to be implemented *only* block-wise, split it into its own region if so
@@ -159,44 +130,44 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             for (auto &pmb : pmesh->block_list) {
                 auto& rc = pmb->meshblock_data.Get();
                 auto t_send_flux =
-                    tl.AddTask(t_calculate_flux, &MeshBlockData<Real>::SendFluxCorrection, rc.get());
+                    tl.AddTask(t_calculate_flux, TIMED(&MeshBlockData<Real>::SendFluxCorrection), rc.get());
                 t_recv_flux =
-                    tl.AddTask(t_calculate_flux, &MeshBlockData<Real>::ReceiveFluxCorrection, rc.get());
+                    tl.AddTask(t_calculate_flux, TIMED(&MeshBlockData<Real>::ReceiveFluxCorrection), rc.get());
             }
         }
 
         // FIX FLUXES
         // Zero any fluxes through the pole or inflow from outflow boundaries
-        auto t_fix_flux = tl.AddTask(t_recv_flux, KBoundaries::FixFlux, mc0.get());
+        auto t_fix_flux = tl.AddTask(t_recv_flux, TIMED(KBoundaries::FixFlux), mc0.get(), 0);
 
         auto t_flux_ct = t_fix_flux;
         if (use_b_flux_ct) {
             // Fix the conserved fluxes (exclusively B1/2/3) so that they obey divB==0,
             // and there is no B field flux through the pole
-            auto t_flux_ct = tl.AddTask(t_fix_flux, B_FluxCT::TransportB, mc0.get());
+            auto t_flux_ct = tl.AddTask(t_fix_flux, TIMED(B_FluxCT::TransportB), mc0.get(), 0);
         }
         auto t_flux_fixed = t_flux_ct;
 
         // APPLY FLUXES
-        auto t_flux_div = tl.AddTask(t_none, Update::FluxDivergence<MeshData<Real>>, mc0.get(), mdudt.get());
+        auto t_flux_div = tl.AddTask(t_none, TIMED(Update::FluxDivergence<MeshData<Real>>), mc0.get(), mdudt.get());
 
         // ADD EXPLICIT SOURCES TO CONSERVED VARIABLES
         // Source term for GRMHD, \Gamma * T
         // TODO take this out in Minkowski space
-        auto t_grmhd_source = tl.AddTask(t_flux_div, GRMHD::AddSource, mc0.get(), mdudt.get());
+        auto t_grmhd_source = GRMHD::AddSourceTask(t_flux_div, tl, mc0.get(), mdudt.get());
         // Source term for constraint-damping.  Applied only to B
         auto t_b_cd_source = t_grmhd_source;
         if (use_b_cd) {
-            t_b_cd_source = tl.AddTask(t_grmhd_source, B_CD::AddSource, mc0.get(), mdudt.get());
+            t_b_cd_source = tl.AddTask(t_grmhd_source, TIMED(B_CD::AddSource), mc0.get(), mdudt.get());
         }
         // Wind source.  Applied to conserved variables similar to GR source term
         auto t_wind_source = t_b_cd_source;
         if (use_wind) {
-            t_wind_source = tl.AddTask(t_b_cd_source, Wind::AddSource, mdudt.get());
+            t_wind_source = tl.AddTask(t_b_cd_source, TIMED(Wind::AddSource), mdudt.get());
         }
         auto t_emhd_source = t_wind_source;
         if (use_emhd) {
-            t_emhd_source = tl.AddTask(t_wind_source, EMHD::AddSource, mc0.get(), mdudt.get());
+            t_emhd_source = tl.AddTask(t_wind_source, TIMED(EMHD::AddSource), mc0.get(), mdudt.get());
         }
         // Done with source terms
         auto t_sources = t_emhd_source;
@@ -223,14 +194,14 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         //                             std::vector<MetadataFlag>({isExplicit, Metadata::Independent}),
         //                             mc_solver.get(), mdudt.get(), 1.0, beta * dt, mc_solver.get());
         // Version with half/whole step to match implicit solver
-        auto t_explicit_U = tl.AddTask(t_sources, Update::WeightedSumData<MetadataFlag, MeshData<Real>>,
+        auto t_explicit_U = tl.AddTask(t_sources, TIMED_AS("Update::WeightedSumData (explicit update)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
                                     std::vector<MetadataFlag>({isExplicit, Metadata::Independent}),
                                     mbase.get(), mdudt.get(), 1.0, dt_this, mc_solver.get());
 
         // Make sure the primitive values of any explicit fields are filled
         auto t_explicit_UtoP_B = t_explicit_U;
         if (!pkgs.at("B_FluxCT")->Param<bool>("implicit"))
-            t_explicit_UtoP_B = tl.AddTask(t_explicit_U, B_FluxCT::FillDerivedMeshTask, mc_solver.get());
+            t_explicit_UtoP_B = tl.AddTask(t_explicit_U, TIMED(B_FluxCT::FillDerivedMeshTask), mc_solver.get());
         // If GRMHD is not implicit, but we're still going to be taking an implicit step, call its FillDerived function
         // TODO Would be faster/more flexible if this supported MeshData. Also maybe race condition
         auto t_explicit_UtoP_G = t_explicit_UtoP_B;
@@ -238,13 +209,13 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             // Get flux corrections from AMR neighbors
             for (auto &pmb : pmesh->block_list) {
                 auto& rc = pmb->meshblock_data.Get();
-                auto t_explicit_UtoP_G = tl.AddTask(t_explicit_UtoP_B, GRMHD::FillDerivedBlockTask, rc.get());
+                auto t_explicit_UtoP_G = tl.AddTask(t_explicit_UtoP_B, TIMED(GRMHD::FillDerivedBlockTask), rc.get());
             }
         }
         auto t_explicit = t_explicit_UtoP_G;
 
         // Copy the current implicit vars in as a guess.  This needs at least the primitive vars
-        auto t_copy_guess = tl.AddTask(t_sources, Update::WeightedSumData<MetadataFlag, MeshData<Real>>,
+        auto t_copy_guess = tl.AddTask(t_sources, TIMED_AS("Update::WeightedSumData (copy guess)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
                                     std::vector<MetadataFlag>({isImplicit}),
                                     mc0.get(), mc0.get(), 1.0, 0.0, mc_solver.get());
 
@@ -252,10 +223,10 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         // This applies the functions of both the update above and FillDerived call below for "isImplicit" variables
         // This takes dt for the *substep*, not the whole thing, so we multiply total dt by *this step's* beta
         auto t_guess_ready = t_explicit | t_copy_guess;
-        auto t_implicit = tl.AddTask(t_guess_ready, Implicit::Step, mbase.get(), mc0.get(), mdudt.get(), mc_solver.get(), dt_this);
+        auto t_implicit = tl.AddTask(t_guess_ready, TIMED(Implicit::Step), mbase.get(), mc0.get(), mdudt.get(), mc_solver.get(), dt_this);
 
         // Copy the solver state into the final state mc1
-        auto t_copy_result = tl.AddTask(t_implicit, Update::WeightedSumData<MetadataFlag, MeshData<Real>>, std::vector<MetadataFlag>({}),
+        auto t_copy_result = tl.AddTask(t_implicit, TIMED_AS("Update::WeightedSumData (copy result)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>), std::vector<MetadataFlag>({}),
                                         mc_solver.get(), mc_solver.get(), 1.0, 0.0, mc1.get());
 
         // If evolving GRMHD explicitly, U_to_P needs a guess in order to converge, so we copy in mc0
@@ -263,7 +234,7 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         if (!pkgs.at("GRMHD")->Param<bool>("implicit")) {
             MetadataFlag isPrimitive = pkgs.at("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
             MetadataFlag isHD = pkgs.at("GRMHD")->Param<MetadataFlag>("HDFlag");
-            auto t_copy_prims = tl.AddTask(t_none, Update::WeightedSumData<MetadataFlag, MeshData<Real>>,
+            auto t_copy_prims = tl.AddTask(t_none, TIMED_AS("Update::WeightedSumData (copy prims)", Update::WeightedSumData<MetadataFlag, MeshData<Real>>),
                                         std::vector<MetadataFlag>({isHD, isPrimitive}),
                                         mc0.get(), mc0.get(), 1.0, 0.0, mc1.get());
         }
@@ -271,18 +242,29 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     }
 
     // Even though we filled some primitive vars 
-    TaskRegion &async_region1 = tc.AddRegion(blocks.size());
-    for (int i = 0; i < blocks.size(); i++) {
-        auto &pmb = blocks[i];
-        auto &tl = async_region1[i];
-        auto &sc0 = pmb->meshblock_data.Get(stage_name[stage-1]);
-        auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+    // Optionally fill them for each MeshData partition at once, rather than block-by-block. See HARMDriver
+    const bool mesh_utop = pkgs.at("GRMHD")->Param<bool>("mesh_utop");
+    if (mesh_utop) {
+        TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
+        for (int i = 0; i < num_partitions; i++) {
+            auto &tl = single_tasklist_per_pack_region[i];
+            auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
 
-        // Note that floors are applied (to all variables!) immediately after this FillDerived call.
-        // However, it is *not* immediately corrected with FixUtoP, but synchronized (including pflags!) first.
-        // With an extra ghost zone, this *should* still allow binary-similar evolution between numbers of mesh blocks,
-        // but hasn't been tested.
-        auto t_fill_derived = tl.AddTask(t_none, Update::FillDerived<MeshBlockData<Real>>, sc1.get());
+            auto t_fill_derived = tl.AddTask(t_none, TIMED(Update::FillDerived<MeshData<Real>>), mc1.get());
+        }
+    } else {
+        TaskRegion &async_region1 = tc.AddRegion(blocks.size());
+        for (int i = 0; i < blocks.size(); i++) {
+            auto &pmb = blocks[i];
+            auto &tl = async_region1[i];
+            auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+
+            // Note that floors are applied (to all variables!) immediately after this FillDerived call.
+            // However, it is *not* immediately corrected with FixUtoP, but synchronized (including pflags!) first.
+            // With an extra ghost zone, this *should* still allow binary-similar evolution between numbers of mesh blocks,
+            // but hasn't been tested.
+            auto t_fill_derived = tl.AddTask(t_none, TIMED(Update::FillDerived<MeshBlockData<Real>>), sc1.get());
+        }
     }
 
     // MPI/MeshBlock boundary exchange.
@@ -292,6 +274,45 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
     AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms);
 
     // Async Region: Any post-sync tasks.  Fixups, timestep & AMR things.
+    // With mesh_utop, the fixups are run per-partition in their own region, between the boundary
+    // conditions and everything else
+    const bool fix_utop = !pkgs.at("GRMHD")->Param<bool>("implicit");
+    if (mesh_utop) {
+        TaskRegion &async_region_bc = tc.AddRegion(blocks.size());
+        for (int i = 0; i < blocks.size(); i++) {
+            auto &pmb = blocks[i];
+            auto &tl = async_region_bc[i];
+            auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
+
+            auto t_clear_comm_flags = tl.AddTask(t_none, TIMED(&MeshBlockData<Real>::ClearBoundary),
+                                            sc1.get(), BoundaryCommSubset::all);
+
+            auto t_prolongBound = t_clear_comm_flags;
+            if (pmesh->multilevel) {
+                t_prolongBound = tl.AddTask(t_clear_comm_flags, TIMED(ProlongateBoundaries), sc1);
+            }
+
+            auto t_set_bc = tl.AddTask(t_prolongBound, TIMED(parthenon::ApplyBoundaryConditions), sc1);
+        }
+
+        if (fix_utop) {
+            TaskRegion &single_tasklist_per_pack_region = tc.AddRegion(num_partitions);
+            for (int i = 0; i < num_partitions; i++) {
+                auto &tl = single_tasklist_per_pack_region[i];
+                auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
+
+                auto t_fix_derived = tl.AddTask(t_none, TIMED(GRMHD::FixUtoPMeshTask), mc1.get());
+            }
+        }
+    }
+
+    // Copy the signal speeds reduced by the last stage's flux kernels to the host before estimating the timestep,
+    // see HARMDriver
+    if (stage == integrator->nstages && pkgs.at("GRMHD")->Param<bool>("reduce_ctop")) {
+        TaskRegion &ctop_region = tc.AddRegion(1);
+        ctop_region[0].AddTask(t_none, TIMED(GRMHD::FetchCtopBuffer), pmesh);
+    }
+
     TaskRegion &async_region2 = tc.AddRegion(blocks.size());
     for (int i = 0; i < blocks.size(); i++) {
         auto &pmb = blocks[i];
@@ -299,45 +320,48 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
         auto &sc0 = pmb->meshblock_data.Get(stage_name[stage-1]);
         auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
 
-        auto t_clear_comm_flags = tl.AddTask(t_none, &MeshBlockData<Real>::ClearBoundary,
-                                        sc1.get(), BoundaryCommSubset::all);
+        auto t_fix_derived = t_none;
+        if (!mesh_utop) {
+            auto t_clear_comm_flags = tl.AddTask(t_none, TIMED(&MeshBlockData<Real>::ClearBoundary),
+                                            sc1.get(), BoundaryCommSubset::all);
 
-        auto t_prolongBound = t_clear_comm_flags;
-        if (pmesh->multilevel) {
-            t_prolongBound = tl.AddTask(t_clear_comm_flags, ProlongateBoundaries, sc1);
-        }
+            auto t_prolongBound = t_clear_comm_flags;
+            if (pmesh->multilevel) {
+                t_prolongBound = tl.AddTask(t_clear_comm_flags, TIMED(ProlongateBoundaries), sc1);
+            }
 
-        auto t_set_bc = tl.AddTask(t_prolongBound, parthenon::ApplyBoundaryConditions, sc1);
+            auto t_set_bc = tl.AddTask(t_prolongBound, TIMED(parthenon::ApplyBoundaryConditions), sc1);
 
-        // If we're evolving even the GRMHD variables explicitly, we need to fix UtoP variable inversion failures
-        // Syncing bounds before calling this, and then running it over the whole domain, will make
-        // behavior for different mesh breakdowns much more similar (identical?), since bad zones in
-        // relevant ghost zone ranks will get to use all the same neighbors as if they were in the bulk
-        auto t_fix_derived = t_set_bc;
-        if (!pkgs.at("GRMHD")->Param<bool>("implicit")) {
-            t_fix_derived = tl.AddTask(t_set_bc, GRMHD::FixUtoP, sc1.get());
+            // If we're evolving even the GRMHD variables explicitly, we need to fix UtoP variable inversion failures
+            // Syncing bounds before calling this, and then running it over the whole domain, will make
+            // behavior for different mesh breakdowns much more similar (identical?), since bad zones in
+            // relevant ghost zone ranks will get to use all the same neighbors as if they were in the bulk
+            t_fix_derived = t_set_bc;
+            if (fix_utop) {
+                t_fix_derived = tl.AddTask(t_set_bc, TIMED(GRMHD::FixUtoPBlockTask), sc1.get());
+            }
         }
 
         // Electron heating goes where it does in HARMDriver, for the same reasons
         auto t_heat_electrons = t_fix_derived;
         if (use_electrons) {
-            t_heat_electrons = tl.AddTask(t_fix_derived, Electrons::ApplyElectronHeating, sc0.get(), sc1.get());
+            t_heat_electrons = tl.AddTask(t_fix_derived, TIMED(Electrons::ApplyElectronHeating), sc0.get(), sc1.get());
         }
 
         // Make sure conserved vars are synchronized at step end
-        auto t_ptou = tl.AddTask(t_heat_electrons, Flux::PtoUTask, sc1.get());
+        auto t_ptou = tl.AddTask(t_heat_electrons, TIMED(Flux::PtoUTask), sc1.get());
 
         auto t_step_done = t_ptou;
 
         // Estimate next time step based on ctop
         if (stage == integrator->nstages) {
             auto t_new_dt =
-                tl.AddTask(t_step_done, Update::EstimateTimestep<MeshBlockData<Real>>, sc1.get());
+                tl.AddTask(t_step_done, TIMED(Update::EstimateTimestep<MeshBlockData<Real>>), sc1.get());
 
             // Update refinement
             if (pmesh->adaptive) {
                 auto tag_refine = tl.AddTask(
-                    t_step_done, parthenon::Refinement::Tag<MeshBlockData<Real>>, sc1.get());
+                    t_step_done, TIMED(parthenon::Refinement::Tag<MeshBlockData<Real>>), sc1.get());
             }
         }
     }
@@ -353,11 +377,12 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             auto &tl = single_tasklist_per_pack_region[i];
             auto &mc1 = pmesh->mesh_data.GetOrAdd(stage_name[stage], i);
 
-            auto t_start_recv = tl.AddTask(t_none, &MeshData<Real>::StartReceiving, mc1.get(),
+            auto t_start_recv = tl.AddTask(t_none, TIMED_AS("MeshData<Real>::StartReceiving (second sync)",
+                                                            &MeshData<Real>::StartReceiving), mc1.get(),
                                         BoundaryCommSubset::all);
         }
 
-        AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms);
+        AddBoundarySync(tc, pmesh, blocks, integrator.get(), stage, pack_comms, "", " (second sync)");
 
         TaskRegion &async_region = tc.AddRegion(blocks.size());
         for (int i = 0; i < blocks.size(); i++) {
@@ -365,12 +390,13 @@ TaskCollection ImexDriver::MakeTaskCollection(BlockList_t &blocks, int stage)
             auto &tl = async_region[i];
             auto &sc1 = pmb->meshblock_data.Get(stage_name[stage]);
 
-            auto t_clear_comm_flags = tl.AddTask(t_none, &MeshBlockData<Real>::ClearBoundary,
+            auto t_clear_comm_flags = tl.AddTask(t_none, TIMED_AS("MeshBlockData<Real>::ClearBoundary (second sync)",
+                                                                  &MeshBlockData<Real>::ClearBoundary),
                                             sc1.get(), BoundaryCommSubset::all);
 
             auto t_prolongBound = t_clear_comm_flags;
             if (pmesh->multilevel) {
-                t_prolongBound = tl.AddTask(t_clear_comm_flags, ProlongateBoundaries, sc1);
+                t_prolongBound = tl.AddTask(t_clear_comm_flags, TIMED(ProlongateBoundaries), sc1);
             }
         }
     }
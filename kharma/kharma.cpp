@@ -46,6 +46,7 @@
 #include "current.hpp"
 #include "electrons.hpp"
 #include "implicit.hpp"
+#include "local_timestep.hpp"
 #include "floors.hpp"
 #include "grmhd.hpp"
 #include "reductions.hpp"
@@ -56,7 +57,9 @@
 #include "boundaries.hpp"
 #include "fixup.hpp"
 #include "harm_driver.hpp"
+#include "reconstruction.hpp"
 #include "resize_restart.hpp"
+#include "task_timing.hpp"
 
 std::shared_ptr<StateDescriptor> KHARMA::InitializeGlobals(ParameterInput *pin)
 {
@@ -76,6 +79,9 @@ std::shared_ptr<StateDescriptor> KHARMA::InitializeGlobals(ParameterInput *pin)
     // Whether we are computing initial outputs/timestep, or versions in the execution loop
     params.Add("in_loop", false, true);
 
+    // Per-task timers are host-side global state too, see task_timing.hpp
+    TaskTiming::Initialize(pin);
+
     return pkg;
 }
 void KHARMA::ResetGlobals(ParameterInput *pin, Mesh *pmesh)
@@ -102,7 +108,30 @@ void KHARMA::FixParameters(std::unique_ptr<ParameterInput>& pin)
     //     Globals::nghost = pin->GetInteger("parthenon/mesh", "nghost");
     // }
     // For now we always set 4 ghost zones
-    pin->SetInteger("parthenon/mesh", "nghost", 4);
+    int nghost = 4;
+    // ...unless each RK stage but the last is also updating a layer of ghost zones, see GRMHD::Initialize.
+    // The first stage's update must cover the stride for each following stage, with one more row of
+    // fluxes and the reconstruction stencil (KReconstruction::stencil_reach) beyond that
+    if (pin->GetOrAddBoolean("perf", "deep_halo", false)) {
+        const int reach = KReconstruction::stencil_reach(KReconstruction::ParseReconstructionType(
+                                pin->GetOrAddString("GRMHD", "reconstruction", "weno5")));
+        std::string integrator = pin->GetOrAddString("parthenon/time", "integrator", "rk2");
+        int nstages;
+        if (integrator == "rk1") {
+            nstages = 1;
+        } else if (integrator == "rk2" || integrator == "vl2") {
+            nstages = 2;
+        } else if (integrator == "rk3") {
+            nstages = 3;
+        } else if (integrator == "rk4") {
+            nstages = 4;
+        } else {
+            cerr << "perf/deep_halo doesn't support integrator " << integrator << endl;
+            throw std::invalid_argument("Unsupported performance options!");
+        }
+        nghost = std::max(nghost, 1 + (nstages - 1) * (reach + 2) + reach);
+    }
+    pin->SetInteger("parthenon/mesh", "nghost", nghost);
     Globals::nghost = pin->GetInteger("parthenon/mesh", "nghost");
 
     // If we're restarting (not via Parthenon), read the restart file to get most parameters
@@ -215,11 +244,15 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput>& pin)
     bool b_cleanup = b_cleanup_package || is_resize || initial_cleanup;
 
     // TODO enable this iff jcon is in the list of outputs
-    bool add_jcon = pin->GetOrAddBoolean("GRMHD", "add_jcon", true);
+    // jcon needs a copy of the state at the start of each step, which low-storage integrators
+    // otherwise do without, so they leave it off by default
+    bool add_jcon = pin->GetOrAddBoolean("GRMHD", "add_jcon",
+                                         pin->GetOrAddString("driver", "integrator", "parthenon") == "parthenon");
     bool do_electrons = pin->GetOrAddBoolean("electrons", "on", false);
     bool do_reductions = pin->GetOrAddBoolean("reductions", "on", true);
     bool do_emhd = pin->GetOrAddBoolean("emhd", "on", false);
     bool do_wind = pin->GetOrAddBoolean("wind", "on", false);
+    bool do_local_timestep = pin->GetOrAddBoolean("local_timestep", "on", false);
 
     // Set the default driver all the way up here, so packages know how to flag
     // prims vs cons (imex stepper syncs prims, but it's the packages' job to mark them)
@@ -240,6 +273,9 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput>& pin)
     // Always enable.
     packages.Add(KHARMA::InitializeGlobals(pin.get()));
 
+    // Options & counters for the ghost zone exchange.  Always enable.
+    packages.Add(KBoundaries::Initialize(pin.get()));
+
     // Lots of common functions and variables are still in the GRMHD package,
     // always initialize it first among physics stuff
     packages.Add(GRMHD::Initialize(pin.get(), packages));
@@ -288,6 +324,11 @@ Packages_t KHARMA::ProcessPackages(std::unique_ptr<ParameterInput>& pin)
         packages.Add(Wind::Initialize(pin.get()));
     }
 
+    // Local timestepping checks the other packages, so must be initialized last
+    if (do_local_timestep) {
+        packages.Add(LocalTimestep::Initialize(pin.get(), packages));
+    }
+
     return std::move(packages);
 }
 
@@ -318,6 +359,19 @@ void KHARMA::PreStepMeshUserWorkInLoop(Mesh *pmesh, ParameterInput *pin, const S
     if (!pmesh->packages.Get("Globals")->Param<bool>("in_loop")) {
         pmesh->packages.Get("Globals")->UpdateParam<bool>("in_loop", true);
     }
+
+    // Choose which blocks step this time, see LocalTimestep
+    if (pmesh->packages.AllPackages().count("LocalTimestep")) {
+        LocalTimestep::BeginStep(pmesh, tm);
+    }
+
+    // Free the geometry of any blocks removed in the last remesh
+    PruneGeometryCaches();
+
+    // Recompute the tabulated geometric floors of any blocks added in the last remesh
+    if (pmesh->packages.AllPackages().count("Floors")) {
+        Floors::UpdateGeomFloorTable(pmesh);
+    }
 }
 
 void KHARMA::PostStepMeshUserWorkInLoop(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
@@ -338,6 +392,14 @@ void KHARMA::PostStepMeshUserWorkInLoop(Mesh *pmesh, ParameterInput *pin, const
         pmesh->packages.Get("Globals")->UpdateParam<Real>("ctop_max_last", ctop_max_last);
         pmesh->packages.Get("Globals")->UpdateParam<Real>("ctop_max", 0.0);
     }
+
+    // Write out task timings, if it's time
+    TaskTiming::Report(tm);
+
+    // Report ghost zone data exchanged this step, if it changed
+    if (pmesh->packages.Get("Boundaries")->Param<bool>("report_sync_bytes")) {
+        KBoundaries::ReportSyncBytes(pmesh, tm);
+    }
 }
 
 void KHARMA::PostStepDiagnostics(Mesh *pmesh, ParameterInput *pin, const SimTime &tm)
@@ -355,7 +417,11 @@ void KHARMA::PostStepDiagnostics(Mesh *pmesh, ParameterInput *pin, const SimTime
 void KHARMA::FillOutput(MeshBlock *pmb, ParameterInput *pin)
 {
     Flag("Filling output");
-    // Don't fill the output arrays for the first dump, as trying to actually
+    // The inversion & floor flags are only copied from their arrays, which are valid from the first UtoP.
+    // Always fill them, so that the first dump records the flags from initialization
+    GRMHD::FillOutput(pmb, pin);
+    Floors::FillOutput(pmb, pin);
+    // Don't fill the other output arrays for the first dump, as trying to actually
     // calculate them can produce errors when we're not in the loop yet.
     // Instead, they just get added to the file as their starting values, i.e. 0
     if (pmb->packages.Get("Globals")->Param<bool>("in_loop")) {
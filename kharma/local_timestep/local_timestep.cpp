@@ -0,0 +1,600 @@
+/* 
+ *  File: local_timestep.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "local_timestep.hpp"
+
+#include "mpi.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace LocalTimestep {
+
+namespace {
+// Times of steps at different levels are compared to within a small fraction of the base timestep,
+// since they're reached by adding up different numbers of steps
+inline bool same_time(const Real a, const Real b, const Real dt) { return std::abs(a - b) < 1.e-6 * dt; }
+// Whether a shell's current step has ended by time t
+inline bool ended_by(const Real end, const Real t, const Real dt) { return end < t || same_time(end, t, dt); }
+
+// Earliest end of a step still in flight at time t, or t if none are
+Real NextEnd(const std::vector<Real>& shell_end, const Real t, const Real dt)
+{
+    Real next = std::numeric_limits<Real>::max();
+    for (const Real end : shell_end)
+        if (!ended_by(end, t, dt)) next = std::min(next, end);
+    return (next == std::numeric_limits<Real>::max()) ? t : next;
+}
+
+// Choose the level of each shell from the CFL timesteps of its blocks
+std::vector<int> AssignLevels(Mesh *pmesh, Params& params, const Real dt)
+{
+    const int max_level = params.Get<int>("max_level");
+    const Real safety = params.Get<Real>("safety");
+    const int verbose = params.Get<int>("verbose");
+    const auto& block_dt = params.Get<ParArray1D<Real>::HostMirror>("block_dt");
+    const int nshells = pmesh->nrbx1;
+    std::vector<double> shell_dt(nshells, std::numeric_limits<double>::max()), shell_dt_all(nshells);
+    for (auto &pmb : pmesh->block_list) {
+        shell_dt[pmb->loc.lx1] = std::min(shell_dt[pmb->loc.lx1], (double) block_dt(pmb->lid));
+    }
+    MPIMinVector(shell_dt.data(), shell_dt_all.data(), nshells);
+
+    // Promote a shell only if its blocks could take the longer steps with a margin to spare, since their
+    // limits shrink as the flow evolves over the cycle.  If they shrink past a block's step anyway,
+    // the cycle is ended early, see BeginStep
+    std::vector<int> new_levels(nshells, 0);
+    for (int s = 0; s < nshells; ++s) {
+        while (new_levels[s] < max_level && shell_dt_all[s] >= safety * (2 << new_levels[s]) * dt) new_levels[s]++;
+    }
+    // Neighboring shells may differ by at most one level, so each block's ghost zones only ever need
+    // interpolating across at most two of its own steps.  Only ever lower levels to get there
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int s = 0; s < nshells; ++s) {
+            const int lim = std::min((s > 0) ? new_levels[s-1] + 1 : max_level,
+                                     (s < nshells - 1) ? new_levels[s+1] + 1 : max_level);
+            if (new_levels[s] > lim) {
+                new_levels[s] = lim;
+                changed = true;
+            }
+        }
+    }
+
+    if (verbose > 0 && MPIRank0() && new_levels != params.Get<std::vector<int>>("levels")) {
+        // Each shell does 2^-l of the work it would without local timestepping
+        double work = 0.;
+        std::cout << "Local timestep levels by shell:";
+        for (int s = 0; s < nshells; ++s) {
+            std::cout << " " << new_levels[s];
+            work += 1. / (1 << new_levels[s]);
+        }
+        std::cout << " (expected speedup " << nshells / work << ")" << std::endl;
+    }
+
+    return new_levels;
+}
+} // namespace
+
+std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t packages)
+{
+    auto pkg = std::make_shared<StateDescriptor>("LocalTimestep");
+    Params &params = pkg->AllParams();
+
+    // Shells may take steps of up to 2^max_level times the base timestep
+    int max_level = pin->GetOrAddInteger("local_timestep", "max_level", 3);
+    if (max_level < 0 || max_level > 10) {
+        throw std::invalid_argument("local_timestep/max_level must be between 0 and 10!");
+    }
+    params.Add("max_level", max_level);
+    // Margin by which a shell's CFL timestep must exceed the longer steps of the next level before it's
+    // promoted at the start of a cycle
+    Real safety = pin->GetOrAddReal("local_timestep", "safety", 1.5);
+    if (safety < 1.) {
+        throw std::invalid_argument("local_timestep/safety must be at least 1!");
+    }
+    params.Add("safety", safety);
+    // Print the levels whenever they change
+    int verbose = pin->GetOrAddInteger("debug", "verbose", 0);
+    params.Add("verbose", verbose);
+
+    // Blocks are only ever stepped or held whole, by the HARM driver's fused update.
+    // Anything keeping its own state between stages or steps, or exchanging data between blocks
+    // outside of the single boundary sync per stage, would need its own treatment
+    auto& grmhd_pars = packages.Get("GRMHD")->AllParams();
+    if (grmhd_pars.Get<std::string>("driver_type") != "harm" ||
+        pin->GetOrAddString("driver", "integrator", "parthenon") != "parthenon") {
+        cerr << "Local timestepping requires the HARM driver, with Parthenon's integrators!" << endl;
+        throw std::invalid_argument("Unsupported driver for local timestepping!");
+    }
+    if (grmhd_pars.Get<bool>("two_sync") || grmhd_pars.Get<bool>("deep_halo") ||
+        pin->GetOrAddString("parthenon/mesh", "refinement", "none") != "none" ||
+        packages.AllPackages().count("Electrons") || packages.AllPackages().count("EMHD") ||
+        pin->GetOrAddString("parthenon/mesh", "ix1_bc", "outflow") == "periodic") {
+        cerr << "Local timestepping can't be combined with perf/two_sync, perf/deep_halo, mesh refinement," << endl
+             << "electrons, EMHD, or periodic x1 boundaries!" << endl;
+        throw std::invalid_argument("Unsupported options for local timestepping!");
+    }
+
+    // Time at the end of each stage, as a fraction of the step.  For Parthenon's integrators as used
+    // by the HARM driver, each stage s takes U_s = beta_s*(U_{s-1} + dt*dU(U_{s-1})) + (1-beta_s)*U_0
+    std::string integrator = pin->GetOrAddString("parthenon/time", "integrator", "rk2");
+    std::vector<Real> beta;
+    if (integrator == "rk1") {
+        beta = {1.};
+    } else if (integrator == "rk2") {
+        beta = {1., 0.5};
+    } else if (integrator == "rk3") {
+        beta = {1., 0.25, 2./3.};
+    } else {
+        cerr << "Local timestepping doesn't support integrator " << integrator << endl;
+        throw std::invalid_argument("Unsupported integrator for local timestepping!");
+    }
+    std::vector<Real> stage_time(beta.size());
+    Real c = 0.;
+    for (int s = 0; s < beta.size(); ++s) {
+        c = beta[s] * (c + 1.);
+        stage_time[s] = c;
+    }
+    params.Add("stage_time", stage_time);
+
+    // Device state, allocated & filled at the start of each step by BeginStep.  By gid:
+    // whether each block steps, and its timestep as a multiple of the driver's
+    params.Add("active", ParArray1D<int>(), true);
+    params.Add("dt_factor", ParArray1D<Real>(), true);
+    params.Add("ghosts", ParArray1D<int>(), true);
+    // By gid, stage & side (0 for inner neighbor, 1 for outer): weight of the synchronized ghost zones
+    params.Add("theta", ParArray3D<Real>(), true);
+    // By gid & side: whether to record the ghost zones at the start of the step, and FreezeMode of the face
+    params.Add("snapshot", ParArray2D<int>(), true);
+    params.Add("freeze", ParArray2D<int>(), true);
+    // By 2*(local block index) + side: ghost zones at the start of each neighbor's current step,
+    // and frozen fluxes: x1 fluxes of each conserved variable, then F2[B1] & F3[B1] at the columns either side
+    params.Add("ghosts_old", ParArray5D<Real>(), true);
+    params.Add("fluxes_frozen", ParArray4D<Real>(), true);
+
+    // Host state of the current cycle, kept by BeginStep.  By shell: level, and the start & end times
+    // of the current step.  The cycle ends once every shell's step has, at cycle_end.  The base timestep
+    // dt_base is fixed over a cycle unless it is ended early ("truncated"), see BeginStep
+    params.Add("levels", std::vector<int>(), true);
+    params.Add("shell_start", std::vector<Real>(), true);
+    params.Add("shell_end", std::vector<Real>(), true);
+    params.Add("cycle_end", 0.0, true);
+    params.Add("dt_base", 0.0, true);
+    params.Add("truncated", false, true);
+    // End of the driver's current step
+    params.Add("step_end", 0.0, true);
+    // By local block index: each block's CFL timestep from its last step, and whether that was shorter than
+    // the step it took.  Blocks without a recorded timestep (0) start at level 0
+    params.Add("block_dt", ParArray1D<Real>::HostMirror(), true);
+    params.Add("block_over", ParArray1D<int>::HostMirror(), true);
+    // Host copies of active & ghosts, for BlockActive & BlockFilled
+    params.Add("active_h", ParArray1D<int>::HostMirror(), true);
+    params.Add("ghosts_h", ParArray1D<int>::HostMirror(), true);
+
+    return pkg;
+}
+
+void ResetCycle(Mesh *pmesh)
+{
+    auto& params = pmesh->packages.Get("LocalTimestep")->AllParams();
+    // With no levels, BeginStep starts a new cycle.  With no block timesteps, it's taken at level 0
+    params.Update<std::vector<int>>("levels", std::vector<int>());
+    params.Update<std::vector<Real>>("shell_start", std::vector<Real>());
+    params.Update<std::vector<Real>>("shell_end", std::vector<Real>());
+    params.Update<bool>("truncated", false);
+    params.Update<ParArray1D<Real>::HostMirror>("block_dt", ParArray1D<Real>::HostMirror());
+    params.Update<ParArray1D<int>::HostMirror>("block_over", ParArray1D<int>::HostMirror());
+}
+
+void BeginStep(Mesh *pmesh, const SimTime& tm)
+{
+    Flag("Starting local timestep");
+    auto& params = pmesh->packages.Get("LocalTimestep")->AllParams();
+    const int verbose = params.Get<int>("verbose");
+    const auto& stage_time = params.Get<std::vector<Real>>("stage_time");
+    const int nstages = stage_time.size();
+    const int nbtotal = pmesh->nbtotal;
+    const int nblocks = pmesh->block_list.size();
+    const int nshells = pmesh->nrbx1;
+
+    auto block_dt = params.Get<ParArray1D<Real>::HostMirror>("block_dt");
+    auto block_over = params.Get<ParArray1D<int>::HostMirror>("block_over");
+    if (block_dt.extent_int(0) != nblocks) {
+        block_dt = ParArray1D<Real>::HostMirror("lts_block_dt", nblocks);
+        block_over = ParArray1D<int>::HostMirror("lts_block_over", nblocks);
+        params.Update<ParArray1D<Real>::HostMirror>("block_dt", block_dt);
+        params.Update<ParArray1D<int>::HostMirror>("block_over", block_over);
+    }
+    // Whether any block's CFL limit fell short of the step it took, see BlockTimestep
+    int over = 0;
+    for (int lid = 0; lid < nblocks; ++lid) {
+        over = std::max(over, block_over(lid));
+        block_over(lid) = 0;
+    }
+    over = MPIMax(over);
+
+    auto levels = params.Get<std::vector<int>>("levels");
+    auto shell_start = params.Get<std::vector<Real>>("shell_start");
+    auto shell_end = params.Get<std::vector<Real>>("shell_end");
+    Real cycle_end = params.Get<Real>("cycle_end");
+    Real dt_base = params.Get<Real>("dt_base");
+    bool truncated = params.Get<bool>("truncated");
+    const bool mid_cycle = (int) levels.size() == nshells && !ended_by(cycle_end, tm.time, tm.dt);
+
+    if (mid_cycle && (over || truncated)) {
+        // Blocks would exceed their CFL limits if they kept to their levels.  End the cycle as soon
+        // as the steps already in flight allow: shells between steps continue at level 0, with a base
+        // timestep which divides the time until the next step in flight ends (see BlockTimestep)
+        if (verbose > 0 && MPIRank0() && !truncated) {
+            std::cout << "Ending local timestep cycle early at t=" << tm.time << ": CFL limit fell below a block's step" << std::endl;
+        }
+        for (int s = 0; s < nshells; ++s)
+            if (ended_by(shell_end[s], tm.time, tm.dt)) levels[s] = 0;
+        const Real nsteps = (NextEnd(shell_end, tm.time, tm.dt) - tm.time) / tm.dt;
+        if (!same_time(nsteps, std::round(nsteps), 1.)) {
+            cerr << "Base timestep doesn't divide the rest of a truncated local timestepping cycle!" << endl;
+            throw std::runtime_error("Timestep changed during local timestepping cycle!");
+        }
+        truncated = true;
+        dt_base = tm.dt;
+    } else if (mid_cycle && tm.dt != dt_base) {
+        cerr << "Base timestep changed within a local timestepping cycle!" << endl;
+        throw std::runtime_error("Timestep changed during local timestepping cycle!");
+    } else if (!mid_cycle) {
+        // Start a new cycle, at the driver's current timestep
+        levels = AssignLevels(pmesh, params, tm.dt);
+        int cycle = 1 << *std::max_element(levels.begin(), levels.end());
+        // Parthenon shortens the last step to end exactly at tlim, which would leave shells mid-step.
+        // Step everything together for any cycle which might reach it (with a step's margin for roundoff)
+        if (cycle > 1 && tm.time + (cycle + 1) * tm.dt > tm.tlim) {
+            std::fill(levels.begin(), levels.end(), 0);
+        }
+        shell_start.assign(nshells, tm.time);
+        shell_end.assign(nshells, tm.time);
+        truncated = false;
+        dt_base = tm.dt;
+    }
+
+    // Shells whose last step has ended start their next
+    for (int s = 0; s < nshells; ++s) {
+        if (ended_by(shell_end[s], tm.time, tm.dt)) {
+            shell_start[s] = tm.time;
+            shell_end[s] = tm.time + (1 << levels[s]) * tm.dt;
+        }
+    }
+    cycle_end = *std::max_element(shell_end.begin(), shell_end.end());
+    const Real step_end = tm.time + tm.dt;
+
+    params.Update<std::vector<int>>("levels", levels);
+    params.Update<std::vector<Real>>("shell_start", shell_start);
+    params.Update<std::vector<Real>>("shell_end", shell_end);
+    params.Update<Real>("cycle_end", cycle_end);
+    params.Update<Real>("dt_base", dt_base);
+    params.Update<bool>("truncated", truncated);
+    params.Update<Real>("step_end", step_end);
+
+    // (Re)allocate device state
+    auto active = params.Get<ParArray1D<int>>("active");
+    auto dt_factor = params.Get<ParArray1D<Real>>("dt_factor");
+    auto ghosts = params.Get<ParArray1D<int>>("ghosts");
+    auto theta = params.Get<ParArray3D<Real>>("theta");
+    auto snapshot = params.Get<ParArray2D<int>>("snapshot");
+    auto freeze = params.Get<ParArray2D<int>>("freeze");
+    if (active.extent_int(0) != nbtotal) {
+        active = ParArray1D<int>("lts_active", nbtotal);
+        dt_factor = ParArray1D<Real>("lts_dt_factor", nbtotal);
+        ghosts = ParArray1D<int>("lts_ghosts", nbtotal);
+        theta = ParArray3D<Real>("lts_theta", nbtotal, nstages, 2);
+        snapshot = ParArray2D<int>("lts_snapshot", nbtotal, 2);
+        freeze = ParArray2D<int>("lts_freeze", nbtotal, 2);
+        params.Update<ParArray1D<int>>("active", active);
+        params.Update<ParArray1D<Real>>("dt_factor", dt_factor);
+        params.Update<ParArray1D<int>>("ghosts", ghosts);
+        params.Update<ParArray3D<Real>>("theta", theta);
+        params.Update<ParArray2D<int>>("snapshot", snapshot);
+        params.Update<ParArray2D<int>>("freeze", freeze);
+        params.Update<ParArray1D<int>::HostMirror>("active_h", Kokkos::create_mirror_view(active));
+        params.Update<ParArray1D<int>::HostMirror>("ghosts_h", Kokkos::create_mirror_view(ghosts));
+    }
+    auto active_h = params.Get<ParArray1D<int>::HostMirror>("active_h");
+    auto dt_factor_h = Kokkos::create_mirror_view(dt_factor);
+    auto ghosts_h = params.Get<ParArray1D<int>::HostMirror>("ghosts_h");
+    auto theta_h = Kokkos::create_mirror_view(theta);
+    auto snapshot_h = Kokkos::create_mirror_view(snapshot);
+    auto freeze_h = Kokkos::create_mirror_view(freeze);
+
+    // Steps of different shells are nested: a shell's step begins & ends with steps of any faster neighbor.
+    // A shell stepping now goes from tm.time to shell_end, through tm.time + stage_time[s]*(shell_end - tm.time)
+    for (auto &pmb : pmesh->block_list) {
+        const int gid = pmb->gid;
+        const int shell = pmb->loc.lx1;
+        const bool is_active = same_time(shell_start[shell], tm.time, tm.dt);
+        // Blocks stepping next need their x1 ghost zones, interpolated on the last stage, inverted.
+        // This also inverts the (unused) raw ghost zones after earlier stages
+        const bool steps_next = same_time(shell_end[shell], step_end, tm.dt);
+        active_h(gid) = is_active;
+        dt_factor_h(gid) = 1 << levels[shell];
+        ghosts_h(gid) = !is_active && steps_next;
+
+        for (int side = 0; side < 2; ++side) {
+            const int nb_shell = shell + 2*side - 1;
+            const bool has_nb = (nb_shell >= 0 && nb_shell < nshells);
+            const int nb = has_nb ? nb_shell : shell;
+            const bool nb_active = same_time(shell_start[nb], tm.time, tm.dt);
+            // Record the neighbor's state before it steps.  It reached this time exactly
+            // at the end of its last step, so the ghost zones weren't interpolated
+            snapshot_h(gid, side) = has_nb && nb_active;
+            // Freeze the face's flux over each step of the slower side, the longer of the two
+            if (same_time(shell_start[nb], shell_start[shell], tm.dt) && same_time(shell_end[nb], shell_end[shell], tm.dt)) {
+                freeze_h(gid, side) = FreezeMode::none;
+            } else {
+                const int slow = (shell_end[nb] - shell_start[nb] > shell_end[shell] - shell_start[shell]) ? nb : shell;
+                freeze_h(gid, side) = same_time(shell_start[slow], tm.time, tm.dt) ? FreezeMode::capture : FreezeMode::reuse;
+            }
+            // Weight of the synchronized ghost zones after each stage, vs those at the start of the
+            // neighbor's current step.  Ghost zones are needed at the time of this block's next stage,
+            // or of the base state at the end of this step of the driver.
+            // Intermediate stages of a slower block fall after the end of a faster neighbor's step
+            // (e.g. rk2's first stage, at the end of the slower step): rather than extrapolating past the
+            // neighbor's latest state, hold it there.  This is no less accurate than the frozen fluxes
+            // at the face, and keeps the ghost zones within the range of states the neighbor actually took
+            const Real nb_span = shell_end[nb] - shell_start[nb];
+            for (int s = 0; s < nstages; ++s) {
+                const bool last = (s == nstages - 1);
+                theta_h(gid, s, side) = 1.;
+                if (!has_nb || !(last ? steps_next : is_active)) continue;
+                const Real t = last ? step_end : tm.time + stage_time[s] * (shell_end[shell] - tm.time);
+                const Real span = nb_active ? stage_time[s] * nb_span : nb_span;
+                theta_h(gid, s, side) = std::min(std::max((t - shell_start[nb]) / span, 0.), 1.);
+            }
+        }
+    }
+    Kokkos::deep_copy(active, active_h);
+    Kokkos::deep_copy(dt_factor, dt_factor_h);
+    Kokkos::deep_copy(ghosts, ghosts_h);
+    Kokkos::deep_copy(theta, theta_h);
+    Kokkos::deep_copy(snapshot, snapshot_h);
+    Kokkos::deep_copy(freeze, freeze_h);
+
+    // Record any ghost zones we'll need to interpolate from
+    const int num_partitions = pmesh->DefaultNumPartitions();
+    for (int i = 0; i < num_partitions; ++i) {
+        auto &md = pmesh->mesh_data.GetOrAdd("base", i);
+        auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+        const auto& U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved});
+        const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+        const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+        const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+        const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+        const int nvar = U.GetDim(4);
+        const int ng = ib.s;
+        const int gid0 = pmb0->gid;
+        const int lid0 = pmb0->lid;
+
+        auto ghosts_old = params.Get<ParArray5D<Real>>("ghosts_old");
+        if (ghosts_old.extent_int(0) != 2*nblocks || ghosts_old.extent_int(1) != nvar) {
+            ghosts_old = ParArray5D<Real>("lts_ghosts_old", 2*nblocks, nvar, kb.e + 1, jb.e + 1, ng);
+            params.Update<ParArray5D<Real>>("ghosts_old", ghosts_old);
+        }
+
+        pmb0->par_for("lts_snapshot_ghosts", block.s, block.e, kb.s, kb.e, jb.s, jb.e, 0, 2*ng - 1,
+            KOKKOS_LAMBDA_MESH_3D {
+                const int side = i / ng, ig = i % ng;
+                if (!snapshot(gid0 + b, side)) return;
+                const int iz = (side == 0) ? ig : ib.e + 1 + ig;
+                for (int p = 0; p < nvar; ++p)
+                    ghosts_old(2*(lid0 + b) + side, p, k, j, ig) = U(b, p, k, j, iz);
+            }
+        );
+    }
+    Flag("Started");
+}
+
+Real BlockTimestep(MeshBlock *pmb, Real dt_cfl, Real dt)
+{
+    auto& params = pmb->packages.Get("LocalTimestep")->AllParams();
+    const auto& block_dt = params.Get<ParArray1D<Real>::HostMirror>("block_dt");
+    const auto& block_over = params.Get<ParArray1D<int>::HostMirror>("block_over");
+    const auto& active_h = params.Get<ParArray1D<int>::HostMirror>("active_h");
+    if (block_dt.extent_int(0) == 0 || active_h.extent_int(0) == 0) return dt;
+    const auto& shell_start = params.Get<std::vector<Real>>("shell_start");
+    const auto& shell_end = params.Get<std::vector<Real>>("shell_end");
+    const Real step_end = params.Get<Real>("step_end");
+    const Real cycle_end = params.Get<Real>("cycle_end");
+    const Real dt_base = params.Get<Real>("dt_base");
+    const int lid = pmb->lid;
+    const int shell = pmb->loc.lx1;
+
+    if (active_h(pmb->gid)) {
+        block_dt(lid) = dt_cfl;
+        // Check the block could take the same step again.  If not, BeginStep ends the cycle early
+        block_over(lid) = dt_cfl < shell_end[shell] - shell_start[shell];
+    }
+    // At the end of a cycle, let every block limit the next base timestep as usual, remembering blocks
+    // which didn't step this time might not have a fresh dt
+    if (ended_by(cycle_end, step_end, dt_base)) {
+        return std::min(dt, block_dt(lid));
+    }
+    // The base timestep is otherwise fixed within a cycle...
+    if (!params.Get<bool>("truncated") && !block_over(lid)) {
+        return dt_base;
+    }
+    // ...unless it's being ended early.  Then, take the longest timestep within this block's limit which
+    // divides the time until the next step in flight ends.  The minimum over blocks will also divide it
+    const Real limit = block_over(lid) ? std::min(dt, dt_cfl) : dt_base;
+    const Real gap = NextEnd(shell_end, step_end, dt_base) - step_end;
+    return gap / std::ceil(gap / limit - 1.e-6);
+}
+
+bool BlockActive(MeshBlock *pmb)
+{
+    if (!pmb->packages.AllPackages().count("LocalTimestep")) return true;
+    const auto& active_h = pmb->packages.Get("LocalTimestep")->Param<ParArray1D<int>::HostMirror>("active_h");
+    return active_h.extent_int(0) == 0 || active_h(pmb->gid);
+}
+
+bool BlockFilled(MeshBlock *pmb)
+{
+    if (!pmb->packages.AllPackages().count("LocalTimestep")) return true;
+    const auto& active_h = pmb->packages.Get("LocalTimestep")->Param<ParArray1D<int>::HostMirror>("active_h");
+    const auto& ghosts_h = pmb->packages.Get("LocalTimestep")->Param<ParArray1D<int>::HostMirror>("ghosts_h");
+    return active_h.extent_int(0) == 0 || active_h(pmb->gid) || ghosts_h(pmb->gid);
+}
+
+BlockSteps GetBlockSteps(MeshBlock *pmb)
+{
+    BlockSteps steps;
+    if (pmb->packages.AllPackages().count("LocalTimestep")) {
+        auto& params = pmb->packages.Get("LocalTimestep")->AllParams();
+        steps.active = params.Get<ParArray1D<int>>("active");
+        steps.dt_factor = params.Get<ParArray1D<Real>>("dt_factor");
+        steps.ghosts = params.Get<ParArray1D<int>>("ghosts");
+    }
+    return steps;
+}
+
+TaskStatus FreezeInterfaceFluxes(MeshData<Real> *md, int stage)
+{
+    Flag(md, "Freezing fluxes between timestep levels");
+    auto pmesh = md->GetMeshPointer();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& params = pmb0->packages.Get("LocalTimestep")->AllParams();
+    const int ndim = pmesh->ndim;
+    const auto freeze = params.Get<ParArray2D<int>>("freeze");
+    const BlockSteps steps = GetBlockSteps(pmb0.get());
+    if (freeze.extent_int(0) == 0) return TaskStatus::complete;
+    // With Flux-CT, the fluxes of B through these faces are replaced by averages of the EMFs on their
+    // edges.  Freezing the fluxes making up those EMFs freezes them too, see B_FluxCT::FluxCT
+    const bool freeze_emf = pmb0->packages.AllPackages().count("B_FluxCT");
+    const bool store = (stage == 1);
+
+    PackIndexMap cons_map;
+    const auto& U = md->PackVariablesAndFluxes(std::vector<MetadataFlag>{Metadata::Conserved}, cons_map);
+    const VarMap m_u(cons_map, true);
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+    const int nvar = U.GetDim(4);
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+    // Rows which enter the EMFs on the face's edges
+    const IndexRange jl = (ndim > 1) ? IndexRange{jb.s - 1, jb.e + 1} : jb;
+    const IndexRange kl = (ndim > 2) ? IndexRange{kb.s - 1, kb.e + 1} : kb;
+
+    auto fluxes_frozen = params.Get<ParArray4D<Real>>("fluxes_frozen");
+    const int nblocks = pmesh->block_list.size();
+    if (fluxes_frozen.extent_int(0) != 2*nblocks || fluxes_frozen.extent_int(1) != nvar + 4) {
+        fluxes_frozen = ParArray4D<Real>("lts_fluxes_frozen", 2*nblocks, nvar + 4, kb.e + 2, jb.e + 2);
+        params.Update<ParArray4D<Real>>("fluxes_frozen", fluxes_frozen);
+    }
+
+    pmb0->par_for("lts_freeze_fluxes", block.s, block.e, kl.s, kl.e, jl.s, jl.e, 0, 1,
+        KOKKOS_LAMBDA (const int& b, const int& k, const int& j, const int& side) {
+            const int gid = gid0 + b;
+            const int mode = freeze(gid, side);
+            if (!steps.is_active(gid) || mode == FreezeMode::none) return;
+            const bool capture = store && mode == FreezeMode::capture;
+            const int slot = 2*(lid0 + b) + side;
+            const int i_f = (side == 0) ? ib.s : ib.e + 1;
+            for (int p = 0; p < nvar; ++p) {
+                if (capture) {
+                    fluxes_frozen(slot, p, k, j) = U(b).flux(X1DIR, p, k, j, i_f);
+                } else {
+                    U(b).flux(X1DIR, p, k, j, i_f) = fluxes_frozen(slot, p, k, j);
+                }
+            }
+            if (freeze_emf) {
+                for (int c = 0; c < 2; ++c) {
+                    for (int dir = X2DIR; dir <= ndim; ++dir) {
+                        Real &F = U(b).flux(dir, m_u.B1, k, j, i_f - 1 + c);
+                        Real &F_frozen = fluxes_frozen(slot, nvar + 2*(dir - X2DIR) + c, k, j);
+                        if (capture) {
+                            F_frozen = F;
+                        } else {
+                            F = F_frozen;
+                        }
+                    }
+                }
+            }
+        }
+    );
+
+    Flag(md, "Frozen");
+    return TaskStatus::complete;
+}
+
+TaskStatus InterpolateGhosts(MeshData<Real> *md, int stage)
+{
+    Flag(md, "Interpolating ghost zones between timestep levels");
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    auto& params = pmb0->packages.Get("LocalTimestep")->AllParams();
+    const auto theta = params.Get<ParArray3D<Real>>("theta");
+    const auto ghosts_old = params.Get<ParArray5D<Real>>("ghosts_old");
+    if (theta.extent_int(0) == 0) return TaskStatus::complete;
+
+    const auto& U = md->PackVariables(std::vector<MetadataFlag>{Metadata::Conserved});
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::entire);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::entire);
+    const IndexRange block = IndexRange{0, U.GetDim(5) - 1};
+    const int nvar = U.GetDim(4);
+    const int ng = ib.s;
+    const int gid0 = pmb0->gid;
+    const int lid0 = pmb0->lid;
+    const int s = stage - 1;
+
+    pmb0->par_for("lts_interpolate_ghosts", block.s, block.e, kb.s, kb.e, jb.s, jb.e, 0, 2*ng - 1,
+        KOKKOS_LAMBDA_MESH_3D {
+            const int side = i / ng, ig = i % ng;
+            const Real th = theta(gid0 + b, s, side);
+            if (th == 1.) return;
+            const int iz = (side == 0) ? ig : ib.e + 1 + ig;
+            const int slot = 2*(lid0 + b) + side;
+            for (int p = 0; p < nvar; ++p) {
+                const Real old = ghosts_old(slot, p, k, j, ig);
+                U(b, p, k, j, iz) = old + th * (U(b, p, k, j, iz) - old);
+            }
+        }
+    );
+
+    Flag(md, "Interpolated");
+    return TaskStatus::complete;
+}
+
+} // namespace LocalTimestep
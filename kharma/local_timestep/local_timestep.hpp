@@ -0,0 +1,156 @@
+/* 
+ *  File: local_timestep.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include <parthenon/parthenon.hpp>
+
+/**
+ * Local timestepping: let the outer parts of a spherical domain take longer steps than the zones
+ * near the horizon & poles, which set the global timestep.
+ *
+ * Each radial "shell" of meshblocks (blocks sharing an x1 position) is assigned a level l, and
+ * takes steps of 2^l times the driver's base timestep: it is updated only on every 2^l-th step,
+ * and left untouched otherwise.  Levels are chosen from the CFL limits of each shell's blocks, with a
+ * margin local_timestep/safety, differ by at most 1 between neighboring shells, and are held fixed for
+ * a "cycle" of 2^max(l) steps, during which the base timestep is also fixed.  Cycles which might reach
+ * tlim are taken at level 0.  Every block's CFL limit is checked against its step after each step it takes:
+ * if one falls short, the cycle is ended as soon as the steps in flight finish, with every other shell
+ * stepping at level 0 meanwhile.
+ *
+ * Shells see each other only through their x1 ghost zones, which are interpolated linearly in time
+ * between the start & end of each neighbor's current step, and never extrapolated past its latest
+ * state (see InterpolateGhosts).
+ * Fluxes through faces between shells of different levels are "frozen" over each step of the slower
+ * shell: both sides calculate them at its start and re-use them until its end (see FreezeInterfaceFluxes).
+ * This keeps the scheme exactly conservative without a flux register or any extra communication,
+ * and keeps divB = 0 under Flux-CT, at the cost of first-order accuracy in time at those faces.
+ *
+ * Enabled with local_timestep/on.  HARM driver & Parthenon's RK integrators only.
+ * Note that outputs & reductions between the ends of cycles will see the slower shells behind in time.
+ */
+namespace LocalTimestep {
+
+/**
+ * Initialize the package, and check that the rest of the simulation is compatible
+ */
+std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin, Packages_t packages);
+
+/**
+ * Start a new cycle at the next step, with every shell at level 0.  Called when restarting,
+ * since the restart file doesn't record the cycle
+ */
+void ResetCycle(Mesh *pmesh);
+
+/**
+ * Called at the start of every step: assign levels if this step starts a new cycle, or end the cycle
+ * early if any block's CFL limit fell short of its step, mark which blocks step this time, and record
+ * the neighbor states they'll interpolate from.
+ * Must be called on all ranks
+ */
+void BeginStep(Mesh *pmesh, const SimTime& tm);
+
+/**
+ * Record a block's CFL timestep dt_cfl, for choosing levels at the start of the next cycle and for
+ * checking it against the block's step, and return the timestep the block allows for the next step of the driver.
+ * dt is the block's estimate after the usual limits, see GRMHD::EstimateTimestep
+ */
+Real BlockTimestep(MeshBlock *pmb, Real dt_cfl, Real dt);
+
+/**
+ * Whether a block is stepped on this step of the driver.  Always true if the package isn't loaded
+ */
+bool BlockActive(MeshBlock *pmb);
+
+/**
+ * Whether any of a block's primitives must be recovered on this step: those of active blocks, and the
+ * x1 ghost zones of blocks stepping next, which are interpolated on the last stage (see InterpolateGhosts).
+ * Always true if the package isn't loaded
+ */
+bool BlockFilled(MeshBlock *pmb);
+
+/**
+ * Per-block step information as needed on device, indexed by gid.
+ * Empty (every block active, with the driver's timestep) unless the package is loaded
+ */
+struct BlockSteps {
+    ParArray1D<int> active;
+    ParArray1D<Real> dt_factor;
+    // Whether an inactive block steps next, see BlockFilled
+    ParArray1D<int> ghosts;
+
+    KOKKOS_INLINE_FUNCTION bool is_active(const int& gid) const
+    {
+        return active.extent_int(0) == 0 || active(gid);
+    }
+    // Whether UtoP, floors & fixups should run over any zones of a block, see BlockFilled
+    KOKKOS_INLINE_FUNCTION bool is_filled(const int& gid) const
+    {
+        return is_active(gid) || ghosts(gid);
+    }
+    // Whether they should run over zone i of a block with interior ib in x1
+    KOKKOS_INLINE_FUNCTION bool fills_zone(const int& gid, const int& i, const IndexRange& ib) const
+    {
+        return is_active(gid) || (ghosts(gid) && (i < ib.s || i > ib.e));
+    }
+    KOKKOS_INLINE_FUNCTION Real factor(const int& gid) const
+    {
+        return (dt_factor.extent_int(0) == 0) ? 1. : dt_factor(gid);
+    }
+};
+BlockSteps GetBlockSteps(MeshBlock *pmb);
+
+/**
+ * Treatment of the flux through a block's face with a neighboring shell:
+ * calculated fresh every stage, captured at stage 1 for re-use, or replaced by the last capture
+ */
+enum FreezeMode {none=0, capture, reuse};
+
+/**
+ * Capture or restore the x1 fluxes through faces between levels, and with Flux-CT the x2/x3 fluxes
+ * of B1 either side of them, which make up the EMFs on their edges.
+ * Must be run after the fluxes are calculated & fixed, but before B_FluxCT::TransportB
+ */
+TaskStatus FreezeInterfaceFluxes(MeshData<Real> *md, int stage);
+
+/**
+ * Interpolate the x1 ghost zones of the container for this stage in time, between each neighbor's
+ * state at the start of its current step (recorded by BeginStep) and the state just synchronized.
+ * Stages after the neighbor's latest state use that state as-is.
+ * Must be run after the boundary sync of each stage
+ */
+TaskStatus InterpolateGhosts(MeshData<Real> *md, int stage);
+
+} // namespace LocalTimestep
@@ -6,6 +6,9 @@
 // Trust me it makes everything 1000x more readable
 #pragma once
 
+#include <string>
+#include <vector>
+
 // TODO overloads for single
 
 #ifdef MPI_PARALLEL
@@ -107,6 +110,32 @@ inline void MPIReduceVector(double *vec_send, double *vec_recv, int len)
 {
     MPI_Allreduce(vec_send, vec_recv, len, MPI_DOUBLE, MPI_SUM, comm);
 }
+inline void MPIMinVector(double *vec_send, double *vec_recv, int len)
+{
+    MPI_Allreduce(vec_send, vec_recv, len, MPI_DOUBLE, MPI_MIN, comm);
+}
+inline void MPIMaxVector(double *vec_send, double *vec_recv, int len)
+{
+    MPI_Allreduce(vec_send, vec_recv, len, MPI_DOUBLE, MPI_MAX, comm);
+}
+
+// STRING
+// Concatenation of every rank's string, in rank order
+inline std::string MPIAllgatherString(const std::string& s)
+{
+    int len = s.size();
+    const int nranks = parthenon::Globals::nranks;
+    std::vector<int> lens(nranks), offsets(nranks);
+    MPI_Allgather(&len, 1, MPI_INT, lens.data(), 1, MPI_INT, comm);
+    int total = 0;
+    for (int r = 0; r < nranks; r++) {
+        offsets[r] = total;
+        total += lens[r];
+    }
+    std::vector<char> all(total);
+    MPI_Allgatherv(s.data(), len, MPI_CHAR, all.data(), lens.data(), offsets.data(), MPI_CHAR, comm);
+    return std::string(all.begin(), all.end());
+}
 #else
 // Dummy versions of calls
 
@@ -134,4 +163,16 @@ inline void MPIReduceVector(double *vec_send, double *vec_recv, int len)
     for (int i = 0; i < len; i++)
         vec_recv[i] = vec_send[i];
 }
+inline void MPIMinVector(double *vec_send, double *vec_recv, int len)
+{
+    for (int i = 0; i < len; i++)
+        vec_recv[i] = vec_send[i];
+}
+inline void MPIMaxVector(double *vec_send, double *vec_recv, int len)
+{
+    for (int i = 0; i < len; i++)
+        vec_recv[i] = vec_send[i];
+}
+
+inline std::string MPIAllgatherString(const std::string& s) { return s; }
 #endif // MPI_PARALLEL
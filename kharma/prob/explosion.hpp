@@ -62,17 +62,16 @@ TaskStatus InitializeExplosion(MeshBlockData<Real> *rc, ParameterInput *pin)
 
     Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
 
-    // TODO take these at runtime
-    Real u_out = 3.e-5 / (gam-1);
-    Real rho_out = 1.e-4;
+    Real u_out = pin->GetOrAddReal("explosion", "u_out", 3.e-5 / (gam-1));
+    Real rho_out = pin->GetOrAddReal("explosion", "rho_out", 1.e-4);
 
-    Real u_in = 1.0 / (gam-1);
-    Real rho_in = 1.e-2;
+    Real u_in = pin->GetOrAddReal("explosion", "u_in", 1.0 / (gam-1));
+    Real rho_in = pin->GetOrAddReal("explosion", "rho_in", 1.e-2);
 
     // One buffer zone of linear decline, r_in -> r_out
     // Exponential decline inside here i.e. linear in logspace
-    GReal r_in = 0.8;
-    GReal r_out = 1.0;
+    GReal r_in = pin->GetOrAddReal("explosion", "r_in", 0.8);
+    GReal r_out = pin->GetOrAddReal("explosion", "r_out", 1.0);
     // Circle center
     GReal xoff = 0.0;
     GReal yoff = 0.0;
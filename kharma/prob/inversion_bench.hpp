@@ -0,0 +1,229 @@
+/* 
+ *  File: inversion_bench.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include "grmhd_functions.hpp"
+#include "pack.hpp"
+#include "U_to_P_solvers.hpp"
+
+#include <random>
+
+using namespace std;
+using namespace parthenon;
+
+/**
+ * Benchmark of the primitive recovery algorithms in U_to_P_solvers.hpp, rather than a problem to evolve.
+ *
+ * Fills the block with magnetized states sampled log-uniformly in density, temperature u/rho,
+ * magnetization sigma = B^2/rho and Lorentz factor, in random directions.
+ * Then for each inverter, recovers the primitives from the corresponding conserved variables,
+ * starting from a guess perturbed by up to a fraction guess_perturbation, and reports the
+ * failure rate, mean iterations, largest error in rho, and time per zone.
+ * The default inverter is also run batched as with perf/batch_utop, UTOP_BATCH zones at a time,
+ * to compare against the scalar path.  That path doesn't count iterations.
+ * Only the first block reports.  Run with parthenon/time/nlim=0, see tests/performance/inversion.sh
+ */
+TaskStatus InitializeInversionBench(MeshBlockData<Real> *rc, ParameterInput *pin)
+{
+    Flag(rc, "Initializing inversion benchmark");
+    auto pmb = rc->GetBlockPointer();
+    GridScalar rho = rc->Get("prims.rho").data;
+    GridScalar u = rc->Get("prims.u").data;
+    GridVector uvec = rc->Get("prims.uvec").data;
+    GridVector B_P = rc->Get("prims.B").data;
+
+    const Real gam = pmb->packages.Get("GRMHD")->Param<Real>("gamma");
+
+    const Real rho_min = pin->GetOrAddReal("inversion_bench", "rho_min", 1.e-6);
+    const Real rho_max = pin->GetOrAddReal("inversion_bench", "rho_max", 1.);
+    const Real u_over_rho_min = pin->GetOrAddReal("inversion_bench", "u_over_rho_min", 1.e-3);
+    const Real u_over_rho_max = pin->GetOrAddReal("inversion_bench", "u_over_rho_max", 1.e2);
+    const Real sigma_min = pin->GetOrAddReal("inversion_bench", "sigma_min", 1.e-3);
+    const Real sigma_max = pin->GetOrAddReal("inversion_bench", "sigma_max", 1.e4);
+    const Real gamma_max = pin->GetOrAddReal("inversion_bench", "gamma_max", 50.);
+    const Real guess_perturbation = pin->GetOrAddReal("inversion_bench", "guess_perturbation", 0.1);
+    const int nrepeat = pin->GetOrAddInteger("inversion_bench", "nrepeat", 10);
+    const int seed = pin->GetOrAddInteger("inversion_bench", "seed", 31337);
+
+    const auto& G = pmb->coords;
+
+    IndexDomain domain = IndexDomain::entire;
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(domain);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(domain);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(domain);
+    const int nzones = (ib.e - ib.s + 1) * (jb.e - jb.s + 1) * (kb.e - kb.s + 1);
+
+    // Sample states serially on the host, so they don't depend on the backend.
+    // Assumes Minkowski space in Cartesian coordinates, where u~^i = gamma v^i
+    std::mt19937 gen(seed + pmb->gid);
+    std::uniform_real_distribution<Real> uniform(0., 1.);
+    std::normal_distribution<Real> normal(0., 1.);
+    auto log_uniform = [&](const Real lo, const Real hi) { return lo * pow(hi / lo, uniform(gen)); };
+    auto rho_true = rho.GetHostMirrorAndCopy();
+    auto u_true = u.GetHostMirrorAndCopy();
+    auto uvec_true = uvec.GetHostMirrorAndCopy();
+    auto B_true = B_P.GetHostMirrorAndCopy();
+    for (int k = kb.s; k <= kb.e; k++)
+        for (int j = jb.s; j <= jb.e; j++)
+            for (int i = ib.s; i <= ib.e; i++) {
+                rho_true(k, j, i) = log_uniform(rho_min, rho_max);
+                u_true(k, j, i) = rho_true(k, j, i) * log_uniform(u_over_rho_min, u_over_rho_max);
+                const Real gamma = log_uniform(1., gamma_max);
+                const Real B_mag = sqrt(rho_true(k, j, i) * log_uniform(sigma_min, sigma_max));
+                Real vdir[NVEC], Bdir[NVEC];
+                VLOOP {
+                    vdir[v] = normal(gen);
+                    Bdir[v] = normal(gen);
+                }
+                const Real vnorm = sqrt(vdir[0]*vdir[0] + vdir[1]*vdir[1] + vdir[2]*vdir[2]);
+                const Real Bnorm = sqrt(Bdir[0]*Bdir[0] + Bdir[1]*Bdir[1] + Bdir[2]*Bdir[2]);
+                VLOOP {
+                    uvec_true(v, k, j, i) = sqrt(gamma * gamma - 1.) * vdir[v] / vnorm;
+                    B_true(v, k, j, i) = B_mag * Bdir[v] / Bnorm;
+                }
+            }
+    rho.DeepCopy(rho_true);
+    u.DeepCopy(u_true);
+    uvec.DeepCopy(uvec_true);
+    B_P.DeepCopy(B_true);
+
+    // Conserved variables corresponding to the true states
+    PackIndexMap prims_map, cons_map;
+    auto P = GRMHD::PackMHDPrims(rc, prims_map);
+    auto U = GRMHD::PackMHDCons(rc, cons_map);
+    const VarMap m_u(cons_map, true), m_p(prims_map, false);
+    pmb->par_for("inversion_bench_p_to_u", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_3D {
+            GRMHD::p_to_u(G, P, m_p, gam, k, j, i, U, m_u);
+        }
+    );
+
+    // Guesses: the true states with rho, u and the velocity each off by up to +-guess_perturbation
+    auto rho_guess = rho.GetHostMirrorAndCopy();
+    auto u_guess = u.GetHostMirrorAndCopy();
+    auto uvec_guess = uvec.GetHostMirrorAndCopy();
+    for (int k = kb.s; k <= kb.e; k++)
+        for (int j = jb.s; j <= jb.e; j++)
+            for (int i = ib.s; i <= ib.e; i++) {
+                rho_guess(k, j, i) *= 1. + guess_perturbation * (2. * uniform(gen) - 1.);
+                u_guess(k, j, i) *= 1. + guess_perturbation * (2. * uniform(gen) - 1.);
+                const Real vfac = 1. + guess_perturbation * (2. * uniform(gen) - 1.);
+                VLOOP uvec_guess(v, k, j, i) *= vfac;
+            }
+
+    ParArray3D<int> niter("inversion_bench_niter", kb.e + 1, jb.e + 1, ib.e + 1);
+    ParArray3D<int8_t> pflag("inversion_bench_pflag", kb.e + 1, jb.e + 1, ib.e + 1);
+    const std::vector<InversionType> types = {InversionType::onedw, InversionType::twod,
+                                              InversionType::palenzuela, InversionType::kastaun};
+    const std::vector<std::string> names = {"onedw", "twod", "palenzuela", "kastaun"};
+    GRMHD::InversionSettings inv(pmb->packages.Get("GRMHD")->AllParams());
+    if (pmb->gid == 0 && MPIRank0()) {
+        cout << "Inversion benchmark: " << nzones << " zones, sigma " << sigma_min << "-" << sigma_max
+             << ", gamma 1-" << gamma_max << ", guesses off by " << guess_perturbation << endl;
+    }
+    // The last pass is the batched onedw solve
+    const int ntypes = types.size();
+    for (int n = 0; n <= ntypes; ++n) {
+        const bool batch = (n == ntypes);
+        inv.type = batch ? InversionType::onedw : types[n];
+
+        double elapsed = 0.;
+        for (int rep = 0; rep < nrepeat; ++rep) {
+            rho.DeepCopy(rho_guess);
+            u.DeepCopy(u_guess);
+            uvec.DeepCopy(uvec_guess);
+            Kokkos::fence();
+            Kokkos::Timer timer;
+            if (batch) {
+                const int nbatch = (ib.e - ib.s + UTOP_BATCH) / UTOP_BATCH;
+                pmb->par_for("inversion_bench_batch", kb.s, kb.e, jb.s, jb.e, 0, nbatch - 1,
+                    KOKKOS_LAMBDA_3D {
+                        const int is = ib.s + i * UTOP_BATCH;
+                        bool active[UTOP_BATCH];
+                        InversionStatus status[UTOP_BATCH];
+                        for (int l = 0; l < UTOP_BATCH; ++l) active[l] = is + l <= ib.e;
+                        GRMHD::u_to_p_batch<UTOP_BATCH>(G, U, m_u, gam, k, j, is, Loci::center, P, m_p, active, status);
+                        for (int l = 0; l < UTOP_BATCH && is + l <= ib.e; ++l) {
+                            pflag(k, j, is + l) = status[l];
+                            niter(k, j, is + l) = 0;
+                        }
+                    }
+                );
+            } else {
+                pmb->par_for("inversion_bench", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+                    KOKKOS_LAMBDA_3D {
+                        pflag(k, j, i) = GRMHD::u_to_p_select(inv, G, U, m_u, gam, k, j, i, Loci::center,
+                                                              P, m_p, niter(k, j, i));
+                    }
+                );
+            }
+            Kokkos::fence();
+            elapsed += timer.seconds();
+        }
+
+        // Tally results on the host
+        auto pflag_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), pflag);
+        auto rho_host = rho.GetHostMirrorAndCopy();
+        auto niter_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), niter);
+        int nfail = 0;
+        long int niter_total = 0;
+        Real max_err = 0.;
+        for (int k = kb.s; k <= kb.e; k++)
+            for (int j = jb.s; j <= jb.e; j++)
+                for (int i = ib.s; i <= ib.e; i++) {
+                    niter_total += niter_host(k, j, i);
+                    if (pflag_host(k, j, i) != InversionStatus::success) {
+                        nfail++;
+                    } else {
+                        max_err = max(max_err, fabs(rho_host(k, j, i) / rho_true(k, j, i) - 1.));
+                    }
+                }
+        if (pmb->gid == 0 && MPIRank0()) {
+            const std::string name = batch ? "onedw_batch" : names[n];
+            fprintf(stdout, "%-12s failed %8.4f%%  mean iterations %6.2f  max rho error %8.2e  %8.2f ns/zone\n",
+                    name.c_str(), 100. * nfail / nzones, ((Real) niter_total) / nzones, max_err,
+                    1.e9 * elapsed / (nrepeat * nzones));
+        }
+    }
+
+    // Leave the true states behind
+    rho.DeepCopy(rho_true);
+    u.DeepCopy(u_true);
+    uvec.DeepCopy(uvec_true);
+
+    Flag(rc, "Initialized inversion benchmark");
+    return TaskStatus::complete;
+}
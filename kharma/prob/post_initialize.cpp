@@ -44,6 +44,8 @@
 #include "flux.hpp"
 #include "gr_coordinates.hpp"
 #include "kharma.hpp"
+#include "local_timestep.hpp"
+#include "recon_bench.hpp"
 #include "types.hpp"
 
 #include "seed_B_ct.hpp"
@@ -214,6 +216,9 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart, b
     if (is_restart) {
         // Parthenon restored our global data for us, but we don't always want that
         KHARMA::ResetGlobals(pin, pmesh);
+        // Local timestepping cycles are started over, rather than saved
+        if (pmesh->packages.AllPackages().count("LocalTimestep"))
+            LocalTimestep::ResetCycle(pmesh);
     }
 
     // If we resized the array, cleanup any field divergence we created
@@ -229,5 +234,10 @@ void KHARMA::PostInitialize(ParameterInput *pin, Mesh *pmesh, bool is_restart, b
         KBoundaries::SyncAllBounds(pmesh, sync_prims);
     }
 
+    // Benchmarks which need the whole mesh, with ghost zones filled
+    if (pin->GetString("parthenon/job", "problem_id") == "recon_bench") {
+        RunReconBench(pin, pmesh);
+    }
+
     Flag("Post-initialization finished");
 }
@@ -49,6 +49,8 @@
 #include "emhdmodes.hpp"
 #include "explosion.hpp"
 #include "fm_torus.hpp"
+#include "inversion_bench.hpp"
+#include "recon_bench.hpp"
 #include "resize_restart.hpp"
 #include "kelvin_helmholtz.hpp"
 #include "bz_monopole.hpp"
@@ -106,6 +108,11 @@ void KHARMA::ProblemGenerator(MeshBlock *pmb, ParameterInput *pin)
         status = InitializeFMTorus(rc.get(), pin);
     } else if (prob == "resize_restart") {
         status = ReadIharmRestart(rc.get(), pin);
+    // Benchmarks
+    } else if (prob == "inversion_bench") {
+        status = InitializeInversionBench(rc.get(), pin);
+    } else if (prob == "recon_bench") {
+        status = InitializeReconBench(rc.get(), pin);
     }
 
     // If we didn't initialize a problem, yell
@@ -0,0 +1,213 @@
+/* 
+ *  File: recon_bench.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "recon_bench.hpp"
+
+#include "flux.hpp"
+#include "reconstruction.hpp"
+
+#include <random>
+
+using namespace std;
+using namespace parthenon;
+
+TaskStatus InitializeReconBench(MeshBlockData<Real> *rc, ParameterInput *pin)
+{
+    Flag(rc, "Initializing reconstruction benchmark");
+    auto pmb = rc->GetBlockPointer();
+    GridScalar rho = rc->Get("prims.rho").data;
+    GridScalar u = rc->Get("prims.u").data;
+    GridVector uvec = rc->Get("prims.uvec").data;
+    GridVector B_P = rc->Get("prims.B").data;
+
+    const Real noise = pin->GetOrAddReal("recon_bench", "noise", 0.1);
+    const int seed = pin->GetOrAddInteger("recon_bench", "seed", 31337);
+
+    const auto& G = pmb->coords;
+
+    const IndexRange ib = pmb->cellbounds.GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = pmb->cellbounds.GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = pmb->cellbounds.GetBoundsK(IndexDomain::interior);
+
+    // Sample noise serially on the host so the state doesn't depend on the backend:
+    // one number for each of rho, u, and the components of uvec and B
+    std::mt19937 gen(seed + pmb->gid);
+    std::uniform_real_distribution<Real> uniform(-1., 1.);
+    ParArray4D<Real> jitter("recon_bench_jitter", 2 + 2*NVEC, kb.e + 1, jb.e + 1, ib.e + 1);
+    auto jitter_h = Kokkos::create_mirror_view(jitter);
+    for (int k = kb.s; k <= kb.e; k++)
+        for (int j = jb.s; j <= jb.e; j++)
+            for (int i = ib.s; i <= ib.e; i++)
+                for (int v = 0; v < 2 + 2*NVEC; v++)
+                    jitter_h(v, k, j, i) = noise * uniform(gen);
+    Kokkos::deep_copy(jitter, jitter_h);
+
+    pmb->par_for("recon_bench_init", kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
+        KOKKOS_LAMBDA_3D {
+            Real X[GR_DIM];
+            G.coord_embed(k, j, i, Loci::center, X);
+            const Real phase = 2. * M_PI * (X[1] + X[2] + X[3]);
+            rho(k, j, i) = (1. + 0.5 * sin(phase)) * (1. + jitter(0, k, j, i));
+            u(k, j, i) = (1. + 0.5 * cos(phase)) * (1. + jitter(1, k, j, i));
+            VLOOP {
+                uvec(v, k, j, i) = 0.1 * sin(phase + v) + jitter(2 + v, k, j, i);
+                B_P(v, k, j, i) = 1. + 0.5 * cos(phase + v) + jitter(2 + NVEC + v, k, j, i);
+            }
+        }
+    );
+
+    Flag(rc, "Initialized reconstruction benchmark");
+    return TaskStatus::complete;
+}
+
+/**
+ * Reconstruct every primitive at every face in direction dir, to ql/qr.
+ * Each face is reconstructed on its own, directly from the zone centers, with nothing after it
+ */
+template <ReconstructionType Recon, int dir>
+void ReconstructAll(MeshData<Real> *md, const ParArray5D<FluxReal>& ql, const ParArray5D<FluxReal>& qr)
+{
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+    const int ndim = md->GetMeshPointer()->ndim;
+    if (ndim < 3 && dir == X3DIR) return;
+    if (ndim < 2 && dir == X2DIR) return;
+
+    const MetadataFlag isPrimitive = pmb0->packages.Get("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
+    const auto& P_all = md->PackVariables(std::vector<MetadataFlag>{isPrimitive});
+
+    // Faces of the interior zones, including the last face in dir
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const IndexRange block = IndexRange{0, P_all.GetDim(5) - 1};
+    const int nprim = P_all.GetDim(4);
+    pmb0->par_for("recon_bench", block.s, block.e, 0, nprim - 1, kb.s, kb.e + (dir == X3DIR),
+                  jb.s, jb.e + (dir == X2DIR), ib.s, ib.e + (dir == X1DIR),
+        KOKKOS_LAMBDA_MESH_VARS {
+            const auto& P = P_all(b);
+            KReconstruction::reconstruct_face<Recon, dir>(P, p, k, j, i, ql(b, p, k, j, i), qr(b, p, k, j, i));
+        }
+    );
+}
+
+/**
+ * Time reconstruction alone and the full flux calculation with one scheme,
+ * in seconds per repetition
+ */
+template <ReconstructionType Recon>
+void TimeScheme(MeshData<Real> *md, const ParArray5D<FluxReal>& ql, const ParArray5D<FluxReal>& qr,
+                const int nrepeat, double& t_recon, double& t_flux)
+{
+    // Untimed pass first, so first-touch and any lazy allocation aren't counted
+    for (int rep = 0; rep <= nrepeat; ++rep) {
+        Kokkos::fence();
+        Kokkos::Timer timer;
+        ReconstructAll<Recon, X1DIR>(md, ql, qr);
+        ReconstructAll<Recon, X2DIR>(md, ql, qr);
+        ReconstructAll<Recon, X3DIR>(md, ql, qr);
+        Kokkos::fence();
+        if (rep > 0) t_recon += timer.seconds();
+    }
+    for (int rep = 0; rep <= nrepeat; ++rep) {
+        Kokkos::fence();
+        Kokkos::Timer timer;
+        Flux::GetFlux<Recon, X1DIR>(md, Flux::FluxRegion::all, 0);
+        Flux::GetFlux<Recon, X2DIR>(md, Flux::FluxRegion::all, 0);
+        Flux::GetFlux<Recon, X3DIR>(md, Flux::FluxRegion::all, 0);
+        Kokkos::fence();
+        if (rep > 0) t_flux += timer.seconds();
+    }
+    t_recon /= nrepeat;
+    t_flux /= nrepeat;
+}
+
+void RunReconBench(ParameterInput *pin, Mesh *pmesh)
+{
+    Flag("Running reconstruction benchmark");
+    const int nrepeat = pin->GetOrAddInteger("recon_bench", "nrepeat", 10);
+    auto md = pmesh->mesh_data.GetOrAdd("base", 0).get();
+    auto pmb0 = md->GetBlockData(0)->GetBlockPointer();
+
+    const MetadataFlag isPrimitive = pmb0->packages.Get("GRMHD")->Param<MetadataFlag>("PrimitiveFlag");
+    const auto& P_all = md->PackVariables(std::vector<MetadataFlag>{isPrimitive});
+    const int nblock = P_all.GetDim(5);
+    const int nprim = P_all.GetDim(4);
+    const int n1 = pmb0->cellbounds.ncellsi(IndexDomain::entire);
+    const int n2 = pmb0->cellbounds.ncellsj(IndexDomain::entire);
+    const int n3 = pmb0->cellbounds.ncellsk(IndexDomain::entire);
+    const IndexRange ib = md->GetBoundsI(IndexDomain::interior);
+    const IndexRange jb = md->GetBoundsJ(IndexDomain::interior);
+    const IndexRange kb = md->GetBoundsK(IndexDomain::interior);
+    const long int nzones = ((long int) nblock) * (ib.e - ib.s + 1) * (jb.e - jb.s + 1) * (kb.e - kb.s + 1);
+    ParArray5D<FluxReal> ql("recon_bench_ql", nblock, nprim, n3, n2, n1);
+    ParArray5D<FluxReal> qr("recon_bench_qr", nblock, nprim, n3, n2, n1);
+
+    const std::vector<ReconstructionType> schemes = {ReconstructionType::donor_cell, ReconstructionType::linear_mc,
+                                                     ReconstructionType::linear_vl, ReconstructionType::ppm,
+                                                     ReconstructionType::mp5, ReconstructionType::weno5};
+    if (MPIRank0()) {
+        cout << "Reconstruction benchmark: " << nzones << " zones, " << nprim << " primitives, "
+             << nrepeat << " repetitions" << endl;
+    }
+    for (const auto recon : schemes) {
+        double t_recon = 0., t_flux = 0.;
+        switch (recon) {
+        case ReconstructionType::donor_cell:
+            TimeScheme<ReconstructionType::donor_cell>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        case ReconstructionType::linear_mc:
+            TimeScheme<ReconstructionType::linear_mc>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        case ReconstructionType::linear_vl:
+            TimeScheme<ReconstructionType::linear_vl>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        case ReconstructionType::ppm:
+            TimeScheme<ReconstructionType::ppm>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        case ReconstructionType::mp5:
+            TimeScheme<ReconstructionType::mp5>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        case ReconstructionType::weno5:
+            TimeScheme<ReconstructionType::weno5>(md, ql, qr, nrepeat, t_recon, t_flux);
+            break;
+        default:
+            break;
+        }
+        if (MPIRank0()) {
+            fprintf(stdout, "%-12s recon %8.2f ns/zone  flux %8.2f ns/zone\n",
+                    KReconstruction::ReconstructionName(recon).c_str(),
+                    1.e9 * t_recon / nzones, 1.e9 * t_flux / nzones);
+        }
+    }
+    Flag("Ran reconstruction benchmark");
+}
@@ -0,0 +1,53 @@
+/* 
+ *  File: recon_bench.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "decs.hpp"
+
+#include "types.hpp"
+
+/**
+ * Benchmark of the reconstruction schemes and flux kernels over a fixed state, rather than a problem to evolve.
+ *
+ * Fills each block with a smooth magnetized state plus random noise of relative size noise, so that
+ * the limiters see both smooth regions and extrema.
+ */
+TaskStatus InitializeReconBench(MeshBlockData<Real> *rc, ParameterInput *pin);
+
+/**
+ * Time each reconstruction scheme over the whole mesh, once the ghost zones are filled.
+ * For each scheme, reports ns/zone for reconstructing every primitive at every face in each
+ * direction, and for the full GetFlux in each direction, which adds the fluxes and signal speeds.
+ * Called from KHARMA::PostInitialize.  Run with parthenon/time/nlim=0, see tests/performance/recon.sh
+ */
+void RunReconBench(ParameterInput *pin, Mesh *pmesh);
@@ -34,6 +34,7 @@
 #pragma once
 
 #include "decs.hpp"
+#include "simd.hpp"
 
 #include "reconstruct/dc_inline.hpp"
 #include "reconstruct/plm_inline.hpp"
@@ -48,6 +49,27 @@ using namespace parthenon;
  */
 namespace KReconstruction
 {
+// DONOR CELL
+// Same as Parthenon's DonorCellX*, but fills FluxReal scratch.  X1 stores ql offset by one zone,
+// matching the other X1 row reconstructions.  In X2/X3 ql and qr are filled from the same row j or k,
+// so callers reconstruct each side with a separate call, passing the same scratch twice
+template <int dir, typename T>
+KOKKOS_INLINE_FUNCTION void DonorCellRow(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
+{
+    constexpr int ql_off = (dir == X1DIR);
+    const int nu = q.GetDim(4) - 1;
+    for (int p = 0; p <= nu; ++p) {
+        parthenon::par_for_inner(member, il, iu,
+            KOKKOS_LAMBDA_1D {
+                ql(p, i + ql_off) = q(p, k, j, i);
+                qr(p, i) = q(p, k, j, i);
+            }
+        );
+    }
+}
+
 // BUILD UP (a) LINEAR MC RECONSTRUCTION
 
 // Single-item implementation
@@ -63,8 +85,8 @@ KOKKOS_INLINE_FUNCTION Real mc(const Real dm, const Real dp)
 // qr(1) is then the value at that face reconstructed from the right
 template <typename T>
 KOKKOS_INLINE_FUNCTION void PiecewiseLinearX1(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
@@ -81,8 +103,8 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX1(parthenon::team_mbr_t const &membe
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void PiecewiseLinearX2(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
@@ -99,8 +121,8 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX2(parthenon::team_mbr_t const &membe
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void PiecewiseLinearX3(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T& q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T& q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
     const int nu = q.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
@@ -121,11 +143,13 @@ KOKKOS_INLINE_FUNCTION void PiecewiseLinearX3(parthenon::team_mbr_t const &membe
 // Single-element implementation: "left" and "right" here are relative to zone centers, so the combo calls will switch them later.
 // WENO interpolation. See Tchekhovskoy et al. 2007 (T07), Shu 2011 (S11)
 // Implemented by Monika Moscibrodzka
-KOKKOS_INLINE_FUNCTION void weno5(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
-                                Real &lout, Real &rout)
+// These are pure arithmetic, so they're templated to take either Reals, or a RealVec of several zones at once
+template <typename V>
+KOKKOS_INLINE_FUNCTION void weno5(const V& x1, const V& x2, const V& x3, const V& x4, const V& x5,
+                                V &lout, V &rout)
 {
     // Smoothness indicators, T07 A18 or S11 8
-    Real beta[3], c1, c2;
+    V beta[3], c1, c2;
     c1 = x1 - 2.*x2 + x3; c2 = x1 - 4.*x2 + 3.*x3;
     beta[0] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
     c1 = x2 - 2.*x3 + x4; c2 = x4 - x2;
@@ -134,14 +158,14 @@ KOKKOS_INLINE_FUNCTION void weno5(const Real& x1, const Real& x2, const Real& x3
     beta[2] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
 
     // Nonlinear weights S11 9
-    Real den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
+    V den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
     den[0] *= den[0]; den[1] *= den[1]; den[2] *= den[2];
 
-    Real wtr[3] = {(1./16.)/den[0], (5./8. )/den[1], (5./16.)/den[2]};
-    Real Wr = wtr[0] + wtr[1] + wtr[2];
+    V wtr[3] = {(1./16.)/den[0], (5./8. )/den[1], (5./16.)/den[2]};
+    V Wr = wtr[0] + wtr[1] + wtr[2];
 
-    Real wtl[3] = {(1./16.)/den[2], (5./8. )/den[1], (5./16.)/den[0]};
-    Real Wl = wtl[0] + wtl[1] + wtl[2];
+    V wtl[3] = {(1./16.)/den[2], (5./8. )/den[1], (5./16.)/den[0]};
+    V Wl = wtl[0] + wtl[1] + wtl[2];
 
     // S11 1, 2, 3
     lout = ((3./8.)*x5 - (5./4.)*x4 + (15./8.)*x3)*(wtl[0] / Wl) +
@@ -151,11 +175,12 @@ KOKKOS_INLINE_FUNCTION void weno5(const Real& x1, const Real& x2, const Real& x3
             ((-1./8.)*x2 + (3./4.)*x3 + (3./8.)*x4)*(wtr[1] / Wr) +
             ((3./8.)*x3 + (3./4.)*x4 - (1./8.)*x5)*(wtr[2] / Wr);
 }
-KOKKOS_INLINE_FUNCTION void weno5l(const Real x1, const Real& x2, const Real& x3, const Real x4, const Real& x5,
-                                Real &lout)
+template <typename V>
+KOKKOS_INLINE_FUNCTION void weno5l(const V& x1, const V& x2, const V& x3, const V& x4, const V& x5,
+                                V &lout)
 {
     // Smoothness indicators, T07 A18 or S11 8
-    Real beta[3], c1, c2;
+    V beta[3], c1, c2;
     c1 = x1 - 2.*x2 + x3; c2 = x1 - 4.*x2 + 3.*x3;
     beta[0] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
     c1 = x2 - 2.*x3 + x4; c2 = x4 - x2;
@@ -164,22 +189,23 @@ KOKKOS_INLINE_FUNCTION void weno5l(const Real x1, const Real& x2, const Real& x3
     beta[2] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
 
     // Nonlinear weights S11 9
-    Real den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
+    V den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
     den[0] *= den[0]; den[1] *= den[1]; den[2] *= den[2];
 
-    Real wtl[3] = {(1./16.)/den[2], (5./8. )/den[1], (5./16.)/den[0]};
-    Real Wl = wtl[0] + wtl[1] + wtl[2];
+    V wtl[3] = {(1./16.)/den[2], (5./8. )/den[1], (5./16.)/den[0]};
+    V Wl = wtl[0] + wtl[1] + wtl[2];
 
     // S11 1, 2, 3
     lout = ((3./8.)*x5 - (5./4.)*x4 + (15./8.)*x3)*(wtl[0] / Wl) +
             ((-1./8.)*x4 + (3./4.)*x3 + (3./8.)*x2)*(wtl[1] / Wl) +
             ((3./8.)*x3 + (3./4.)*x2 - (1./8.)*x1)*(wtl[2] / Wl);
 }
-KOKKOS_INLINE_FUNCTION void weno5r(const Real& x1, const Real& x2, const Real& x3, const Real x4, const Real& x5,
-                                Real &rout)
+template <typename V>
+KOKKOS_INLINE_FUNCTION void weno5r(const V& x1, const V& x2, const V& x3, const V& x4, const V& x5,
+                                V &rout)
 {
     // Smoothness indicators, T07 A18 or S11 8
-    Real beta[3], c1, c2;
+    V beta[3], c1, c2;
     c1 = x1 - 2.*x2 + x3; c2 = x1 - 4.*x2 + 3.*x3;
     beta[0] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
     c1 = x2 - 2.*x3 + x4; c2 = x4 - x2;
@@ -188,157 +214,442 @@ KOKKOS_INLINE_FUNCTION void weno5r(const Real& x1, const Real& x2, const Real& x
     beta[2] = (13./12.)*c1*c1 + (1./4.)*c2*c2;
 
     // Nonlinear weights S11 9
-    Real den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
+    V den[3] = {EPS + beta[0], EPS + beta[1], EPS + beta[2]};
     den[0] *= den[0]; den[1] *= den[1]; den[2] *= den[2];
 
-    Real wtr[3] = {(1./16.)/den[0], (5./8. )/den[1], (5./16.)/den[2]};
-    Real Wr = wtr[0] + wtr[1] + wtr[2];
+    V wtr[3] = {(1./16.)/den[0], (5./8. )/den[1], (5./16.)/den[2]};
+    V Wr = wtr[0] + wtr[1] + wtr[2];
 
     rout = ((3./8.)*x1 - (5./4.)*x2 + (15./8.)*x3)*(wtr[0] / Wr) +
             ((-1./8.)*x2 + (3./4.)*x3 + (3./8.)*x4)*(wtr[1] / Wr) +
             ((3./8.)*x3 + (3./4.)*x4 - (1./8.)*x5)*(wtr[2] / Wr);
 }
 
+// BUILD UP PPM & MP5 RECONSTRUCTION
+// These use the same 5-zone stencil & single-zone convention as WENO5 above: x3 is the zone center,
+// lout & rout the values at its left & right faces
+
+// Piecewise parabolic method, Colella & Woodward 1984 (CW84).  Ported from HARM's "para"
+KOKKOS_INLINE_FUNCTION void ppm(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                Real &lout, Real &rout)
+{
+    const Real y[5] = {x1, x2, x3, x4, x5};
+
+    // Limited slopes in the central three zones, CW84 1.7 & 1.8
+    Real dq[5] = {0., 0., 0., 0., 0.};
+    for (int i = 1; i < 4; ++i) {
+        const Real Dqm = 2. * (y[i] - y[i-1]);
+        const Real Dqp = 2. * (y[i+1] - y[i]);
+        const Real Dqc = 0.5 * (y[i+1] - y[i-1]);
+        dq[i] = (Dqm * Dqp <= 0.) ? 0. : min(abs(Dqc), min(abs(Dqm), abs(Dqp))) * ((Dqc > 0.) ? 1. : -1.);
+    }
+
+    // Face values CW84 1.6
+    Real l = 0.5*(y[2] + y[1]) - (dq[2] - dq[1]) / 6.0;
+    Real r = 0.5*(y[3] + y[2]) - (dq[3] - dq[2]) / 6.0;
+
+    // Monotonize CW84 1.10
+    const Real qa = (r - y[2])*(y[2] - l);
+    const Real qd = (r - l);
+    const Real qe = 6.0*(y[2] - 0.5*(l + r));
+    if (qa <= 0.) {
+        l = y[2];
+        r = y[2];
+    }
+    if (qd*(qd - qe) < 0.0) {
+        l = 3.0*y[2] - 2.0*r;
+    } else if (qd*(qd + qe) < 0.0) {
+        r = 3.0*y[2] - 2.0*l;
+    }
+
+    lout = l;
+    rout = r;
+}
+
+// Monotonicity-preserving 5th-order reconstruction, Suresh & Huynh 1997 (SH97)
+KOKKOS_INLINE_FUNCTION Real minmod(const Real& a, const Real& b)
+{
+    return (a*b > 0.) ? ((abs(a) < abs(b)) ? a : b) : 0.;
+}
+KOKKOS_INLINE_FUNCTION Real median(const Real& a, const Real& b, const Real& c)
+{
+    return a + minmod(b - a, c - a);
+}
+// Value at the right face of the zone with value Fj
+KOKKOS_INLINE_FUNCTION Real mp5_subcalc(const Real& Fjm2, const Real& Fjm1, const Real& Fj, const Real& Fjp1, const Real& Fjp2)
+{
+    constexpr Real alpha = 4.0, epsm = 1.e-12;
+
+    // Unlimited 5th-order interface value, SH97 2.1
+    const Real f = (2.0*Fjm2 - 13.0*Fjm1 + 47.0*Fj + 27.0*Fjp1 - 3.0*Fjp2) / 60.0;
+
+    // Skip limiting if the value is already monotonicity-preserving, SH97 2.12
+    const Real fMP = Fj + minmod(Fjp1 - Fj, alpha*(Fj - Fjm1));
+    if ((f - Fj)*(f - fMP) <= epsm) return f;
+
+    // Otherwise, limit to a range accommodating local extrema, SH97 2.19-2.26
+    const Real d2m = Fjm2 + Fj - 2.0*Fjm1;
+    const Real d2 = Fjm1 + Fjp1 - 2.0*Fj;
+    const Real d2p = Fj + Fjp2 - 2.0*Fjp1;
+
+    const Real dMMp = minmod(minmod(4.0*d2 - d2p, 4.0*d2p - d2), minmod(d2, d2p));
+    const Real dMMm = minmod(minmod(4.0*d2m - d2, 4.0*d2 - d2m), minmod(d2, d2m));
+
+    const Real fUL = Fj + alpha*(Fj - Fjm1);
+    const Real fAV = 0.5*(Fj + Fjp1);
+    const Real fMD = fAV - 0.5*dMMp;
+    const Real fLC = 0.5*(3.0*Fj - Fjm1) + 4.0/3.0*dMMm;
+
+    const Real Fmin = max(min(min(Fj, Fjp1), fMD), min(min(Fj, fUL), fLC));
+    const Real Fmax = min(max(max(Fj, Fjp1), fMD), max(max(Fj, fUL), fLC));
+
+    return median(f, Fmin, Fmax);
+}
+KOKKOS_INLINE_FUNCTION void mp5(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                Real &lout, Real &rout)
+{
+    rout = mp5_subcalc(x1, x2, x3, x4, x5);
+    lout = mp5_subcalc(x5, x4, x3, x2, x1);
+}
+
+// Whether a scheme is one of the 5-zone schemes.  These aren't TVD, so reconstructed values need floors,
+// and they need no scratch space beyond ql/qr
+KOKKOS_INLINE_FUNCTION constexpr bool is_stencil5(const ReconstructionType recon)
+{
+    return recon == ReconstructionType::weno5 || recon == ReconstructionType::ppm || recon == ReconstructionType::mp5;
+}
+
+// How many zones behind a face its reconstruction stencil reaches, e.g. zones i-3 through i-1 for the
+// left state at face i with the 5-zone schemes.  Sets how many ghost zones a face in the ghost zones needs
+KOKKOS_INLINE_FUNCTION constexpr int stencil_reach(const ReconstructionType recon)
+{
+    return is_stencil5(recon) ? 3 : ((recon == ReconstructionType::donor_cell) ? 1 : 2);
+}
+
+// Name of a reconstruction scheme as given in GRMHD/reconstruction, e.g. for naming timers
+inline std::string ReconstructionName(const ReconstructionType recon)
+{
+    switch (recon) {
+    case ReconstructionType::donor_cell: return "donor_cell";
+    case ReconstructionType::linear_vl: return "linear_vl";
+    case ReconstructionType::linear_mc: return "linear_mc";
+    case ReconstructionType::ppm: return "ppm";
+    case ReconstructionType::mp5: return "mp5";
+    case ReconstructionType::weno5: return "weno5";
+    default: return "unknown";
+    }
+}
+
+// Reconstruction scheme named by GRMHD/reconstruction
+inline ReconstructionType ParseReconstructionType(const std::string& recon)
+{
+    if (recon == "donor_cell") {
+        return ReconstructionType::donor_cell;
+    } else if (recon == "linear_vl") {
+        return ReconstructionType::linear_vl;
+    } else if (recon == "linear_mc") {
+        return ReconstructionType::linear_mc;
+    } else if (recon == "ppm") {
+        return ReconstructionType::ppm;
+    } else if (recon == "mp5") {
+        return ReconstructionType::mp5;
+    } else if (recon == "weno5") {
+        return ReconstructionType::weno5;
+    // weno5_lower_poles (WENO5, dropping to linear reconstruction in the rows nearest the poles) isn't
+    // implemented: the row-wise & single-face paths would need to switch schemes by j
+    // } else if (recon == "weno5_lower_poles") {
+    //     return ReconstructionType::weno5_lower_poles;
+    } else {
+        cerr << "Reconstruction type not supported!  Supported reconstructions:" << endl;
+        cerr << "donor_cell, linear_mc, linear_vl, ppm, mp5, weno5" << endl;
+        throw std::invalid_argument("Unsupported reconstruction algorithm!");
+    }
+}
+
+// Dispatch among the 5-zone stencil schemes, for the row-wise & single-face implementations below
+// recon5l/recon5r only calculate the one side where the scheme allows it
+template <ReconstructionType Recon>
+KOKKOS_INLINE_FUNCTION void recon5(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                   Real &lout, Real &rout) {}
+template <>
+KOKKOS_INLINE_FUNCTION void recon5<ReconstructionType::weno5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                   Real &lout, Real &rout) { weno5(x1, x2, x3, x4, x5, lout, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void recon5<ReconstructionType::ppm>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                   Real &lout, Real &rout) { ppm(x1, x2, x3, x4, x5, lout, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void recon5<ReconstructionType::mp5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                   Real &lout, Real &rout) { mp5(x1, x2, x3, x4, x5, lout, rout); }
+template <ReconstructionType Recon>
+KOKKOS_INLINE_FUNCTION void recon5l(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &lout)
+{
+    // PPM's limiter needs both faces
+    Real rout;
+    recon5<Recon>(x1, x2, x3, x4, x5, lout, rout);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void recon5l<ReconstructionType::weno5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &lout) { weno5l(x1, x2, x3, x4, x5, lout); }
+template <>
+KOKKOS_INLINE_FUNCTION void recon5l<ReconstructionType::mp5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &lout) { lout = mp5_subcalc(x5, x4, x3, x2, x1); }
+template <ReconstructionType Recon>
+KOKKOS_INLINE_FUNCTION void recon5r(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &rout)
+{
+    Real lout;
+    recon5<Recon>(x1, x2, x3, x4, x5, lout, rout);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void recon5r<ReconstructionType::weno5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &rout) { weno5r(x1, x2, x3, x4, x5, rout); }
+template <>
+KOKKOS_INLINE_FUNCTION void recon5r<ReconstructionType::mp5>(const Real& x1, const Real& x2, const Real& x3, const Real& x4, const Real& x5,
+                                    Real &rout) { rout = mp5_subcalc(x1, x2, x3, x4, x5); }
+
 // Row-wise implementations
 // Note that "L" and "R" refer to the sides of the *face*
 // ql(1) is to the right of the first zone center, but corresponds to the face value reconstructed from the left
 // qr(1) is then the value at that face reconstructed from the right
 // This is *opposite* the single-zone convention (or rather, offset from it to the faces), so weirdly WENO5X2l calls weno5r.  Get it?
-template <typename T>
-KOKKOS_INLINE_FUNCTION void WENO5X1(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+
+// The 5-zone schemes (WENO5, PPM, MP5) are the most expensive reconstructions, so on CPUs we batch them explicitly:
+// each inner iteration loads the stencils for KHARMA_SIMD_WIDTH consecutive zones in i into RealVecs
+// (contiguous in memory, whatever the reconstruction direction), and WENO5 then runs its arithmetic
+// on whole vectors.  PPM and MP5 have limiters with branches, so they work through a batch lane by lane.
+// On GPUs each thread already handles one zone, so the batch is a single zone & this reduces to the old loop.
+
+/**
+ * Reconstruct one batch of zones with Recon, given their 5-zone stencils x.
+ * Fills lout/rout, the values at the left/right sides of each zone, as the single-zone functions above.
+ * Only rout is filled if !do_qr, and only lout if !do_ql, see Stencil5Row
+ */
+template <ReconstructionType Recon, bool do_ql, bool do_qr>
+struct Recon5Batch {
+    template <int W>
+    KOKKOS_INLINE_FUNCTION static void apply(const RealVec<W> x[5], RealVec<W>& lout, RealVec<W>& rout)
+    {
+        for (int l = 0; l < W; ++l) {
+            Real lo = 0., ro = 0.;
+            if (do_ql && do_qr) {
+                recon5<Recon>(x[0][l], x[1][l], x[2][l], x[3][l], x[4][l], lo, ro);
+            } else if (do_ql) {
+                recon5r<Recon>(x[0][l], x[1][l], x[2][l], x[3][l], x[4][l], ro);
+            } else {
+                recon5l<Recon>(x[0][l], x[1][l], x[2][l], x[3][l], x[4][l], lo);
+            }
+            lout.set(l, lo);
+            rout.set(l, ro);
+        }
+    }
+};
+template <bool do_ql, bool do_qr>
+struct Recon5Batch<ReconstructionType::weno5, do_ql, do_qr> {
+    template <int W>
+    KOKKOS_INLINE_FUNCTION static void apply(const RealVec<W> x[5], RealVec<W>& lout, RealVec<W>& rout)
+    {
+        if (do_ql && do_qr) {
+            weno5(x[0], x[1], x[2], x[3], x[4], lout, rout);
+        } else if (do_ql) {
+            weno5r(x[0], x[1], x[2], x[3], x[4], rout);
+        } else {
+            weno5l(x[0], x[1], x[2], x[3], x[4], lout);
+        }
+    }
+};
+
+/**
+ * Batched 5-zone reconstruction Recon over one row in direction dir, filling ql (if do_ql) and/or qr (if do_qr).
+ * X1 stores ql offset by one zone, matching the other X1 row reconstructions.
+ * The last batch in a row is padded by repeating zone iu, so every batch is full-width.
+ */
+template <ReconstructionType Recon, int dir, bool do_ql, bool do_qr, typename T>
+KOKKOS_INLINE_FUNCTION void Stencil5Row(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
+    constexpr int W = KHARMA_SIMD_WIDTH;
+    constexpr int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    constexpr int ql_off = (dir == X1DIR);
     const int nu = q.GetDim(4) - 1;
+    const int nbatch = (iu - il + W) / W;
     for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real lout, rout;
-                weno5(q(p, k, j, i - 2),
-                    q(p, k, j, i - 1),
-                    q(p, k, j, i),
-                    q(p, k, j, i + 1),
-                    q(p, k, j, i + 2), lout, rout);
-                ql(p, i+1) = rout;
-                qr(p, i) = lout;
+        parthenon::par_for_inner(member, 0, nbatch - 1,
+            KOKKOS_LAMBDA (const int& b) {
+                const int i0 = il + b*W;
+                const int nl = min(W, iu - i0 + 1);
+                RealVec<W> x[5];
+                for (int s = 0; s < 5; ++s) {
+                    if (nl == W) {
+                        x[s] = RealVec<W>::load(&q(p, k + (s - 2)*dk, j + (s - 2)*dj, i0 + (s - 2)*di));
+                    } else {
+                        for (int l = 0; l < W; ++l)
+                            x[s].set(l, q(p, k + (s - 2)*dk, j + (s - 2)*dj, min(i0 + l, iu) + (s - 2)*di));
+                    }
+                }
+                RealVec<W> lout, rout;
+                Recon5Batch<Recon, do_ql, do_qr>::apply(x, lout, rout);
+                for (int l = 0; l < nl; ++l) {
+                    if (do_ql) ql(p, i0 + l + ql_off) = rout[l];
+                    if (do_qr) qr(p, i0 + l) = lout[l];
+                }
             }
         );
     }
 }
+
+template <typename T>
+KOKKOS_INLINE_FUNCTION void WENO5X1(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
+{
+    Stencil5Row<ReconstructionType::weno5, X1DIR, true, true>(member, k, j, il, iu, q, ql, qr);
+}
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X2(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
-    const int nu = q.GetDim(4) - 1;
-    for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real lout, rout;
-                weno5(q(p, k, j - 2, i),
-                    q(p, k, j - 1, i),
-                    q(p, k, j, i),
-                    q(p, k, j + 1, i),
-                    q(p, k, j + 2, i), lout, rout);
-                ql(p, i) = rout;
-                qr(p, i) = lout;
-            }
-        );
-    }
+    Stencil5Row<ReconstructionType::weno5, X2DIR, true, true>(member, k, j, il, iu, q, ql, qr);
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X2l(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql)
 {
-    const int nu = q.GetDim(4) - 1;
-    for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real rout;
-                weno5r(q(p, k, j - 2, i),
-                    q(p, k, j - 1, i),
-                    q(p, k, j, i),
-                    q(p, k, j + 1, i),
-                    q(p, k, j + 2, i), rout);
-                ql(p, i) = rout;
-            }
-        );
-    }
+    Stencil5Row<ReconstructionType::weno5, X2DIR, true, false>(member, k, j, il, iu, q, ql, ql);
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X2r(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &qr)
 {
-    const int nu = q.GetDim(4) - 1;
-    for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real lout;
-                weno5l(q(p, k, j - 2, i),
-                    q(p, k, j - 1, i),
-                    q(p, k, j, i),
-                    q(p, k, j + 1, i),
-                    q(p, k, j + 2, i), lout);
-                qr(p, i) = lout;
-            }
-        );
-    }
+    Stencil5Row<ReconstructionType::weno5, X2DIR, false, true>(member, k, j, il, iu, q, qr, qr);
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X3(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql,
-                       ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql,
+                       ScratchPad2D<FluxReal> &qr)
 {
-    const int nu = q.GetDim(4) - 1;
-    for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real lout, rout;
-                weno5(q(p, k - 2, j, i),
-                    q(p, k - 1, j, i),
-                    q(p, k, j, i),
-                    q(p, k + 1, j, i),
-                    q(p, k + 2, j, i), lout, rout);
-                ql(p, i) = rout;
-                qr(p, i) = lout;
-            }
-        );
-    }
+    Stencil5Row<ReconstructionType::weno5, X3DIR, true, true>(member, k, j, il, iu, q, ql, qr);
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X3l(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &ql)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &ql)
 {
-    const int nu = q.GetDim(4) - 1;
-    for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real rout;
-                weno5r(q(p, k - 2, j, i),
-                    q(p, k - 1, j, i),
-                    q(p, k, j, i),
-                    q(p, k + 1, j, i),
-                    q(p, k + 2, j, i), rout);
-                ql(p, i) = rout;
-            }
-        );
-    }
+    Stencil5Row<ReconstructionType::weno5, X3DIR, true, false>(member, k, j, il, iu, q, ql, ql);
 }
 template <typename T>
 KOKKOS_INLINE_FUNCTION void WENO5X3r(parthenon::team_mbr_t const &member, const int& k, const int& j,
-                       const int& il, const int& iu, const T &q, ScratchPad2D<Real> &qr)
+                       const int& il, const int& iu, const T &q, ScratchPad2D<FluxReal> &qr)
 {
-    const int nu = q.GetDim(4) - 1;
+    Stencil5Row<ReconstructionType::weno5, X3DIR, false, true>(member, k, j, il, iu, q, qr, qr);
+}
+
+// Single-face implementations
+// These reconstruct one variable at the single face between zones i-1 and i (or j-1/j, k-1/k) directly
+// from the zone-centered values, rather than filling a whole row of scratch memory.
+// They're used by the recon_bench problem, and for linear_vl with FLUX_SINGLE_PRECISION (see below).
+// x(-3)...x(2) are the six zone centers surrounding the face, of which each scheme uses its own stencil.
+// Results match the row-wise versions above (linear_vl assumes uniform zones, as KHARMA's native coordinates are)
+template <ReconstructionType Recon>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr) {}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::donor_cell>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    ql = xm1;
+    qr = x0;
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::linear_mc>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    ql = xm1 + 0.5*mc(xm1 - xm2, x0 - xm1)*(x0 - xm1);
+    qr = x0 - 0.5*mc(x0 - xm1, xp1 - x0)*(xp1 - x0);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::linear_vl>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    // Van Leer limited slopes for the zones on either side
+    const Real dq2l = (xm1 - xm2)*(x0 - xm1);
+    const Real dql = (dq2l > 0.) ? 2*dq2l / (x0 - xm2) : 0.;
+    const Real dq2r = (x0 - xm1)*(xp1 - x0);
+    const Real dqr = (dq2r > 0.) ? 2*dq2r / (xp1 - xm1) : 0.;
+    ql = xm1 + 0.5*dql;
+    qr = x0 - 0.5*dqr;
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::weno5>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    // Right side of zone i-1, left side of zone i.  See above re: naming
+    weno5r(xm3, xm2, xm1, x0, xp1, ql);
+    weno5l(xm2, xm1, x0, xp1, xp2, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::ppm>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    recon5r<ReconstructionType::ppm>(xm3, xm2, xm1, x0, xp1, ql);
+    recon5l<ReconstructionType::ppm>(xm2, xm1, x0, xp1, xp2, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct_at_face<ReconstructionType::mp5>(const Real& xm3, const Real& xm2, const Real& xm1,
+                                                const Real& x0, const Real& xp1, const Real& xp2,
+                                                Real& ql, Real& qr)
+{
+    recon5r<ReconstructionType::mp5>(xm3, xm2, xm1, x0, xp1, ql);
+    recon5l<ReconstructionType::mp5>(xm2, xm1, x0, xp1, xp2, qr);
+}
+
+/**
+ * Reconstruct variable p at the left face in direction dir of zone (k, j, i).
+ * Loads only the stencil_reach(Recon) zones either side of the face which the scheme uses,
+ * e.g. two for donor_cell, rather than all six
+ */
+template <ReconstructionType Recon, int dir>
+KOKKOS_INLINE_FUNCTION void reconstruct_face(const VariablePack<Real> &P, const int& p,
+                                             const int& k, const int& j, const int& i,
+                                             FluxReal& ql, FluxReal& qr)
+{
+    constexpr int di = (dir == X1DIR), dj = (dir == X2DIR), dk = (dir == X3DIR);
+    constexpr int reach = stencil_reach(Recon);
+    // Unused points are never read, the conditions being known at compile time
+    const Real xm3 = (reach > 2) ? P(p, k - 3*dk, j - 3*dj, i - 3*di) : 0.;
+    const Real xm2 = (reach > 1) ? P(p, k - 2*dk, j - 2*dj, i - 2*di) : 0.;
+    const Real xm1 = P(p, k - dk, j - dj, i - di);
+    const Real x0 = P(p, k, j, i);
+    const Real xp1 = (reach > 1) ? P(p, k + dk, j + dj, i + di) : 0.;
+    const Real xp2 = (reach > 2) ? P(p, k + 2*dk, j + 2*dj, i + 2*di) : 0.;
+    Real l, r;
+    reconstruct_at_face<Recon>(xm3, xm2, xm1, x0, xp1, xp2, l, r);
+    ql = l;
+    qr = r;
+}
+
+/**
+ * Reconstruct all variables at the faces is_l through ie_l of a row, one face at a time with reconstruct_face.
+ * Fills ql(p, i), qr(p, i) at the left face of zone i in direction dir, which is the convention
+ * of the row-wise versions above in every direction
+ */
+template <ReconstructionType Recon, int dir>
+KOKKOS_INLINE_FUNCTION void FaceRow(parthenon::team_mbr_t const &member, const int& k, const int& j,
+                                    const int& is_l, const int& ie_l, const VariablePack<Real> &P,
+                                    ScratchPad2D<FluxReal> &ql, ScratchPad2D<FluxReal> &qr)
+{
+    const int nu = P.GetDim(4) - 1;
     for (int p = 0; p <= nu; ++p) {
-        parthenon::par_for_inner(member, il, iu,
-            KOKKOS_LAMBDA_1D {
-                Real lout;
-                weno5l(q(p, k - 2, j, i),
-                    q(p, k - 1, j, i),
-                    q(p, k, j, i),
-                    q(p, k + 1, j, i),
-                    q(p, k + 2, j, i), lout);
-                qr(p, i) = lout;
+        parthenon::par_for_inner(member, is_l, ie_l,
+            KOKKOS_LAMBDA (const int& i) {
+                reconstruct_face<Recon, dir>(P, p, k, j, i, ql(p, i), qr(p, i));
             }
         );
     }
@@ -355,42 +666,43 @@ KOKKOS_INLINE_FUNCTION void WENO5X3r(parthenon::team_mbr_t const &member, const
 template <ReconstructionType Recon, int dir>
 KOKKOS_INLINE_FUNCTION void reconstruct(parthenon::team_mbr_t& member, const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr) {}
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr) {}
 // DONOR CELL
 template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::donor_cell, X1DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
-    DonorCellX1(member, k, j, is_l, ie_l, P, ql, qr);
+    KReconstruction::DonorCellRow<X1DIR>(member, k, j, is_l, ie_l, P, ql, qr);
 }
 template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::donor_cell, X2DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
-    DonorCellX2(member, k, j - 1, is_l, ie_l, P, ql, q_u);
-    DonorCellX2(member, k, j, is_l, ie_l, P, q_u, qr);
+    KReconstruction::DonorCellRow<X2DIR>(member, k, j - 1, is_l, ie_l, P, ql, ql);
+    KReconstruction::DonorCellRow<X2DIR>(member, k, j, is_l, ie_l, P, qr, qr);
 }
 template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::donor_cell, X3DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
-    DonorCellX3(member, k - 1, j, is_l, ie_l, P, ql, q_u);
-    DonorCellX3(member, k, j, is_l, ie_l, P, q_u, qr);
+    KReconstruction::DonorCellRow<X3DIR>(member, k - 1, j, is_l, ie_l, P, ql, ql);
+    KReconstruction::DonorCellRow<X3DIR>(member, k, j, is_l, ie_l, P, qr, qr);
 }
 // LINEAR W/VAN LEER
+// Parthenon's implementation only fills Real scratch, so with FLUX_SINGLE_PRECISION we reconstruct each face
+// with reconstruct_face instead
+#if !FLUX_SINGLE_PRECISION
 template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X1DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     // Extra scratch space for Parthenon's VL limiter stuff
     ScratchPad2D<Real>  qc(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
@@ -403,14 +715,14 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X2DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     // Extra scratch space for Parthenon's VL limiter stuff
     ScratchPad2D<Real>  qc(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dql(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dqr(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dqm(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
+    ScratchPad2D<FluxReal> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     PiecewiseLinearX2(member, k, j - 1, is_l, ie_l, G, P, ql, q_u, qc, dql, dqr, dqm);
     PiecewiseLinearX2(member, k, j, is_l, ie_l, G, P, q_u, qr, qc, dql, dqr, dqm);
 }
@@ -418,23 +730,50 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X3DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     // Extra scratch space for Parthenon's VL limiter stuff
     ScratchPad2D<Real>  qc(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dql(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dqr(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     ScratchPad2D<Real> dqm(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
+    ScratchPad2D<FluxReal> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     PiecewiseLinearX3(member, k - 1, j, is_l, ie_l, G, P, ql, q_u, qc, dql, dqr, dqm);
     PiecewiseLinearX3(member, k, j, is_l, ie_l, G, P, q_u, qr, qc, dql, dqr, dqm);
 }
+#else
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X1DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    // X1 rows are passed a range starting one zone early, see Flux::calc_flux_row.  We need only faces is_l+1 to ie_l
+    FaceRow<ReconstructionType::linear_vl, X1DIR>(member, k, j, is_l + 1, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X2DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    FaceRow<ReconstructionType::linear_vl, X2DIR>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_vl, X3DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    FaceRow<ReconstructionType::linear_vl, X3DIR>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+#endif
 // LINEAR WITH MC
 template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_mc, X1DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     KReconstruction::PiecewiseLinearX1(member, k, j, is_l, ie_l, P, ql, qr);
 }
@@ -442,9 +781,9 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_mc, X2DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
+    ScratchPad2D<FluxReal> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     KReconstruction::PiecewiseLinearX2(member, k, j - 1, is_l, ie_l, P, ql, q_u);
     KReconstruction::PiecewiseLinearX2(member, k, j, is_l, ie_l, P, q_u, qr);
 }
@@ -452,9 +791,9 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::linear_mc, X3DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
-    ScratchPad2D<Real> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
+    ScratchPad2D<FluxReal> q_u(member.team_scratch(1), P.GetDim(4), P.GetDim(1));
     KReconstruction::PiecewiseLinearX3(member, k - 1, j, is_l, ie_l, P, ql, q_u);
     KReconstruction::PiecewiseLinearX3(member, k, j, is_l, ie_l, P, q_u, qr);
 }
@@ -463,7 +802,7 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::weno5, X1DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     KReconstruction::WENO5X1(member, k, j, is_l, ie_l, P, ql, qr);
 }
@@ -471,7 +810,7 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::weno5, X2DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     KReconstruction::WENO5X2l(member, k, j - 1, is_l, ie_l, P, ql);
     KReconstruction::WENO5X2r(member, k, j, is_l, ie_l, P, qr);
@@ -480,10 +819,64 @@ template <>
 KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::weno5, X3DIR>(parthenon::team_mbr_t& member,
                                         const GRCoordinates& G, const VariablePack<Real> &P,
                                         const int& k, const int& j, const int& is_l, const int& ie_l, 
-                                        ScratchPad2D<Real> ql, ScratchPad2D<Real> qr)
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
 {
     KReconstruction::WENO5X3l(member, k - 1, j, is_l, ie_l, P, ql);
     KReconstruction::WENO5X3r(member, k, j, is_l, ie_l, P, qr);
 }
 
+// PPM
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::ppm, X1DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::ppm, X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::ppm, X2DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::ppm, X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, ql);
+    KReconstruction::Stencil5Row<ReconstructionType::ppm, X2DIR, false, true>(member, k, j, is_l, ie_l, P, qr, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::ppm, X3DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::ppm, X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, ql);
+    KReconstruction::Stencil5Row<ReconstructionType::ppm, X3DIR, false, true>(member, k, j, is_l, ie_l, P, qr, qr);
+}
+// MP5
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::mp5, X1DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::mp5, X1DIR, true, true>(member, k, j, is_l, ie_l, P, ql, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::mp5, X2DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::mp5, X2DIR, true, false>(member, k, j - 1, is_l, ie_l, P, ql, ql);
+    KReconstruction::Stencil5Row<ReconstructionType::mp5, X2DIR, false, true>(member, k, j, is_l, ie_l, P, qr, qr);
+}
+template <>
+KOKKOS_INLINE_FUNCTION void reconstruct<ReconstructionType::mp5, X3DIR>(parthenon::team_mbr_t& member,
+                                        const GRCoordinates& G, const VariablePack<Real> &P,
+                                        const int& k, const int& j, const int& is_l, const int& ie_l, 
+                                        ScratchPad2D<FluxReal> ql, ScratchPad2D<FluxReal> qr)
+{
+    KReconstruction::Stencil5Row<ReconstructionType::mp5, X3DIR, true, false>(member, k - 1, j, is_l, ie_l, P, ql, ql);
+    KReconstruction::Stencil5Row<ReconstructionType::mp5, X3DIR, false, true>(member, k, j, is_l, ie_l, P, qr, qr);
+}
 } // namespace KReconstruction
@@ -0,0 +1,126 @@
+/* 
+ *  File: simd.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2022, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include <cstring>
+
+// Width in Reals of the vectors used to batch consecutive zones in i on CPUs, see RealVec.
+// Picked from the target's vector registers (for Real == double), unless set with the CMake option SIMD_WIDTH.
+// GPUs handle one zone per thread, so a batch is a single zone there.
+#ifndef KHARMA_SIMD_WIDTH
+#  if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) || defined(KOKKOS_ENABLE_SYCL)
+#    define KHARMA_SIMD_WIDTH 1
+#  elif !(defined(__GNUC__) || defined(__clang__))
+#    define KHARMA_SIMD_WIDTH 1
+#  elif defined(__AVX512F__)
+#    define KHARMA_SIMD_WIDTH 8
+#  elif defined(__AVX__)
+#    define KHARMA_SIMD_WIDTH 4
+#  elif defined(__SSE2__) || defined(__ARM_NEON) || defined(__VSX__)
+#    define KHARMA_SIMD_WIDTH 2
+#  else
+#    define KHARMA_SIMD_WIDTH 1
+#  endif
+#endif
+
+/**
+ * A short vector of W Reals, one per zone of a batch, with elementwise arithmetic.
+ *
+ * Code written against RealVec, like the WENO5 weights in reconstruction.hpp, compiles to vector
+ * instructions of width W whatever the compiler's loop vectorizer decides: for W > 1 it's stored
+ * as a GCC/Clang vector extension type.  RealVec<1> is a plain Real, so the same code runs
+ * one zone per thread on GPUs.
+ * Only arithmetic is provided: anything with branches (limiters, root finds) works lane by lane.
+ */
+template <int W>
+struct RealVec;
+
+template <>
+struct RealVec<1> {
+    Real v;
+    RealVec() = default;
+    KOKKOS_INLINE_FUNCTION RealVec(const Real& x) : v(x) {}
+    KOKKOS_INLINE_FUNCTION static RealVec load(const Real* p) { return RealVec(*p); }
+    KOKKOS_INLINE_FUNCTION Real operator[](const int& l) const { return v; }
+    KOKKOS_INLINE_FUNCTION void set(const int& l, const Real& x) { v = x; }
+
+    KOKKOS_INLINE_FUNCTION RealVec& operator+=(const RealVec& b) { v += b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator-=(const RealVec& b) { v -= b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator*=(const RealVec& b) { v *= b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator/=(const RealVec& b) { v /= b.v; return *this; }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator+(const RealVec& a, const RealVec& b) { return RealVec(a.v + b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator-(const RealVec& a, const RealVec& b) { return RealVec(a.v - b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator*(const RealVec& a, const RealVec& b) { return RealVec(a.v * b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator/(const RealVec& a, const RealVec& b) { return RealVec(a.v / b.v); }
+};
+
+#if KHARMA_SIMD_WIDTH > 1
+#if !(defined(__GNUC__) || defined(__clang__))
+#error "KHARMA_SIMD_WIDTH > 1 needs GCC/Clang vector extensions"
+#endif
+// The vector extension attribute ignores template-dependent sizes, so each width is spelled out
+template <int W>
+struct NativeVec {};
+template <>
+struct NativeVec<2> { typedef Real type __attribute__((vector_size(2 * sizeof(Real)))); };
+template <>
+struct NativeVec<4> { typedef Real type __attribute__((vector_size(4 * sizeof(Real)))); };
+template <>
+struct NativeVec<8> { typedef Real type __attribute__((vector_size(8 * sizeof(Real)))); };
+
+template <int W>
+struct RealVec {
+    typedef typename NativeVec<W>::type vtype;
+    vtype v;
+    RealVec() = default;
+    // Broadcast, so that scalar constants mix with vectors as they would with Reals
+    KOKKOS_INLINE_FUNCTION RealVec(const Real& x) : v(vtype{} + x) {}
+    KOKKOS_INLINE_FUNCTION static RealVec from(const vtype& x) { RealVec r; r.v = x; return r; }
+    // Load W consecutive Reals, e.g. a batch of zones along a row of a View
+    KOKKOS_INLINE_FUNCTION static RealVec load(const Real* p) { RealVec r; std::memcpy(&r.v, p, sizeof(vtype)); return r; }
+    KOKKOS_INLINE_FUNCTION Real operator[](const int& l) const { return v[l]; }
+    KOKKOS_INLINE_FUNCTION void set(const int& l, const Real& x) { v[l] = x; }
+
+    KOKKOS_INLINE_FUNCTION RealVec& operator+=(const RealVec& b) { v += b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator-=(const RealVec& b) { v -= b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator*=(const RealVec& b) { v *= b.v; return *this; }
+    KOKKOS_INLINE_FUNCTION RealVec& operator/=(const RealVec& b) { v /= b.v; return *this; }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator+(const RealVec& a, const RealVec& b) { return from(a.v + b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator-(const RealVec& a, const RealVec& b) { return from(a.v - b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator*(const RealVec& a, const RealVec& b) { return from(a.v * b.v); }
+    friend KOKKOS_INLINE_FUNCTION RealVec operator/(const RealVec& a, const RealVec& b) { return from(a.v / b.v); }
+};
+#endif
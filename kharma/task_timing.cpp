@@ -0,0 +1,169 @@
+/* 
+ *  File: task_timing.cpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "task_timing.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+namespace TaskTiming {
+
+bool enabled = false;
+bool fence = true;
+
+namespace {
+// Per-rank totals since the last report, by task name.  Report() adds any names seen only on
+// other ranks, then std::map keeps them sorted, so that every rank packs the same list in the same order
+struct Timer {
+    double seconds = 0.;
+    int calls = 0;
+};
+std::map<std::string, Timer> timers;
+// Guards timers, as Parthenon may run the tasks of different regions on separate threads
+std::mutex timers_mutex;
+
+int interval = 100;
+std::string format = "json";
+std::string fname = "task_timing.json";
+// Cycle number of the last step included in the previous report, set on the first step
+int last_report = -1;
+bool started = false;
+} // namespace
+
+void Initialize(ParameterInput *pin)
+{
+    enabled = pin->GetOrAddBoolean("perf", "task_timing", false);
+    fence = pin->GetOrAddBoolean("perf", "task_timing_fence", true);
+    interval = pin->GetOrAddInteger("perf", "task_timing_interval", 100);
+    format = pin->GetOrAddString("perf", "task_timing_format", "json");
+    if (format != "json" && format != "csv") {
+        throw std::invalid_argument("Task timing format "+format+" not supported!");
+    }
+    if (interval < 1) {
+        throw std::invalid_argument("perf/task_timing_interval must be at least 1!");
+    }
+    fname = "task_timing." + format;
+    timers.clear();
+    started = false;
+
+    // Start a fresh file, with a header if it needs one
+    if (enabled && MPIRank0()) {
+        std::ofstream out(fname, std::ios::trunc);
+        if (format == "csv") out << "ncycle,time,nsteps,task,calls,min,max,mean" << std::endl;
+    }
+}
+
+void Record(const std::string& name, double seconds, bool complete)
+{
+    // Tasks which return "incomplete" (e.g. waiting on MPI) are called again later.
+    // We count all the time spent in them, but only count a "call" when they finish
+    std::lock_guard<std::mutex> lock(timers_mutex);
+    auto& timer = timers[name];
+    timer.seconds += seconds;
+    if (complete) timer.calls++;
+}
+
+void Report(const SimTime& tm)
+{
+    if (!enabled) return;
+    // Count from the first step we see, which may follow a restart
+    if (!started) {
+        last_report = tm.ncycle - 1;
+        started = true;
+    }
+    if ((tm.ncycle - last_report) < interval) return;
+    const int nsteps = tm.ncycle - last_report;
+    last_report = tm.ncycle;
+    // Tasks are done for the step, but don't rely on it
+    std::lock_guard<std::mutex> lock(timers_mutex);
+
+    // Ranks needn't run the same tasks (e.g. boundary tasks, or blocks idle under local timestepping),
+    // so first agree on the union of all task names, adding zero timers for any not run here.
+    // Task names don't contain newlines, so they're gathered as one newline-separated string
+    std::string names;
+    for (auto& timer : timers) names += timer.first + "\n";
+    const std::string all_names = MPIAllgatherString(names);
+    size_t start = 0, end;
+    while ((end = all_names.find('\n', start)) != std::string::npos) {
+        timers[all_names.substr(start, end - start)];
+        start = end + 1;
+    }
+
+    // Pack per-rank totals & reduce them all at once.  Calls are reported as the most made by any rank
+    const int ntasks = timers.size();
+    std::vector<double> local(ntasks), tmin(ntasks), tmax(ntasks), tsum(ntasks), lcalls(ntasks), calls(ntasks);
+    int n = 0;
+    for (auto& timer : timers) {
+        local[n] = timer.second.seconds;
+        lcalls[n] = timer.second.calls;
+        n++;
+    }
+    MPIMinVector(local.data(), tmin.data(), ntasks);
+    MPIMaxVector(local.data(), tmax.data(), ntasks);
+    MPIReduceVector(local.data(), tsum.data(), ntasks);
+    MPIMaxVector(lcalls.data(), calls.data(), ntasks);
+
+    if (MPIRank0()) {
+        const int nranks = parthenon::Globals::nranks;
+        std::ofstream out(fname, std::ios::app);
+        out << std::setprecision(6);
+        if (format == "json") {
+            // One JSON object per line, per interval
+            out << "{\"ncycle\": " << tm.ncycle << ", \"time\": " << tm.time << ", \"nsteps\": " << nsteps
+                << ", \"tasks\": {";
+            n = 0;
+            for (auto& timer : timers) {
+                out << (n > 0 ? ", " : "") << "\"" << timer.first << "\": {\"calls\": " << (int) calls[n]
+                    << ", \"min\": " << tmin[n] << ", \"max\": " << tmax[n] << ", \"mean\": " << tsum[n] / nranks << "}";
+                n++;
+            }
+            out << "}}" << std::endl;
+        } else {
+            // Task names can include commas (template arguments), so we quote them
+            n = 0;
+            for (auto& timer : timers) {
+                out << tm.ncycle << "," << tm.time << "," << nsteps << ",\"" << timer.first << "\","
+                    << (int) calls[n] << "," << tmin[n] << "," << tmax[n] << "," << tsum[n] / nranks << std::endl;
+                n++;
+            }
+        }
+    }
+
+    // Reset for the next interval, keeping the names so the set of timers stays consistent between ranks
+    for (auto& timer : timers) timer.second = Timer();
+}
+
+} // namespace TaskTiming
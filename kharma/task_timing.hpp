@@ -0,0 +1,134 @@
+/* 
+ *  File: task_timing.hpp
+ *  
+ *  BSD 3-Clause License
+ *  
+ *  Copyright (c) 2020, AFD Group at UIUC
+ *  All rights reserved.
+ *  
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are met:
+ *  
+ *  1. Redistributions of source code must retain the above copyright notice, this
+ *     list of conditions and the following disclaimer.
+ *  
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  
+ *  3. Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *  
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *  FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *  SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "decs.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+
+/**
+ * Wall-clock timing of the tasks making up each step.
+ *
+ * Driver tasks are wrapped with the TIMED() macro when they're added, e.g.
+ *     tl.AddTask(t_none, TIMED(GRMHD::FixUtoPMeshTask), mc1.get());
+ * This records the total time spent in each task (by name) on each rank.  Tasks sharing a function,
+ * e.g. the flux kernels for each region and reconstruction, are given separate names with TIMED_AS().  Every
+ * perf/task_timing_interval steps the totals are reduced across ranks, and the
+ * min/max/mean per-rank times are written by rank 0 to task_timing.json or task_timing.csv.
+ *
+ * Enabled at runtime with perf/task_timing=true.  When disabled, the wrapper costs one branch per task call.
+ * Note timings of kernel-launching tasks are only meaningful with perf/task_timing_fence=true (the default),
+ * which waits for each task's kernels to finish before stopping its timer.
+ */
+namespace TaskTiming {
+
+// Options, set once by Initialize
+extern bool enabled;
+extern bool fence;
+
+/**
+ * Read the options in the "perf" block, and reset any existing timers
+ */
+void Initialize(ParameterInput *pin);
+
+/**
+ * Add the time taken by one call of a task to its total.
+ * Safe to call from tasks running on several threads at once
+ */
+void Record(const std::string& name, double seconds, bool complete);
+
+/**
+ * Called at the end of every step: if this step ends an interval, reduce the
+ * timers across ranks, write them out, and reset them.
+ * Must be called on all ranks.  Tasks which ran only on some ranks are reported with zero time on the rest
+ */
+void Report(const SimTime& tm);
+
+// Call either a function/functor, or a member function with the object pointer as its first argument
+template<typename F, typename... Args>
+auto Invoke(const F& func, Args&&... args) -> decltype(func(std::forward<Args>(args)...))
+{
+    return func(std::forward<Args>(args)...);
+}
+template<typename R, typename C, typename... FArgs, typename T, typename... Args>
+R Invoke(R (C::*func)(FArgs...), T *obj, Args&&... args)
+{
+    return (obj->*func)(std::forward<Args>(args)...);
+}
+template<typename R, typename C, typename... FArgs, typename T, typename... Args>
+R Invoke(R (C::*func)(FArgs...) const, T *obj, Args&&... args)
+{
+    return (obj->*func)(std::forward<Args>(args)...);
+}
+
+/**
+ * Functor wrapping a task function, which times each call.
+ * Parthenon's TaskList::AddTask accepts these in place of the function.
+ */
+template<typename F>
+class TimedTask {
+    public:
+        TimedTask(const std::string& name, F func) : name_((name.size() > 0 && name[0] == '&') ? name.substr(1) : name), func_(func) {}
+
+        template<typename... Args>
+        TaskStatus operator()(Args&&... args) const
+        {
+            if (!enabled) return Invoke(func_, std::forward<Args>(args)...);
+
+            Kokkos::Timer timer;
+            TaskStatus status = Invoke(func_, std::forward<Args>(args)...);
+            if (fence) Kokkos::fence();
+            Record(name_, timer.seconds(), status == TaskStatus::complete);
+            return status;
+        }
+
+    private:
+        std::string name_;
+        F func_;
+};
+
+template<typename F>
+TimedTask<typename std::decay<F>::type> Timed(const std::string& name, F&& func)
+{
+    return TimedTask<typename std::decay<F>::type>(name, std::forward<F>(func));
+}
+
+} // namespace TaskTiming
+
+// Wrap a task function for timing, using its name as written as the name of the timer
+#define TIMED(...) TaskTiming::Timed(#__VA_ARGS__, __VA_ARGS__)
+// Wrap a task function for timing under an explicit name, for functions added as several different tasks
+#define TIMED_AS(name, ...) TaskTiming::Timed(name, __VA_ARGS__)
@@ -54,6 +54,10 @@ enum ReconstructionType{donor_cell=0, linear_mc, linear_vl, ppm, mp5, weno5, wen
 // Only thrown from function in U_to_P.hpp, see that file for meanings
 enum InversionStatus{success=0, neg_input, max_iter, bad_ut, bad_gamma, neg_rho, neg_u, neg_rhou};
 
+// Denote primitive recovery algorithms
+// See U_to_P.hpp and U_to_P_solvers.hpp for implementations
+enum InversionType{onedw=0, twod, palenzuela, kastaun};
+
 // Struct for derived 4-vectors at a point, usually calculated and needed together
 typedef struct {
     parthenon::Real ucon[GR_DIM];
@@ -143,6 +147,63 @@ class VarMap {
         }
 };
 
+/**
+ * Compile-time record of which packages' variables are present, to template kernels on.
+ *
+ * Device functions which would usually check e.g. "m_p.B1 >= 0" can be templated on a
+ * package set and check "has_b<Pkgs>(m_p)" instead.  When the set is known at compile time
+ * this is a constant, and the compiler removes any branches for packages we aren't using.
+ * The set "runtime" falls back to checking the VarMap, for any combination not instantiated
+ * separately (see Flux::AddFluxCalculations).
+ */
+namespace PackageSet {
+    constexpr int runtime = -1;
+    constexpr int grhd = 0;
+    constexpr int b_field = 1 << 0; // Either B_FluxCT or B_CD
+    constexpr int b_cd = 1 << 1;
+    constexpr int emhd = 1 << 2;
+    constexpr int electrons = 1 << 3;
+}
+template<int Pkgs>
+KOKKOS_FORCEINLINE_FUNCTION bool has_b(const VarMap& m)
+{ return (Pkgs == PackageSet::runtime) ? (m.B1 >= 0) : (Pkgs & PackageSet::b_field); }
+template<int Pkgs>
+KOKKOS_FORCEINLINE_FUNCTION bool has_psi(const VarMap& m)
+{ return (Pkgs == PackageSet::runtime) ? (m.PSI >= 0) : (Pkgs & PackageSet::b_cd); }
+template<int Pkgs>
+KOKKOS_FORCEINLINE_FUNCTION bool has_emhd(const VarMap& m)
+{ return (Pkgs == PackageSet::runtime) ? (m.Q >= 0) : (Pkgs & PackageSet::emhd); }
+template<int Pkgs>
+KOKKOS_FORCEINLINE_FUNCTION bool has_electrons(const VarMap& m)
+{ return (Pkgs == PackageSet::runtime) ? (m.KTOT >= 0) : (Pkgs & PackageSet::electrons); }
+
+/**
+ * Pick the compile-time package set matching the packages actually loaded, see PackageSet above.
+ * Only the common production combinations get their own kernels (pure GRHD, and GRMHD with either
+ * B field transport, with or without electrons).  Anything else, e.g. EMHD, uses PackageSet::runtime.
+ */
+inline int SpecializedPackageSet(const Packages_t& packages)
+{
+#if SPECIALIZE_PACKAGES
+    const auto& pkgs = packages.AllPackages();
+    const bool use_b_flux_ct = pkgs.count("B_FluxCT");
+    const bool use_b_cd = pkgs.count("B_CD");
+    const bool use_electrons = pkgs.count("Electrons");
+    const bool use_emhd = pkgs.count("EMHD");
+
+    if (use_emhd) return PackageSet::runtime;
+    if (use_b_flux_ct) {
+        return PackageSet::b_field | (use_electrons ? PackageSet::electrons : 0);
+    } else if (use_b_cd) {
+        return (use_electrons) ? PackageSet::runtime : PackageSet::b_field | PackageSet::b_cd;
+    } else {
+        return (use_electrons) ? PackageSet::runtime : PackageSet::grhd;
+    }
+#else
+    return PackageSet::runtime;
+#endif
+}
+
 /**
  * Functions for checking boundaries in 3D
  */
@@ -173,7 +234,11 @@ inline bool IsDomainBound(MeshBlock *pmb, BoundaryFace face)
 #if TRACE
 #define PRINTCORNERS 0
 #define PRINTZONE 0
-inline void PrintCorner(MeshBlockData<Real> *rc)
+/**
+ * Print the corner of a block, with its inversion flags pflag (indexed by lid, see GRMHD::PFlags).
+ * pflag may be empty if the flags haven't been allocated yet
+ */
+inline void PrintCorner(MeshBlockData<Real> *rc, const ParArray4D<int8_t>& pflag_d)
 {
     auto rhop = rc->Get("prims.rho").data.GetHostMirrorAndCopy();
     auto up = rc->Get("prims.u").data.GetHostMirrorAndCopy();
@@ -184,17 +249,20 @@ inline void PrintCorner(MeshBlockData<Real> *rc)
     auto uvecc = rc->Get("cons.uvec").data.GetHostMirrorAndCopy();
     auto Bu = rc->Get("cons.B").data.GetHostMirrorAndCopy();
     //auto p = rc->Get("p").data.GetHostMirrorAndCopy();
-    auto pflag = rc->Get("pflag").data.GetHostMirrorAndCopy();
+    auto pflag = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), pflag_d);
+    const int lid = rc->GetBlockPointer()->lid;
     //auto q = rc->Get("prims.q").data.GetHostMirrorAndCopy();
     //auto dP = rc->Get("prims.dP").data.GetHostMirrorAndCopy();
     const IndexRange ib = rc->GetBoundsI(IndexDomain::interior);
     const IndexRange jb = rc->GetBoundsJ(IndexDomain::interior);
     const IndexRange kb = rc->GetBoundsK(IndexDomain::interior);
     cerr << "p:";
-    for (int j=0; j<8; j++) {
-        cerr << endl;
-        for (int i=0; i<8; i++) {
-            fprintf(stderr, "%.5g\t", pflag(kb.s, j, i));
+    if (pflag.extent_int(0) > lid) {
+        for (int j=0; j<8; j++) {
+            cerr << endl;
+            for (int i=0; i<8; i++) {
+                fprintf(stderr, "%d\t", pflag(lid, kb.s, j, i));
+            }
         }
     }
     // cerr << endl << "B1:";
@@ -227,13 +295,19 @@ inline void Flag(std::string label)
     if(MPIRank0()) std::cerr << label << std::endl;
 }
 
+// The flags live in the GRMHD package's params, which we read directly rather than including grmhd.hpp here
+inline ParArray4D<int8_t> TracePFlags(MeshBlockData<Real> *rc)
+{
+    return rc->GetBlockPointer()->packages.Get("GRMHD")->Param<ParArray4D<int8_t>>("pflags");
+}
+
 inline void Flag(MeshBlockData<Real> *rc, std::string label)
 {
 #pragma omp critical
 {
     if(MPIRank0()) {
         std::cerr << label << std::endl;
-        if(PRINTCORNERS) PrintCorner(rc);
+        if(PRINTCORNERS) PrintCorner(rc, TracePFlags(rc));
         if(PRINTZONE) PrintZone(rc);
     }
 }
@@ -247,7 +321,7 @@ inline void Flag(MeshData<Real> *md, std::string label)
         std::cerr << label << std::endl;
         if(PRINTCORNERS || PRINTZONE) {
             auto rc = md->GetBlockData(0).get();
-            if(PRINTCORNERS) PrintCorner(rc);
+            if(PRINTCORNERS) PrintCorner(rc, TracePFlags(rc));
             if(PRINTZONE) PrintZone(rc);
         }
     }
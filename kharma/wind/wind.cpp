@@ -56,6 +56,24 @@ std::shared_ptr<StateDescriptor> Wind::Initialize(ParameterInput *pin)
     return pkg;
 }
 
+Wind::WindParams Wind::GetParams(MeshBlock *pmb)
+{
+    const auto& pars = pmb->packages.Get("Wind")->AllParams();
+    const auto& globals = pmb->packages.Get("Globals")->AllParams();
+    const Real ramp_start = pars.Get<Real>("ramp_start");
+    const Real ramp_end = pars.Get<Real>("ramp_end");
+    const Real time = globals.Get<Real>("time");
+
+    WindParams wind;
+    wind.n = pars.Get<Real>("ne");
+    wind.Tp = pars.Get<Real>("Tp");
+    wind.u1 = pars.Get<Real>("u1");
+    wind.power = pars.Get<int>("power");
+    // Set the wind via linear ramp-up with time, if enabled
+    wind.current_n = (ramp_end > 0.0) ? min(max(time - ramp_start, 0.0) / (ramp_end - ramp_start), 1.0) * wind.n : wind.n;
+    return wind;
+}
+
 TaskStatus Wind::AddSource(MeshData<Real> *mdudt)
 {
     Flag(mdudt, "Adding wind");
@@ -63,17 +81,8 @@ TaskStatus Wind::AddSource(MeshData<Real> *mdudt)
     auto pmesh = mdudt->GetMeshPointer();
     auto pmb0 = mdudt->GetBlockData(0)->GetBlockPointer();
     // Options
-    const auto& gpars = pmb0->packages.Get("GRMHD")->AllParams();
-    const auto& pars = pmb0->packages.Get("Wind")->AllParams();
-    const auto& globals = pmb0->packages.Get("Globals")->AllParams();
-    const Real gam = gpars.Get<Real>("gamma");
-    const Real n = pars.Get<Real>("ne");
-    const Real Tp = pars.Get<Real>("Tp");
-    const Real u1 = pars.Get<Real>("u1");
-    const int power = pars.Get<int>("power");
-    const Real ramp_start = pars.Get<Real>("ramp_start");
-    const Real ramp_end = pars.Get<Real>("ramp_end");
-    const Real time = globals.Get<Real>("time");
+    const Real gam = pmb0->packages.Get("GRMHD")->Param<Real>("gamma");
+    const WindParams wind = GetParams(pmb0.get());
 
     // Pack variables
     PackIndexMap cons_map;
@@ -85,31 +94,11 @@ TaskStatus Wind::AddSource(MeshData<Real> *mdudt)
     const IndexRange kb = mdudt->GetBoundsK(IndexDomain::interior);
     const IndexRange block = IndexRange{0, dUdt.GetDim(5) - 1};
 
-    // Set the wind via linear ramp-up with time, if enabled
-    const Real current_n = (ramp_end > 0.0) ? min(max(time - ramp_start, 0.0) / (ramp_end - ramp_start), 1.0) * n : n;
-
     pmb0->par_for("add_wind", block.s, block.e, kb.s, kb.e, jb.s, jb.e, ib.s, ib.e,
         KOKKOS_LAMBDA_MESH_3D {
             const auto& G = dUdt.GetCoords(b);
-            // Need coordinates to evaluate particle addtn rate
-            // Note that makes the wind spherical-only, TODO ensure this
-            GReal Xembed[GR_DIM];
-            G.coord_embed(k, j, i, Loci::center, Xembed);
-            GReal r = Xembed[1], th = Xembed[2];
-
-            // Particle addition rate: concentrate at poles & center
-            // TODO poles only w/e.g. cos2?
-            Real drhopdt = current_n * pow(cos(th), power) / pow(1. + r * r, 2);
-
-            // Insert fluid moving in positive U1, without B field
-            // Ramp up like density, since we're not at a set proportion
-            const Real uvec[NVEC] = {current_n / n * u1, 0, 0};
-            const Real B_P[NVEC] = {0};
-
-            // Add plasma to the T^t_a component of the stress-energy tensor
-            // Notice that U already contains a factor of sqrt{-g}
             Real rho_ut, T[GR_DIM];
-            GRMHD::p_to_u_mhd(G, drhopdt, drhopdt * Tp * 3., uvec, B_P, gam, k, j, i, rho_ut, T);
+            Wind::calc_source(G, wind, gam, k, j, i, rho_ut, T);
 
             dUdt(b, m_u.RHO, k, j, i) += rho_ut;
             dUdt(b, m_u.UU, k, j, i) += T[0];
@@ -49,4 +49,44 @@ std::shared_ptr<StateDescriptor> Initialize(ParameterInput *pin);
  */
 TaskStatus AddSource(MeshData<Real> *mdudt);
 
+/**
+ * Wind parameters as needed on device.  current_n is the particle addition rate at the current time,
+ * which may be ramped up from 0 to n
+ */
+typedef struct {
+    Real n, current_n, Tp, u1;
+    int power;
+} WindParams;
+
+/**
+ * Get the wind parameters for the current time
+ */
+WindParams GetParams(MeshBlock *pmb);
+
+/**
+ * Calculate the wind source term in a single zone, for rho*u^t (drho) and T^t_mu (dT)
+ */
+KOKKOS_INLINE_FUNCTION void calc_source(const GRCoordinates& G, const WindParams& wind, const Real& gam,
+                                        const int& k, const int& j, const int& i, Real& drho, Real dT[GR_DIM])
+{
+    // Need coordinates to evaluate particle addtn rate
+    // Note that makes the wind spherical-only, TODO ensure this
+    GReal Xembed[GR_DIM];
+    G.coord_embed(k, j, i, Loci::center, Xembed);
+    GReal r = Xembed[1], th = Xembed[2];
+
+    // Particle addition rate: concentrate at poles & center
+    // TODO poles only w/e.g. cos2?
+    Real drhopdt = wind.current_n * pow(cos(th), wind.power) / pow(1. + r * r, 2);
+
+    // Insert fluid moving in positive U1, without B field
+    // Ramp up like density, since we're not at a set proportion
+    const Real uvec[NVEC] = {wind.current_n / wind.n * wind.u1, 0, 0};
+    const Real B_P[NVEC] = {0};
+
+    // Add plasma to the T^t_a component of the stress-energy tensor
+    // Notice that U already contains a factor of sqrt{-g}
+    GRMHD::p_to_u_mhd(G, drhopdt, drhopdt * wind.Tp * 3., uvec, B_P, gam, k, j, i, drho, dT);
+}
+
 }
@@ -16,6 +16,7 @@
 # trace: Configure with execution tracing: print at the beginning and end
 #        of most host-side function calls during a step
 # skx:   Compile specifically for Skylake nodes on Stampede2
+# single_flux: Reconstruct and compute face fluxes in single precision, see FLUX_SINGLE_PRECISION
 
 # Processors to use.  Leave blank for all.  Be a good citizen.
 NPROC=
@@ -81,6 +82,9 @@ fi
 if [[ "$ARGS" == *"trace"* ]]; then
   EXTRA_FLAGS="-DTRACE=1 $EXTRA_FLAGS"
 fi
+if [[ "$ARGS" == *"single_flux"* ]]; then
+  EXTRA_FLAGS="-DFLUX_SINGLE_PRECISION=ON $EXTRA_FLAGS"
+fi
 
 ### Enivoronment Prep ###
 if [[ "$(which python3 2>/dev/null)" == *"conda"* ]]; then
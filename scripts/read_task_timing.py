@@ -0,0 +1,34 @@
+#!/usr/bin/env python3
+
+# Summarize the per-task timings written by KHARMA with perf/task_timing=true
+# Usage: read_task_timing.py task_timing.json [...]
+
+import sys
+import json
+
+for fname in sys.argv[1:]:
+    # One JSON object per reporting interval
+    intervals = [json.loads(line) for line in open(fname, "r") if line.strip()]
+    if len(intervals) == 0:
+        continue
+
+    # Skip the first interval when we can, as it includes startup
+    if len(intervals) > 1:
+        intervals = intervals[1:]
+    nsteps = sum([x['nsteps'] for x in intervals])
+
+    totals = {}
+    for x in intervals:
+        for task, t in x['tasks'].items():
+            if task not in totals:
+                totals[task] = {'min': 0., 'max': 0., 'mean': 0.}
+            for stat in ('min', 'max', 'mean'):
+                totals[task][stat] += t[stat]
+
+    total_mean = sum([t['mean'] for t in totals.values()])
+    print("=== FILE: {} ===".format(fname))
+    print("{} steps, {:.4g}s per step in tasks (mean over ranks)".format(nsteps, total_mean / nsteps))
+    print("Tasks by mean time per step (min/max over ranks):")
+    for task, t in sorted(totals.items(), key=lambda x: x[1]['mean'], reverse=True):
+        print(" * {}: {:.4g}s ({:.4g}/{:.4g}), {:.1f}%".format(task, t['mean'] / nsteps, t['min'] / nsteps,
+                                                               t['max'] / nsteps, 100 * t['mean'] / total_mean))
@@ -0,0 +1,22 @@
+#!/usr/bin/env python3
+
+# Check that a torus run with local timestepping kept divB at machine precision, see run.sh
+# Usage: check.py name
+
+import sys
+import numpy as np
+
+import pyharm
+
+# Dumps are in double precision
+DIVB_MAX = 1.e-10
+
+test = pyharm.load_dump("lts_{}.phdf".format(sys.argv[1]))
+
+divb = np.max(np.fabs(test['divB']))
+print("{}: max divB {:.3g}".format(sys.argv[1], divb))
+if divb > DIVB_MAX:
+    print("divB is above machine precision!")
+    exit(1)
+
+exit(0)
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+# Check local timestepping against global stepping, see run.sh
+
+. ~/libs/anaconda3/etc/profile.d/conda.sh
+conda activate pyharm
+
+fail=0
+# The local runs must actually have used more than one level, or they test nothing
+for run in lts_local lts_local_tight blast_local blast_local_tight
+do
+    if ! grep -q "Local timestep levels by shell:.* [1-9]" log_${run}.txt; then
+        echo "Run ${run} never took steps above level 0!"
+        fail=1
+    fi
+done
+python3 check.py local || fail=1
+python3 check.py local_tight || fail=1
+python3 conservation.py global local local_tight || fail=1
+
+exit $fail
@@ -0,0 +1,43 @@
+#!/usr/bin/env python3
+
+# Check that local timestepping conserves the totals of the conserved variables as well as
+# stepping globally does, see run.sh
+# Usage: conservation.py global_name local_name [local_name ...]
+# Nothing leaves the domain, so the totals may only drift by roundoff.  The global run measures
+# that drift; each local run may drift by at most a few times as much, or by a few thousand
+# multiples of machine epsilon when the global run happens to drift by less.
+# Any real flux imbalance between levels would show up many orders of magnitude above this
+
+import sys
+import numpy as np
+import h5py
+
+EPS = np.finfo(np.float64).eps
+ROUNDOFF_FACTOR = 10
+ROUNDOFF_MIN = 1.e3 * EPS
+
+VARS = ["cons.rho", "cons.u"]
+
+def totals(name, when):
+    """Totals of each conserved variable.  Zones have equal volume, so sums will do"""
+    with h5py.File("blast_{}_{}.phdf".format(name, when), 'r') as f:
+        return np.array([np.sum(f[var][()], dtype=np.float64) for var in VARS])
+
+def drift(name):
+    start, end = totals(name, "start"), totals(name, "end")
+    return np.fabs(end - start) / np.fabs(start)
+
+ref = drift(sys.argv[1])
+for var, d in zip(VARS, ref):
+    print("{}: total {} drifted by {:.3g}".format(sys.argv[1], var, d))
+tol = np.maximum(ROUNDOFF_FACTOR * ref, ROUNDOFF_MIN)
+
+fail = 0
+for name in sys.argv[2:]:
+    for var, d, t in zip(VARS, drift(name), tol):
+        print("{}: total {} drifted by {:.3g}, allowed {:.3g}".format(name, var, d, t))
+        if d > t:
+            print("Local timestepping doesn't conserve {}!".format(var))
+            fail = 1
+
+exit(fail)
@@ -0,0 +1,45 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Local timestepping regression.
+# 1. A short, small torus with six radial shells of blocks, stepping globally and with local_timestep/on,
+#    keeping the final dumps for check.sh to check divB.  Dumps are written in double precision,
+#    so that divB is seen at machine precision
+# 2. A cylindrical explosion in a Cartesian box, ending long before anything reaches the edges, so that
+#    no flux leaves the domain & the totals of the conserved variables change only by roundoff.
+#    Eight columns of blocks in x1 make the "shells": the cold outer ones step at higher levels,
+#    and drop as the blast reaches them
+
+lts() {
+    $BASE/run.sh -i $BASE/pars/sane.par driver/type=harm parthenon/time/tlim=20 debug/verbose=1 \
+                    parthenon/mesh/nx1=96 parthenon/mesh/nx2=32 parthenon/mesh/nx3=32 \
+                    parthenon/meshblock/nx1=16 parthenon/meshblock/nx2=16 parthenon/meshblock/nx3=16 \
+                    b_field/initial_cleanup=false parthenon/output0/single_precision_output=false \
+                    $2 >log_lts_${1}.txt
+    mv torus.out0.final.phdf lts_${1}.phdf
+}
+
+blast() {
+    $BASE/run.sh -i $BASE/pars/explosion.par driver/type=harm parthenon/time/tlim=2.5 debug/verbose=1 \
+                    parthenon/mesh/nx1=128 parthenon/mesh/nx2=128 \
+                    parthenon/meshblock/nx1=16 parthenon/meshblock/nx2=64 \
+                    parthenon/mesh/ix1_bc=outflow parthenon/mesh/ox1_bc=outflow \
+                    explosion/rho_in=1 explosion/rho_out=1 explosion/u_in=1 explosion/u_out=1.e-3 \
+                    parthenon/output0/dt=100 parthenon/output0/single_precision_output=false \
+                    parthenon/output0/variables=cons.rho,cons.u \
+                    $2 >log_blast_${1}.txt
+    mv explosion.out0.00000.phdf blast_${1}_start.phdf
+    mv explosion.out0.final.phdf blast_${1}_end.phdf
+}
+
+lts global ""
+lts local "local_timestep/on=true"
+# A margin below 1 isn't allowed, but a margin of exactly 1 promotes shells as far as they'll go,
+# so that blocks are most likely to outrun their CFL limits and end cycles early
+lts local_tight "local_timestep/on=true local_timestep/safety=1"
+
+blast global ""
+blast local "local_timestep/on=true"
+blast local_tight "local_timestep/on=true local_timestep/safety=1"
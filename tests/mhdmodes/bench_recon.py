@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+
+# Summarize the cost/accuracy benchmark in bench_recon.sh:
+# for each scheme & resolution, the mean L1 error in the mode variables vs. the run's wall-clock time
+import sys
+import re
+import numpy as np
+import matplotlib.pyplot as plt
+
+import pyharm
+
+RES = [int(x) for x in sys.argv[1].split(",")]
+RECONS = sys.argv[2:]
+
+# Background & 3D slow mode eigenvector, as in check.py.  The slow mode perturbs all 8 variables
+VARS = ['RHO', 'UU', 'U1', 'U2', 'U3', 'B1', 'B2', 'B3']
+var0 = np.array([1., 1., 0., 0., 0., 1., 0., 0.])
+dvar = 1.e-4 * np.array([0.556500332363, 0.742000443151, -0.282334999306, 0.0367010491491,
+                         0.0367010491491, -0.195509141461, 0.0977545707307, 0.0977545707307])
+k1 = k2 = k3 = 2.*np.pi
+
+def mean_l1(fname):
+    """Mean over the variables of the L1 error against the analytic slow mode"""
+    dump = pyharm.load_dump(fname)
+    phase = np.cos(k1*dump['x'] + k2*dump['y'] + k3*dump['z'])
+    return np.mean([np.mean(np.fabs(dump[var] - var0[k] - dvar[k]*phase)) for k, var in enumerate(VARS)])
+
+def walltime(fname):
+    """Wall-clock time as reported at the end of a KHARMA run"""
+    with open(fname) as f:
+        times = re.findall(r"walltime used = ([0-9.eE+-]+)", f.read())
+    return float(times[-1])
+
+fig = plt.figure(figsize=(5,5))
+ax = fig.add_subplot(1,1,1)
+
+print("{:>12} {:>5} {:>12} {:>10} {:>12}".format("recon", "res", "L1", "time (s)", "L1*time"))
+for recon in RECONS:
+    short = "bench_slow_{}".format(recon)
+    L1 = np.array([mean_l1("mhd_3d_{}_end_{}.phdf".format(res, short)) for res in RES])
+    times = np.array([walltime("log_3d_{}_{}.txt".format(res, short)) for res in RES])
+    for res, l1, t in zip(RES, L1, times):
+        print("{:>12} {:>5} {:>12.4e} {:>10.3f} {:>12.4e}".format(recon, res, l1, t, l1*t))
+    ax.plot(times, L1, marker='s', label=recon)
+
+plt.xscale('log'); plt.yscale('log')
+plt.xlabel('Wall-clock time (s)'); plt.ylabel('Mean L1')
+plt.title("MHD slow mode error vs. cost")
+plt.legend(loc=1)
+plt.savefig("bench_recon.png")
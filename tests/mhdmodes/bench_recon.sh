@@ -0,0 +1,34 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Cost/accuracy comparison of the reconstruction schemes:
+# runs the 3D slow mode at a few resolutions with each scheme, then reports
+# the L1 error reached vs. the wall-clock time it took.
+# Not part of the usual test run, as it only produces numbers & a plot.
+# GRMHD/reconstruction=weno5_lower_poles isn't implemented, so it isn't compared
+
+RES="16,24,32,48"
+RECONS="donor_cell linear_mc linear_vl ppm mp5 weno5"
+
+for recon in $RECONS
+do
+    for res in ${RES//,/ }
+    do
+      # Eight blocks, as in run.sh
+      half=$(( $res / 2 ))
+      $BASE/run.sh -i $BASE/pars/mhdmodes.par debug/verbose=1 mhdmodes/nmode=1 \
+                      parthenon/mesh/nx1=$res parthenon/mesh/nx2=$res parthenon/mesh/nx3=$res \
+                      parthenon/meshblock/nx1=$half parthenon/meshblock/nx2=$half parthenon/meshblock/nx3=$half \
+                      GRMHD/reconstruction=$recon >log_3d_${res}_bench_slow_${recon}.txt
+        mv mhdmodes.out0.00000.phdf mhd_3d_${res}_start_bench_slow_${recon}.phdf
+        mv mhdmodes.out0.final.phdf mhd_3d_${res}_end_bench_slow_${recon}.phdf
+    done
+done
+
+. ~/libs/anaconda3/etc/profile.d/conda.sh
+conda activate pyharm
+
+# bench_recon.py measures the L1 norms itself, since MP5/WENO5 aren't expected to pass check.py's 2nd-order fit
+python3 bench_recon.py $RES $RECONS
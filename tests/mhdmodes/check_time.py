@@ -0,0 +1,32 @@
+#!/usr/bin/env python3
+
+# Temporal convergence of an integrator, see conv_time.sh
+# Usage: check_time.py name order cfl1,cfl2,... cfl_ref
+import sys
+import numpy as np
+
+import pyharm
+
+SHORT = sys.argv[1]
+ORDER = int(sys.argv[2])
+CFLS = [float(x) for x in sys.argv[3].split(",")]
+CFL_REF = float(sys.argv[4])
+
+VARS = ['RHO', 'UU', 'U1', 'U2', 'U3', 'B1', 'B2', 'B3']
+
+ref = pyharm.load_dump("mhd_time_{}_{}.phdf".format(SHORT, sys.argv[4]))
+
+L1 = []
+for cfl in sys.argv[3].split(","):
+    dump = pyharm.load_dump("mhd_time_{}_{}.phdf".format(SHORT, cfl))
+    # Sum over the variables, as the mode perturbs most of them
+    L1.append(sum(np.mean(np.fabs(dump[var] - ref[var])) for var in VARS))
+    print(SHORT, cfl, L1[-1])
+
+# The timestep is proportional to the CFL number, apart from the first few steps
+# ramping up from dt_start, which are too short to contribute much error
+powerfit = np.polyfit(np.log(CFLS), np.log(L1), 1)[0]
+print("Power fit {}: {} (expected {})".format(SHORT, powerfit, ORDER))
+np.savetxt("L1_time_{}.txt".format(SHORT), np.c_[CFLS, L1])
+
+exit(int(powerfit < ORDER - 0.3))
@@ -0,0 +1,42 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Temporal convergence of the integrators: runs the 1D fast mode on a fixed grid at
+# several CFL numbers, plus a reference run at a much smaller one, for each integrator.
+# check_time.py measures the L1 difference of each run from the reference, which leaves
+# only the time discretization error, and checks it falls at the integrator's order.
+# Output is in double precision, as the differences are far below single-precision roundoff
+
+RES=256
+
+conv_time() {
+    for cfl in $3 $4
+    do
+        $BASE/run.sh -i $BASE/pars/mhdmodes.par debug/verbose=1 mhdmodes/nmode=3 mhdmodes/dir=3 \
+                        parthenon/mesh/nx1=$RES parthenon/mesh/nx2=1 parthenon/mesh/nx3=1 \
+                        parthenon/meshblock/nx1=$(( $RES / 8 )) parthenon/meshblock/nx2=1 parthenon/meshblock/nx3=1 \
+                        parthenon/output0/single_precision_output=false \
+                        GRMHD/cfl=$cfl $2 >log_time_${1}_${cfl}.txt
+        mv mhdmodes.out0.final.phdf mhd_time_${1}_${cfl}.phdf
+    done
+}
+
+# Reference CFL last.  Parthenon's RK2 & RK3 for comparison
+conv_time rk2 "parthenon/time/integrator=rk2" "0.8 0.4 0.2 0.1" 0.0125
+conv_time rk3 "parthenon/time/integrator=rk3" "0.8 0.4 0.2 0.1" 0.0125
+conv_time ssprk3 "driver/integrator=ssprk3" "0.8 0.4 0.2 0.1" 0.0125
+# SSP coefficient 6, so proportionally larger steps
+conv_time ssprk10_4 "driver/integrator=ssprk10_4" "4.8 2.4 1.2 0.6" 0.15
+
+. ~/libs/anaconda3/etc/profile.d/conda.sh
+conda activate pyharm
+
+fail=0
+python3 check_time.py rk2 2 "0.8,0.4,0.2,0.1" 0.0125 || fail=1
+python3 check_time.py rk3 3 "0.8,0.4,0.2,0.1" 0.0125 || fail=1
+python3 check_time.py ssprk3 3 "0.8,0.4,0.2,0.1" 0.0125 || fail=1
+python3 check_time.py ssprk10_4 4 "4.8,2.4,1.2,0.6" 0.15 || fail=1
+
+exit $fail
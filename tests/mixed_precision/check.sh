@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Check that single-precision fluxes converge like double-precision ones,
+# and that they don't add appreciably to the truncation error.
+# See run.sh
+
+. ~/libs/anaconda3/etc/profile.d/conda.sh
+conda activate pyharm
+
+RES3D="16,24,32,48"
+RES2D="32,48,64,96,128"
+
+fail=0
+for prec in double single
+do
+  python3 ../mhdmodes/check.py $RES3D "slow mode in 3D, $prec precision fluxes" slow_$prec || fail=1
+  python3 ../mhdmodes/check.py $RES3D "Alfven mode in 3D, $prec precision fluxes" alfven_$prec || fail=1
+  python3 ../mhdmodes/check.py $RES3D "fast mode in 3D, $prec precision fluxes" fast_$prec || fail=1
+  python3 ../bondi/check.py $RES2D "in 2D, $prec precision fluxes" bondi_$prec || fail=1
+done
+
+python3 compare.py $RES3D $RES2D slow alfven fast bondi || fail=1
+
+exit $fail
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+
+# Compare the error added by single-precision fluxes against the truncation error of the scheme.
+# Usage: compare.py res3d res2d name [name ...], with names among slow, alfven, fast, bondi
+# For each run & resolution, the truncation error is the L1 difference of the double-precision
+# result from the exact solution (the analytic mode, or the steady initial state for Bondi),
+# and the roundoff is the L1 difference between the single- and double-precision results.
+# Results are printed & saved to mixed_precision_summary.txt
+
+import sys
+import numpy as np
+
+import pyharm
+
+# Largest allowed ratio of roundoff to truncation error, at any resolution
+TOL = 0.1
+
+RES3D = [int(x) for x in sys.argv[1].split(",")]
+RES2D = [int(x) for x in sys.argv[2].split(",")]
+
+# 3D mode eigenvectors, as in mhdmodes/check.py
+VARS = ['RHO', 'UU', 'U1', 'U2', 'U3', 'B1', 'B2', 'B3']
+var0 = np.array([1., 1., 0., 0., 0., 1., 0., 0.])
+MODES = {"slow": [0.556500332363, 0.742000443151, -0.282334999306, 0.0367010491491,
+                  0.0367010491491, -0.195509141461, 0.0977545707307, 0.0977545707307],
+         "alfven": [0., 0., 0., -0.339683110243, 0.339683110243, 0., 0.620173672946, -0.620173672946],
+         "fast": [0.481846076323, 0.642461435098, -0.0832240462505, -0.224080007379,
+                  -0.224080007379, 0.406380545676, -0.203190272838, -0.203190272838]}
+amp = 1.e-4
+k1 = k2 = k3 = 2.*np.pi
+
+def mode_errors(name, res):
+    """Truncation error & roundoff over the variables the mode perturbs"""
+    dvar = amp * np.array(MODES[name])
+    double = pyharm.load_dump("mhd_3d_{}_end_{}_double.phdf".format(res, name))
+    single = pyharm.load_dump("mhd_3d_{}_end_{}_single.phdf".format(res, name))
+    phase = np.cos(k1*double['x'] + k2*double['y'] + k3*double['z'])
+    trunc, roundoff = [], []
+    for k, var in enumerate(VARS):
+        if dvar[k] == 0.: continue
+        trunc.append(np.mean(np.fabs(double[var] - var0[k] - dvar[k]*phase)))
+        roundoff.append(np.mean(np.fabs(single[var] - double[var])))
+    return np.array(trunc), np.array(roundoff)
+
+def bondi_errors(res):
+    """Truncation error & roundoff in density outside the event horizon"""
+    start = pyharm.load_dump("bondi_2d_{}_start_bondi_double.phdf".format(res))
+    double = pyharm.load_dump("bondi_2d_{}_end_bondi_double.phdf".format(res))
+    single = pyharm.load_dump("bondi_2d_{}_end_bondi_single.phdf".format(res))
+    outside = start['r'] > start.params['r_eh']
+    trunc = np.mean(np.fabs(double['RHO'] - start['RHO'])[outside])
+    roundoff = np.mean(np.fabs(single['RHO'] - double['RHO'])[outside])
+    return np.array([trunc]), np.array([roundoff])
+
+fail = 0
+with open("mixed_precision_summary.txt", "w") as summary:
+    for name in sys.argv[3:]:
+        for res in (RES2D if name == "bondi" else RES3D):
+            trunc, roundoff = bondi_errors(res) if name == "bondi" else mode_errors(name, res)
+            ratio = np.max(roundoff / trunc)
+            line = "{} at {}: truncation L1 {:.3g}, single-double L1 {:.3g}, max ratio {:.3g}".format(
+                        name, res, np.max(trunc), np.max(roundoff), ratio)
+            print(line)
+            summary.write(line + "\n")
+            if ratio > TOL:
+                print("Single-precision fluxes add more than {} of the truncation error!".format(TOL))
+                fail = 1
+
+exit(fail)
@@ -0,0 +1,49 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Compare convergence of a single-precision flux calculation against the usual double-precision one.
+# Reconstruction & face fluxes are only computed in single precision when KHARMA is compiled
+# with FLUX_SINGLE_PRECISION, so this needs two builds:
+# ./make.sh clean && (cd tests/mixed_precision && ./run.sh double)
+# ./make.sh clean single_flux && (cd tests/mixed_precision && ./run.sh single)
+# Then check.sh compares the errors from each
+PREC=$1
+
+if [[ "$PREC" == "single" ]] && ! grep -q single_flux $BASE/make_args; then
+  echo "KHARMA doesn't seem to be compiled with single_flux, run './make.sh clean single_flux' first"
+  exit 1
+fi
+
+modes_3d() {
+    for res in 16 24 32 48
+    do
+      # Eight blocks
+      half=$(( $res / 2 ))
+      $BASE/run.sh -i $BASE/pars/mhdmodes.par debug/verbose=1 \
+                      parthenon/mesh/nx1=$res parthenon/mesh/nx2=$res parthenon/mesh/nx3=$res \
+                      parthenon/meshblock/nx1=$half parthenon/meshblock/nx2=$half parthenon/meshblock/nx3=$half \
+                      $2 >log_${1}_${PREC}_${res}.txt
+        mv mhdmodes.out0.00000.phdf mhd_3d_${res}_start_${1}_${PREC}.phdf
+        mv mhdmodes.out0.final.phdf mhd_3d_${res}_end_${1}_${PREC}.phdf
+    done
+}
+bondi_2d() {
+    for res in 32 48 64 96 128
+    do
+      # Four blocks
+      half=$(( $res / 2 ))
+      $BASE/run.sh -i $BASE/pars/bondi.par parthenon/output0/dt=1000 debug/verbose=1 \
+                                           parthenon/mesh/nx1=$res parthenon/mesh/nx2=$res parthenon/mesh/nx3=1 \
+                                           parthenon/meshblock/nx1=$half parthenon/meshblock/nx2=$half parthenon/meshblock/nx3=1 \
+                                           $2 >log_${1}_${PREC}_${res}.txt 2>&1
+        mv bondi.out0.00000.phdf bondi_2d_${res}_start_${1}_${PREC}.phdf
+        mv bondi.out0.final.phdf bondi_2d_${res}_end_${1}_${PREC}.phdf
+    done
+}
+
+modes_3d slow mhdmodes/nmode=1
+modes_3d alfven mhdmodes/nmode=2
+modes_3d fast mhdmodes/nmode=3
+bondi_2d bondi ""
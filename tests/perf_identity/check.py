@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+
+# Compare the final dumps of two runs bit-for-bit, see run.sh
+# Usage: check.py reference_name test_name [min_flagged]
+# If min_flagged is given, also require that at least that many zones failed inversion in the reference
+
+import sys
+import numpy as np
+
+import pyharm
+
+VARS = ['RHO', 'UU', 'U1', 'U2', 'U3', 'B1', 'B2', 'B3', 'pflag', 'fflag']
+
+ref = pyharm.load_dump("identity_{}.phdf".format(sys.argv[1]))
+test = pyharm.load_dump("identity_{}.phdf".format(sys.argv[2]))
+
+fail = 0
+nflagged = np.count_nonzero(np.asarray(ref['pflag']) > 0)
+print("{}: {} zones flagged by UtoP in the final step".format(sys.argv[1], nflagged))
+if len(sys.argv) > 3 and nflagged < int(sys.argv[3]):
+    print("Too few failed inversions to exercise the fixups!")
+    fail = 1
+
+for var in VARS:
+    a, b = np.asarray(ref[var]), np.asarray(test[var])
+    # Zero tolerance: the options are required to give identical results, not just close ones
+    ndiff = np.count_nonzero(a != b)
+    if ndiff > 0:
+        print("{} vs {}: {} differs in {} zones, max difference {:.3g}".format(sys.argv[2], sys.argv[1], var,
+                                                                             ndiff, np.max(np.fabs(a - b))))
+        fail = 1
+    else:
+        print("{} vs {}: {} identical".format(sys.argv[2], sys.argv[1], var))
+
+exit(fail)
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Check that each performance option's run matches the default exactly, see run.sh
+
+. ~/libs/anaconda3/etc/profile.d/conda.sh
+conda activate pyharm
+
+fail=0
+python3 check.py base batch_utop || fail=1
+# These must also have inversions to fix, or they test nothing.  With 8 blocks, 16 failures
+# should overflow the one-zone lists of at least one block
+python3 check.py tiny_floors sparse_fixup 1 || fail=1
+python3 check.py tiny_floors sparse_fixup_overflow 16 || fail=1
+python3 check.py tiny_floors_mesh sparse_fixup_mesh 1 || fail=1
+python3 check.py tiny_floors_mesh sparse_fixup_mesh_overflow 16 || fail=1
+
+exit $fail
@@ -0,0 +1,32 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Performance options which must not change results.  Runs a short, small torus with the default
+# code path and with each option, keeping the final dumps for check.sh to compare bit-for-bit.
+# Dumps are written in double precision so that differences in the last bits show up
+
+identity() {
+    $BASE/run.sh -i $BASE/pars/sane.par driver/type=harm parthenon/time/nlim=10 \
+                    parthenon/mesh/nx1=64 parthenon/mesh/nx2=32 parthenon/mesh/nx3=32 \
+                    parthenon/meshblock/nx1=32 parthenon/meshblock/nx2=16 parthenon/meshblock/nx3=16 \
+                    b_field/initial_cleanup=false parthenon/output0/single_precision_output=false \
+                    $2 >log_identity_${1}.txt
+    mv torus.out0.final.phdf identity_${1}.phdf
+}
+
+identity base ""
+# Masked batch inversion, see GRMHD::u_to_p_batch
+identity batch_utop "perf/batch_utop=true"
+
+# FixUtoP over lists of the flagged zones, vs. sweeping every zone, per-block and per-MeshData.
+# Floors are made tiny so that plenty of inversions fail.  The "overflow" runs leave room in the lists
+# for just one zone per block, so that nearly every block falls back to a sweep
+TINY_FLOORS="floors/rho_min_geom=1e-12 floors/u_min_geom=1e-14 floors/bsq_over_rho_max=1e6 floors/u_over_rho_max=1e6"
+identity tiny_floors "$TINY_FLOORS"
+identity sparse_fixup "$TINY_FLOORS perf/sparse_fixup=true"
+identity sparse_fixup_overflow "$TINY_FLOORS perf/sparse_fixup=true perf/sparse_fixup_divisor=1000000"
+identity tiny_floors_mesh "$TINY_FLOORS perf/mesh_utop=true"
+identity sparse_fixup_mesh "$TINY_FLOORS perf/mesh_utop=true perf/sparse_fixup=true"
+identity sparse_fixup_mesh_overflow "$TINY_FLOORS perf/mesh_utop=true perf/sparse_fixup=true perf/sparse_fixup_divisor=1000000"
@@ -0,0 +1,15 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Benchmark of the primitive recovery algorithms (GRMHD/inverter).
+# Inverts a block of sampled magnetized states with each algorithm, and records the
+# failure rate, mean iterations, error and ns/zone of each in inversion_summary.txt.
+# The last line, onedw_batch, is the default inverter batched as with perf/batch_utop (UTOP_BATCH zones
+# at a time), for comparison with the scalar onedw line.  It doesn't count iterations, so reports 0.
+# Fewer failures means fewer zones for FixUtoP, and fewer floors.
+# Run again with e.g. the sigma or Lorentz factor range changed to probe harder states.
+
+$BASE/run.sh -i $BASE/pars/inversion_bench.par "$@" >log_inversion.txt
+grep -A5 "Inversion benchmark" log_inversion.txt | tee inversion_summary.txt
@@ -0,0 +1,13 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Microbenchmark of the reconstruction schemes.
+# Runs recon_bench.par, which times reconstruction alone, and the full GetFlux kernels,
+# with each scheme over the same fixed state, without stepping anything.
+# Records ns/zone (all variables, all three directions) of each in recon_summary.txt.
+# Change the block size with e.g. parthenon/meshblock/nx1=32, to see the effect of cache size.
+
+$BASE/run.sh -i $BASE/pars/recon_bench.par "$@" >log_recon.txt
+grep -A6 "Reconstruction benchmark" log_recon.txt | tee recon_summary.txt
@@ -0,0 +1,141 @@
+#!/bin/bash
+set -euo pipefail
+
+BASE=../..
+
+# Performance comparison of different code paths on the scaling torus.
+# Runs a fixed problem for a fixed number of steps with each option,
+# and reports Parthenon's final zone-cycles/wallsecond figure and the peak memory for each.
+# Unlike the other tests this doesn't check correctness, just records numbers:
+# each run is compared against the "base" run from the same machine.
+#
+# To compare two builds, e.g. the baseline commit and a new one, keep the first build's
+# perf_results.txt and pass it to the second:
+#     BASELINE=/path/to/old/perf_results.txt ./run.sh
+# Runs more than TOLERANCE (default 0.05, i.e. 5%) slower than the same-named baseline run,
+# or using more than MEM_TOLERANCE (default 0.05) more peak memory (maximum resident set size,
+# as reported by GNU time), are marked REGRESSION in perf_summary.txt, and the script exits
+# with an error after all runs.
+
+# Problem size, override with e.g. NX=256 ./run.sh
+NX=${NX:-128}
+NB=${NB:-64}
+BASELINE=${BASELINE:-}
+TOLERANCE=${TOLERANCE:-0.05}
+MEM_TOLERANCE=${MEM_TOLERANCE:-0.05}
+
+# Record "name zone-cycles/wallsecond peak-RSS-kB" from a run's logs to perf_results.txt
+record() {
+    echo "$1 $(grep "zone-cycles/wallsecond" log_perf_${1}.txt | tail -1 | awk '{print $NF}')" \
+         "$(grep "Maximum resident set size" time_perf_${1}.txt | tail -1 | awk '{print $NF}')" >>perf_results.txt
+}
+
+bench() {
+    /usr/bin/time -v -o time_perf_${1}.txt $BASE/run.sh -i $BASE/pars/scaling_torus.par parthenon/time/nlim=102 \
+                    parthenon/mesh/nx1=$NX parthenon/mesh/nx2=$NX parthenon/mesh/nx3=$NX \
+                    parthenon/meshblock/nx1=$NB parthenon/meshblock/nx2=$NB parthenon/meshblock/nx3=$NB \
+                    $2 >log_perf_${1}.txt
+    record $1
+    echo "$1: $(grep "zone-cycles/wallsecond" log_perf_${1}.txt | tail -1)," \
+         "$(grep "Maximum resident set size" time_perf_${1}.txt | tail -1 | xargs)"
+}
+
+# Summarize each run's speed & memory against the base run,
+# and against the baseline build's run of the same name if given
+compare() {
+    local regressions=0
+    local base_zcps=$(awk '$1 == "base" {print $2}' perf_results.txt)
+    local base_rss=$(awk '$1 == "base" {print $3}' perf_results.txt)
+    while read name zcps rss; do
+        local line="$name: $zcps zone-cycles/wallsecond, $(awk -v a=$zcps -v b=$base_zcps 'BEGIN {printf "%.3f", a/b}')x base;"
+        line="$line $rss kB peak RSS, $(awk -v a=$rss -v b=$base_rss 'BEGIN {printf "%.3f", a/b}')x base"
+        local old_zcps="" old_rss=""
+        if [[ -n "$BASELINE" ]]; then
+            old_zcps=$(awk -v n=$name '$1 == n {print $2}' $BASELINE)
+            old_rss=$(awk -v n=$name '$1 == n {print $3}' $BASELINE)
+        fi
+        if [[ -n "$old_zcps" ]]; then
+            local ratio=$(awk -v a=$zcps -v b=$old_zcps 'BEGIN {printf "%.3f", a/b}')
+            line="$line; ${ratio}x baseline speed"
+            if awk -v r=$ratio -v t=$TOLERANCE 'BEGIN {exit !(r < 1 - t)}'; then
+                line="$line REGRESSION"
+                regressions=$((regressions + 1))
+            fi
+        fi
+        if [[ -n "$old_rss" ]]; then
+            local ratio=$(awk -v a=$rss -v b=$old_rss 'BEGIN {printf "%.3f", a/b}')
+            line="$line, ${ratio}x baseline memory"
+            if awk -v r=$ratio -v t=$MEM_TOLERANCE 'BEGIN {exit !(r > 1 + t)}'; then
+                line="$line REGRESSION"
+                regressions=$((regressions + 1))
+            fi
+        fi
+        echo "$line" | tee -a perf_summary.txt
+    done <perf_results.txt
+    if [[ $regressions -gt 0 ]]; then
+        echo "$regressions regressions against the baseline $BASELINE" | tee -a perf_summary.txt
+        return 1
+    fi
+}
+
+rm -f perf_summary.txt perf_results.txt
+
+bench base ""
+# Flux divergence, sources & RK update in one kernel, without dU/dt
+bench fused_update "perf/fused_update=true"
+# Timestep from per-block signal speed maxima reduced in the flux kernels, without the ctop field
+bench reduce_ctop "perf/reduce_ctop=true"
+# Second boundary sync, synchronous vs. overlapped with the next stage's interior fluxes.
+# Most useful with many MPI ranks, e.g. with MPI_NUM_PROCS set in a machine file
+bench two_sync "perf/two_sync=true"
+bench overlap_comms "perf/two_sync=true perf/overlap_comms=true"
+# One sync per step: intermediate stages are also stepped through a deeper layer of ghost zones.
+# Compare against base and two_sync above; this exchanges more data, less often
+bench deep_halo "perf/deep_halo=true"
+# UtoP, floors & fixups over whole MeshData partitions rather than each block.
+# Most useful with many small blocks, e.g. NB=16
+bench mesh_utop "perf/mesh_utop=true"
+# FixUtoP over a list of the zones UtoP flagged, rather than sweeping every zone
+bench sparse_fixup "perf/sparse_fixup=true"
+bench sparse_fixup_mesh "perf/sparse_fixup=true perf/mesh_utop=true"
+# UtoP, floors & ceilings in one kernel, rather than three passes
+bench fused_utop_floors "perf/fused_utop_floors=true"
+# UtoP inversion in masked groups of zones, which CPU compilers can vectorize
+bench batch_utop "perf/batch_utop=true"
+# UtoP starting from each zone's last W'.  Both runs record a histogram of UtoP iterations
+# in the history file (columns UtoP_niter_N), to compare the iterations saved
+HST="parthenon/output1/file_type=hst parthenon/output1/dt=1.0"
+bench utop_histogram "perf/utop_histogram=true $HST"
+mv torus.hst perf_utop_histogram.hst
+bench cache_wp "perf/cache_wp=true perf/utop_histogram=true $HST"
+mv torus.hst perf_cache_wp.hst
+# Primitives' ghost zones synced only at the end of each step, as they just seed UtoP in between
+bench sync_prims_last "GRMHD/sync_prims=last"
+# Ghost exchange of the conserved variables only, with the primitives' ghosts recomputed after each sync.
+# Reports the MB exchanged per step, compare against the base run's with perf/report_sync_bytes
+bench sync_cons "GRMHD/sync_prims=none perf/report_sync_bytes=true"
+# Local timestepping: outer shells of blocks take 2^level times longer steps.
+# The speedup depends on the problem, so use enough blocks in x1 to see it, e.g. NB=16
+bench local_timestep "local_timestep/on=true"
+# Integrators: low-storage SSP schemes keep one stage container rather than one per stage.
+# These run to the same simulated time rather than step count, with "cfl" scaled by each scheme's
+# SSP coefficient (1 for rk2 & ssprk3, 6 for ssprk10_4), and also report the wall time
+TLIM=${TLIM:-1.0}
+bench_integrator() {
+    /usr/bin/time -v -o time_perf_${1}.txt $BASE/run.sh -i $BASE/pars/scaling_torus.par parthenon/time/nlim=-1 parthenon/time/tlim=$TLIM \
+                    parthenon/mesh/nx1=$NX parthenon/mesh/nx2=$NX parthenon/mesh/nx3=$NX \
+                    parthenon/meshblock/nx1=$NB parthenon/meshblock/nx2=$NB parthenon/meshblock/nx3=$NB \
+                    $2 >log_perf_${1}.txt
+    record $1
+    echo "$1: $(grep "walltime used" log_perf_${1}.txt | tail -1), $(grep "zone-cycles/wallsecond" log_perf_${1}.txt | tail -1)," \
+         "$(grep "Maximum resident set size" time_perf_${1}.txt | tail -1 | xargs)"
+}
+bench_integrator rk2 ""
+bench_integrator rk3 "parthenon/time/integrator=rk3"
+bench_integrator ssprk3 "driver/integrator=ssprk3"
+bench_integrator ssprk10_4 "driver/integrator=ssprk10_4 GRMHD/cfl=5.4"
+# Cost of timing each task, and the breakdown itself (see kharma/task_timing.hpp)
+bench task_timing "perf/task_timing=true perf/task_timing_interval=50"
+mv task_timing.json perf_task_timing.json
+
+compare